@@ -41,16 +41,6 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 LT_2972FaultLog::LT_2972FaultLog(LT_PMBus *pmbus):LT_CommandPlusFaultLog(pmbus)
 {
   faultLog2972 = NULL;
-
-  buffer = NULL;
-  voutPeaks = NULL;
-  ioutPeaks = NULL;
-  tempPeaks = NULL;
-  chanStatuses = NULL;
-  voutDatas = NULL;
-  ioutDatas = NULL;
-  poutDatas = NULL;
-  tempDatas = NULL;
 }
 
 
@@ -66,16 +56,30 @@ bool LT_2972FaultLog::FaultLogLtc2972::isValidData(void *pos, uint8_t size)
  */
 void
 LT_2972FaultLog::read(uint8_t address)
+{
+  startRead(address);
+  // Monitor BUSY bit
+  while (!isReadReady(address));
+  finishRead(address);
+}
+
+void
+LT_2972FaultLog::startRead(uint8_t address)
 {
   // Copy to RAM
   pmbus_->smbus()->sendByte(address, MFR_FAULT_LOG_RESTORE);
-  // Monitor BUSY bit
-  while ((pmbus_->smbus()->readByte(address, MFR_COMMON) & (1 << 6)) == 0);
+}
+
+bool
+LT_2972FaultLog::isReadReady(uint8_t address)
+{
+  return (pmbus_->smbus()->readByte(address, MFR_COMMON) & (1 << 6)) != 0;
+}
 
-  uint16_t size = sizeof(struct LT_2972FaultLog::FaultLogLtc2972);  
-  uint8_t *data = (uint8_t *) malloc(size);
-  if (data == 0)
-    printf(F("bad malloc."));
+void
+LT_2972FaultLog::finishRead(uint8_t address)
+{
+  uint8_t *data = logData;
 #ifdef RAW_EEPROM
   getNvmBlock(address, 0, 128, 0xC8, data);
 #else
@@ -102,7 +106,6 @@ LT_2972FaultLog::read(uint8_t address)
 
 void LT_2972FaultLog::release()
 {
-  free(faultLog2972);
   faultLog2972 = 0;
 }
 
@@ -116,6 +119,20 @@ uint16_t LT_2972FaultLog::getBinarySize()
   return 255;
 }
 
+uint64_t LT_2972FaultLog::getFaultTime200us()
+{
+  if (faultLog2972 == NULL)
+    return 0;
+  return getSharedTime200us(faultLog2972->preamble.shared_time);
+}
+
+uint8_t LT_2972FaultLog::getLoopCount()
+{
+  if (faultLog2972 == NULL)
+    return 0;
+  return faultLog2972->isValidData(&faultLog2972->loops[4]) ? 5 : 4;
+}
+
 void LT_2972FaultLog::dumpBinary()
 {
   dumpBin((uint8_t *)faultLog2972, 255);
@@ -123,8 +140,6 @@ void LT_2972FaultLog::dumpBinary()
 
 void LT_2972FaultLog::print()
 {
-  buffer = new char[FILE_TEXT_LINE_MAX];
-
   printTitle();
 
   printTime();
@@ -132,9 +147,6 @@ void LT_2972FaultLog::print()
   printPeaks();
 
   printAllLoops();
-
-
-  delete [] buffer;
 }
 
 
@@ -154,11 +166,6 @@ void LT_2972FaultLog::printTime()
 
 void LT_2972FaultLog::printPeaks()
 {
-  voutPeaks = new Peak16Words*[4];
-  ioutPeaks = new Peak5_11Words*[4];
-  tempPeaks = new Peak5_11Words*[4];
-  chanStatuses = new ChanStatus*[4];
-
   voutPeaks[0] = &faultLog2972->preamble.peaks.vout0_peaks;
   voutPeaks[1] = &faultLog2972->preamble.peaks.vout1_peaks;
 
@@ -203,11 +210,6 @@ void LT_2972FaultLog::printPeaks()
   printf("\n");
 
   printFastChannel(1);
-
-  delete [] voutPeaks;
-  delete [] ioutPeaks;
-  delete [] tempPeaks;
-  delete [] chanStatuses;
 }
 
 void LT_2972FaultLog::printFastChannel(uint8_t index)
@@ -254,11 +256,6 @@ void LT_2972FaultLog::printFastChannel(uint8_t index)
 
 void LT_2972FaultLog::printAllLoops()
 {
-  voutDatas = new VoutData*[4];
-  ioutDatas = new IoutData*[4];
-  poutDatas = new PoutData*[4];
-  tempDatas = new TempData*[4];
-
   printf(F("Fault Log Loops Follow:\n"));
   printf(F("(most recent data first)\n"));
 
@@ -266,11 +263,6 @@ void LT_2972FaultLog::printAllLoops()
   {
     printLoop(index);
   }
-
-  delete [] voutDatas;
-  delete [] ioutDatas;
-  delete [] poutDatas;
-  delete [] tempDatas;
 }
 
 void LT_2972FaultLog::printLoop(uint8_t index)
@@ -41,16 +41,6 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 LT_2974FaultLog::LT_2974FaultLog(LT_PMBus *pmbus):LT_CommandPlusFaultLog(pmbus)
 {
   faultLog2974 = NULL;
-
-  buffer = NULL;
-  voutPeaks = NULL;
-  ioutPeaks = NULL;
-  tempPeaks = NULL;
-  chanStatuses = NULL;
-  voutDatas = NULL;
-  ioutDatas = NULL;
-  poutDatas = NULL;
-  tempDatas = NULL;
 }
 
 
@@ -66,16 +56,30 @@ bool LT_2974FaultLog::FaultLogLtc2974::isValidData(void *pos, uint8_t size)
  */
 void
 LT_2974FaultLog::read(uint8_t address)
-{  
+{
+  startRead(address);
+  // Monitor BUSY bit
+  while (!isReadReady(address));
+  finishRead(address);
+}
+
+void
+LT_2974FaultLog::startRead(uint8_t address)
+{
   // Copy to RAM
   pmbus_->smbus()->sendByte(address, MFR_FAULT_LOG_RESTORE);
-  // Monitor BUSY bit
-  while ((pmbus_->smbus()->readByte(address, MFR_COMMON) & (1 << 6)) == 0);
+}
 
-  uint16_t size = sizeof(struct LT_2974FaultLog::FaultLogLtc2974);
-  uint8_t *data = (uint8_t *) malloc(size);
-  if (data == 0)
-    printf(F("bad malloc."));
+bool
+LT_2974FaultLog::isReadReady(uint8_t address)
+{
+  return (pmbus_->smbus()->readByte(address, MFR_COMMON) & (1 << 6)) != 0;
+}
+
+void
+LT_2974FaultLog::finishRead(uint8_t address)
+{
+  uint8_t *data = logData;
 #ifdef RAW_EEPROM
   getNvmBlock(address, 0, 128, 0xC8, data);
 #else
@@ -98,7 +102,6 @@ LT_2974FaultLog::read(uint8_t address)
 
 void LT_2974FaultLog::release()
 {
-  free(faultLog2974);
   faultLog2974 = 0;
 }
 
@@ -112,6 +115,20 @@ uint16_t LT_2974FaultLog::getBinarySize()
   return 255;
 }
 
+uint64_t LT_2974FaultLog::getFaultTime200us()
+{
+  if (faultLog2974 == NULL)
+    return 0;
+  return getSharedTime200us(faultLog2974->preamble.shared_time);
+}
+
+uint8_t LT_2974FaultLog::getLoopCount()
+{
+  if (faultLog2974 == NULL)
+    return 0;
+  return faultLog2974->isValidData(&faultLog2974->loops[4]) ? 5 : 4;
+}
+
 void LT_2974FaultLog::dumpBinary()
 {
   dumpBin((uint8_t *)faultLog2974, 255);
@@ -119,8 +136,6 @@ void LT_2974FaultLog::dumpBinary()
 
 void LT_2974FaultLog::print()
 {
-  buffer = new char[FILE_TEXT_LINE_MAX];
-
   printTitle();
 
   printTime();
@@ -128,9 +143,6 @@ void LT_2974FaultLog::print()
   printPeaks();
 
   printAllLoops();
-
-
-  delete [] buffer;
 }
 
 
@@ -150,11 +162,6 @@ void LT_2974FaultLog::printTime()
 
 void LT_2974FaultLog::printPeaks()
 {
-  voutPeaks = new Peak16Words*[4];
-  ioutPeaks = new Peak5_11Words*[4];
-  tempPeaks = new Peak5_11Words*[4];
-  chanStatuses = new ChanStatus*[4];
-
   voutPeaks[0] = &faultLog2974->preamble.peaks.vout0_peaks;
   voutPeaks[1] = &faultLog2974->preamble.peaks.vout1_peaks;
   voutPeaks[2] = &faultLog2974->preamble.peaks.vout2_peaks;
@@ -193,11 +200,6 @@ void LT_2974FaultLog::printPeaks()
   printFastChannel(1);
   printFastChannel(2);
   printFastChannel(3);
-
-  delete [] voutPeaks;
-  delete [] ioutPeaks;
-  delete [] tempPeaks;
-  delete [] chanStatuses;
 }
 
 void LT_2974FaultLog::printFastChannel(uint8_t index)
@@ -244,11 +246,6 @@ void LT_2974FaultLog::printFastChannel(uint8_t index)
 
 void LT_2974FaultLog::printAllLoops()
 {
-  voutDatas = new VoutData*[4];
-  ioutDatas = new IoutData*[4];
-  poutDatas = new PoutData*[4];
-  tempDatas = new TempData*[4];
-
   printf(F("Fault Log Loops Follow:\n"));
   printf(F("(most recent data first)\n"));
 
@@ -256,11 +253,6 @@ void LT_2974FaultLog::printAllLoops()
   {
     printLoop(index);
   }
-
-  delete [] voutDatas;
-  delete [] ioutDatas;
-  delete [] poutDatas;
-  delete [] tempDatas;
 }
 
 void LT_2974FaultLog::printLoop(uint8_t index)
@@ -41,16 +41,6 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 LT_2975FaultLog::LT_2975FaultLog(LT_PMBus *pmbus):LT_CommandPlusFaultLog(pmbus)
 {
   faultLog2975 = NULL;
-
-  buffer = NULL;
-  voutPeaks = NULL;
-  ioutPeaks = NULL;
-  tempPeaks = NULL;
-  chanStatuses = NULL;
-  voutDatas = NULL;
-  ioutDatas = NULL;
-  poutDatas = NULL;
-  tempDatas = NULL;
 }
 
 
@@ -66,16 +56,30 @@ bool LT_2975FaultLog::FaultLogLtc2975::isValidData(void *pos, uint8_t size)
  */
 void
 LT_2975FaultLog::read(uint8_t address)
+{
+  startRead(address);
+  // Monitor BUSY bit
+  while (!isReadReady(address));
+  finishRead(address);
+}
+
+void
+LT_2975FaultLog::startRead(uint8_t address)
 {
   // Copy to RAM
   pmbus_->smbus()->sendByte(address, MFR_FAULT_LOG_RESTORE);
-  // Monitor BUSY bit
-  while ((pmbus_->smbus()->readByte(address, MFR_COMMON) & (1 << 6)) == 0);
+}
+
+bool
+LT_2975FaultLog::isReadReady(uint8_t address)
+{
+  return (pmbus_->smbus()->readByte(address, MFR_COMMON) & (1 << 6)) != 0;
+}
 
-  uint16_t size = sizeof(struct LT_2975FaultLog::FaultLogLtc2975);  
-  uint8_t *data = (uint8_t *) malloc(size);
-  if (data == 0)
-    printf(F("bad malloc."));
+void
+LT_2975FaultLog::finishRead(uint8_t address)
+{
+  uint8_t *data = logData;
 #ifdef RAW_EEPROM
   getNvmBlock(address, 0, 128, 0xC8, data);
 #else
@@ -100,7 +104,6 @@ LT_2975FaultLog::read(uint8_t address)
 
 void LT_2975FaultLog::release()
 {
-  free(faultLog2975);
   faultLog2975 = 0;
 }
 
@@ -114,6 +117,20 @@ uint16_t LT_2975FaultLog::getBinarySize()
   return 255;
 }
 
+uint64_t LT_2975FaultLog::getFaultTime200us()
+{
+  if (faultLog2975 == NULL)
+    return 0;
+  return getSharedTime200us(faultLog2975->preamble.shared_time);
+}
+
+uint8_t LT_2975FaultLog::getLoopCount()
+{
+  if (faultLog2975 == NULL)
+    return 0;
+  return faultLog2975->isValidData(&faultLog2975->loops[4]) ? 5 : 4;
+}
+
 void LT_2975FaultLog::dumpBinary()
 {
   dumpBin((uint8_t *)faultLog2975, 255);
@@ -121,8 +138,6 @@ void LT_2975FaultLog::dumpBinary()
 
 void LT_2975FaultLog::print()
 {
-  buffer = new char[FILE_TEXT_LINE_MAX];
-
   printTitle();
 
   printTime();
@@ -130,9 +145,6 @@ void LT_2975FaultLog::print()
   printPeaks();
 
   printAllLoops();
-
-
-  delete [] buffer;
 }
 
 
@@ -152,11 +164,6 @@ void LT_2975FaultLog::printTime()
 
 void LT_2975FaultLog::printPeaks()
 {
-  voutPeaks = new Peak16Words*[4];
-  ioutPeaks = new Peak5_11Words*[4];
-  tempPeaks = new Peak5_11Words*[4];
-  chanStatuses = new ChanStatus*[4];
-
   voutPeaks[0] = &faultLog2975->preamble.peaks.vout0_peaks;
   voutPeaks[1] = &faultLog2975->preamble.peaks.vout1_peaks;
   voutPeaks[2] = &faultLog2975->preamble.peaks.vout2_peaks;
@@ -212,11 +219,6 @@ void LT_2975FaultLog::printPeaks()
   printFastChannel(1);
   printFastChannel(2);
   printFastChannel(3);
-
-  delete [] voutPeaks;
-  delete [] ioutPeaks;
-  delete [] tempPeaks;
-  delete [] chanStatuses;
 }
 
 void LT_2975FaultLog::printFastChannel(uint8_t index)
@@ -263,11 +265,6 @@ void LT_2975FaultLog::printFastChannel(uint8_t index)
 
 void LT_2975FaultLog::printAllLoops()
 {
-  voutDatas = new VoutData*[4];
-  ioutDatas = new IoutData*[4];
-  poutDatas = new PoutData*[4];
-  tempDatas = new TempData*[4];
-
   printf(F("Fault Log Loops Follow:\n"));
   printf(F("(most recent data first)\n"));
 
@@ -275,11 +272,6 @@ void LT_2975FaultLog::printAllLoops()
   {
     printLoop(index);
   }
-
-  delete [] voutDatas;
-  delete [] ioutDatas;
-  delete [] poutDatas;
-  delete [] tempDatas;
 }
 
 void LT_2975FaultLog::printLoop(uint8_t index)
@@ -42,11 +42,6 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 LT_2977FaultLog::LT_2977FaultLog(LT_PMBus *pmbus):LT_CommandPlusFaultLog(pmbus)
 {
   faultLog2977 = NULL;
-
-  buffer = NULL;
-  voutPeaks = NULL;
-  chanStatuses = NULL;
-  voutDatas = NULL;
 }
 
 
@@ -62,16 +57,30 @@ bool LT_2977FaultLog::FaultLogLtc2977::isValidData(void *pos, uint8_t size)
  */
 void
 LT_2977FaultLog::read(uint8_t address)
+{
+  startRead(address);
+  // Monitor BUSY bit
+  while (!isReadReady(address));
+  finishRead(address);
+}
+
+void
+LT_2977FaultLog::startRead(uint8_t address)
 {
   // Copy to RAM
   pmbus_->smbus()->sendByte(address, MFR_FAULT_LOG_RESTORE);
-  // Monitor BUSY bit
-  while ((pmbus_->smbus()->readByte(address, MFR_COMMON) & (1 << 6)) == 0);
+}
+
+bool
+LT_2977FaultLog::isReadReady(uint8_t address)
+{
+  return (pmbus_->smbus()->readByte(address, MFR_COMMON) & (1 << 6)) != 0;
+}
 
-  uint16_t size = sizeof(struct LT_2977FaultLog::FaultLogLtc2977);
-  uint8_t *data = (uint8_t *) malloc(size);
-  if (data == 0)
-    printf(F("bad malloc."));
+void
+LT_2977FaultLog::finishRead(uint8_t address)
+{
+  uint8_t *data = logData;
 #ifdef RAW_EEPROM
   getNvmBlock(address, 0, 128, 0xC0, data);
 #else
@@ -99,7 +108,6 @@ LT_2977FaultLog::read(uint8_t address)
 
 void LT_2977FaultLog::release()
 {
-  free(faultLog2977);
   faultLog2977 = 0;
 }
 
@@ -113,6 +121,20 @@ uint16_t LT_2977FaultLog::getBinarySize()
   return 255;
 }
 
+uint64_t LT_2977FaultLog::getFaultTime200us()
+{
+  if (faultLog2977 == NULL)
+    return 0;
+  return getSharedTime200us(faultLog2977->preamble.shared_time);
+}
+
+uint8_t LT_2977FaultLog::getLoopCount()
+{
+  if (faultLog2977 == NULL)
+    return 0;
+  return faultLog2977->isValidData(&faultLog2977->loops[4]) ? 5 : 4;
+}
+
 void LT_2977FaultLog::dumpBinary()
 {
   dumpBin((uint8_t *)faultLog2977, 255);
@@ -120,8 +142,6 @@ void LT_2977FaultLog::dumpBinary()
 
 void LT_2977FaultLog::print()
 {
-  buffer = new char[FILE_TEXT_LINE_MAX];
-
   printTitle();
 
   printTime();
@@ -129,9 +149,6 @@ void LT_2977FaultLog::print()
   printPeaks();
 
   printAllLoops();
-
-
-  delete [] buffer;
 }
 
 
@@ -151,9 +168,6 @@ void LT_2977FaultLog::printTime()
 
 void LT_2977FaultLog::printPeaks()
 {
-  voutPeaks = new Peak16Words*[8];
-  chanStatuses = new ChanStatus*[8];
-
   voutPeaks[0] = &faultLog2977->preamble.peaks.vout0_peaks;
   voutPeaks[1] = &faultLog2977->preamble.peaks.vout1_peaks;
   voutPeaks[2] = &faultLog2977->preamble.peaks.vout2_peaks;
@@ -203,9 +217,6 @@ void LT_2977FaultLog::printPeaks()
   printFastChannel(5);
   printFastChannel(6);
   printFastChannel(7);
-
-  delete [] voutPeaks;
-  delete [] chanStatuses;
 }
 
 void LT_2977FaultLog::printFastChannel(uint8_t index)
@@ -235,8 +246,6 @@ void LT_2977FaultLog::printFastChannel(uint8_t index)
 
 void LT_2977FaultLog::printAllLoops()
 {
-  voutDatas = new VoutData*[8];
-
   printf(F("Fault Log Loops Follow:\n"));
   printf(F("(most recent data first)\n"));
 
@@ -244,8 +253,6 @@ void LT_2977FaultLog::printAllLoops()
   {
     printLoop(index);
   }
-
-  delete [] voutDatas;
 }
 
 void LT_2977FaultLog::printLoop(uint8_t index)
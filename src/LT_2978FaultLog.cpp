@@ -32,6 +32,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <stdlib.h>
 #endif
 #include <unistd.h>
+#include "LT_Clock.h"
     
 #undef F
 #define F(s) s
@@ -41,10 +42,6 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 LT_2978FaultLog::LT_2978FaultLog(LT_PMBus *pmbus):LT_EEDataFaultLog(pmbus)
 {
   faultLog2978 = NULL;
-
-  buffer = NULL;
-  voutPeaks = NULL;
-  voutDatas = NULL;
 }
 
 
@@ -61,17 +58,32 @@ bool LT_2978FaultLog::FaultLogLtc2978::isValidData(void *pos, uint8_t size)
 void
 LT_2978FaultLog::read(uint8_t address)
 {
-  uint16_t size = sizeof(struct LT_2978FaultLog::FaultLogLtc2978);
-  uint8_t *data = (uint8_t *) malloc(size);
-  if (data == 0)
-    printf(F("bad malloc."));
-  data[0] = 0x00;
-
+  startRead(address);
+  // MFR_FAULT_LOG_RESTORE requires a delay (see datasheet), typical delay is 2ms, multiplying by 10 for safety
+  usleep(20 * 1000);
+  finishRead(address);
+}
 
+void
+LT_2978FaultLog::startRead(uint8_t address)
+{
   // Copy to RAM
   pmbus_->smbus()->sendByte(address, MFR_FAULT_LOG_RESTORE);
-  // MFR_FAULT_LOG_RESTORE requires a delay (see datasheet), typical delay is 2ms, multiplying by 10 for safety
-  usleep(20 * 1000);
+  restoreUs_ = LT_Clock::nowUs();
+}
+
+bool
+LT_2978FaultLog::isReadReady(uint8_t /* address */)
+{
+  return LT_Clock::nowUs() - restoreUs_ >= 20 * 1000;
+}
+
+void
+LT_2978FaultLog::finishRead(uint8_t address)
+{
+  uint8_t *data = logData;
+  data[0] = 0x00;
+
   // Read block data with log
   pmbus_->smbus()->readBlock(address, MFR_FAULT_LOG, data, 255);
 
@@ -91,7 +103,6 @@ LT_2978FaultLog::read(uint8_t address)
 
 void LT_2978FaultLog::release()
 {
-  free(faultLog2978);
   faultLog2978 = 0;
 }
 
@@ -105,6 +116,20 @@ uint16_t LT_2978FaultLog::getBinarySize()
   return 255;
 }
 
+uint64_t LT_2978FaultLog::getFaultTime200us()
+{
+  if (faultLog2978 == NULL)
+    return 0;
+  return getSharedTime200us(faultLog2978->preamble.shared_time);
+}
+
+uint8_t LT_2978FaultLog::getLoopCount()
+{
+  if (faultLog2978 == NULL)
+    return 0;
+  return faultLog2978->isValidData(&faultLog2978->loops[5]) ? 6 : 5;
+}
+
 void LT_2978FaultLog::dumpBinary()
 {
   dumpBin((uint8_t *)faultLog2978, 255);
@@ -112,8 +137,6 @@ void LT_2978FaultLog::dumpBinary()
 
 void LT_2978FaultLog::print()
 {
-  buffer = new char[FILE_TEXT_LINE_MAX];
-
   printTitle();
 
   printTime();
@@ -121,9 +144,6 @@ void LT_2978FaultLog::print()
   printPeaks();
 
   printAllLoops();
-
-
-  delete [] buffer;
 }
 
 
@@ -143,8 +163,6 @@ void LT_2978FaultLog::printTime()
 
 void LT_2978FaultLog::printPeaks()
 {
-  voutPeaks = new Peak16Words*[8];
-
   voutPeaks[0] = &faultLog2978->preamble.peaks.vout0_peaks;
   voutPeaks[1] = &faultLog2978->preamble.peaks.vout1_peaks;
   voutPeaks[2] = &faultLog2978->preamble.peaks.vout2_peaks;
@@ -186,8 +204,6 @@ void LT_2978FaultLog::printPeaks()
   printFastChannel(5);
   printFastChannel(6);
   printFastChannel(7);
-
-  delete [] voutPeaks;
 }
 
 void LT_2978FaultLog::printFastChannel(uint8_t index)
@@ -205,8 +221,6 @@ void LT_2978FaultLog::printFastChannel(uint8_t index)
 
 void LT_2978FaultLog::printAllLoops()
 {
-  voutDatas = new VoutData*[8];
-
   printf(F("Fault Log Loops Follow:\n"));
   printf(F("(most recent data first)\n"));
 
@@ -214,8 +228,6 @@ void LT_2978FaultLog::printAllLoops()
   {
     printLoop(index);
   }
-
-  delete [] voutDatas;
 }
 
 void LT_2978FaultLog::printLoop(uint8_t index)
@@ -33,6 +33,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "LT_PMBusMath.h"
 #include "LT_EEDataFaultLog.h"
 
+//! Number of output channels in the fault log.
+#define LTC2978_FAULT_LOG_CHANNELS 8
+
 //! class that handles LTC2978 fault logs.
 //! contains structs for interpreting the data read from the part.
 class LT_2978FaultLog : public LT_EEDataFaultLog
@@ -159,27 +162,44 @@ class LT_2978FaultLog : public LT_EEDataFaultLog
     //! Get size of binary data
     uint16_t getBinarySize();
 
+    //! Get the time stamp of the fault in 200us ticks, or 0 if no log
+    uint64_t getFaultTime200us();
+
+    //! Get the number of valid loops in the log, most recent first
+    uint8_t getLoopCount();
+
     //! Dumps binary of the fault log to a Print inheriting object, or Serial if none specified.
     void dumpBinary();
 
-    //! Reads the fault log from the specified address, reserves memory to hold the data.
+    //! Reads the fault log from the specified address into the log buffer of this object.
     //! @return a reference to the data read from the part.
     void read(uint8_t address  //!< the address to read the fault log from.
              );
 
+    //! Starts copying the fault log from EEPROM to RAM.
+    void startRead(uint8_t address);
+
+    //! @return true when the copy to RAM has had time to complete.
+    bool isReadReady(uint8_t address);
+
+    //! Reads the fault log copied to RAM by startRead().
+    void finishRead(uint8_t address);
+
     // ! Get the fault log data
     struct FaultLogLtc2978 *get()
     {
       return faultLog2978;
     }
 
-    //! Frees the memory reserved for the fault log.
+    //! Releases the fault log. The log buffer is reused by the next read.
     void release();
 
   private:
-    char *buffer;
-    Peak16Words **voutPeaks;
-    VoutData **voutDatas;
+    uint64_t restoreUs_;
+    char buffer[FILE_TEXT_LINE_MAX];
+    uint8_t logData[sizeof(struct FaultLogLtc2978)];
+    Peak16Words *voutPeaks[LTC2978_FAULT_LOG_CHANNELS];
+    VoutData *voutDatas[LTC2978_FAULT_LOG_CHANNELS];
 
     void printTitle();
     void printTime();
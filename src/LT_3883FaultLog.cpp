@@ -42,8 +42,6 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 LT_3883FaultLog::LT_3883FaultLog(LT_PMBus *pmbus):LT_EEDataFaultLog(pmbus)
 {
   faultLog3883 = NULL;
-
-  buffer = NULL;
 }
 
 
@@ -56,11 +54,11 @@ void
 LT_3883FaultLog::read(uint8_t address)
 {
 #ifdef RAW_EEPROM
-  uint8_t *data = (uint8_t *) malloc(sizeof(uint8_t) * 54 * 2); // Becuse CRC is stripped, the acutal data size is smaller
+  uint8_t *data = logData; // CRC is stripped, so only 54 words of the buffer are used
 
   getNvmBlock(address, 192*2, 54, true, data);
 #else
-  uint8_t *data = (uint8_t *) malloc(147);
+  uint8_t *data = logData;
   data[0] = 0x00;
 
   pmbus_->smbus()->readBlock(address, MFR_FAULT_LOG, data, 147);
@@ -72,7 +70,6 @@ LT_3883FaultLog::read(uint8_t address)
 
 void LT_3883FaultLog::release()
 {
-  free(faultLog3883);
   faultLog3883 = 0;
 }
 
@@ -86,6 +83,18 @@ uint16_t LT_3883FaultLog::getBinarySize()
   return 147;
 }
 
+uint64_t LT_3883FaultLog::getFaultTime200us()
+{
+  if (faultLog3883 == NULL)
+    return 0;
+  return getSharedTime200us(faultLog3883->preamble.shared_time);
+}
+
+uint8_t LT_3883FaultLog::getLoopCount()
+{
+  return faultLog3883 == NULL ? 0 : 4;
+}
+
 void LT_3883FaultLog::dumpBinary()
 {
   dumpBin((uint8_t *)faultLog3883, 147);
@@ -93,8 +102,6 @@ void LT_3883FaultLog::dumpBinary()
 
 void LT_3883FaultLog::print()
 {
-  buffer = new char[FILE_TEXT_LINE_MAX];
-
   printTitle();
 
   printTime();
@@ -102,9 +109,6 @@ void LT_3883FaultLog::print()
   printPeaks();
 
   printAllLoops();
-
-
-  delete [] buffer;
 }
 
 
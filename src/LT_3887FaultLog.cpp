@@ -42,8 +42,6 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 LT_3887FaultLog::LT_3887FaultLog(LT_PMBus *pmbus):LT_EEDataFaultLog(pmbus)
 {
   faultLog3887 = NULL;
-
-  buffer = NULL;
 }
 
 
@@ -56,11 +54,11 @@ void
 LT_3887FaultLog::read(uint8_t address)
 {
 #ifdef RAW_EEPROM
-  uint8_t *data = (uint8_t *) malloc(sizeof(uint8_t) * 54 * 2); // Becuse CRC is stripped, the acutal data size is smaller
+  uint8_t *data = logData; // CRC is stripped, so only 54 words of the buffer are used
 
   getNvmBlock(address, 192*2, 54, true, data);
 #else
-  uint8_t *data = (uint8_t *) malloc(147);
+  uint8_t *data = logData;
   data[0] = 0x00;
 
   pmbus_->smbus()->readBlock(address, MFR_FAULT_LOG, data, 147);
@@ -71,7 +69,6 @@ LT_3887FaultLog::read(uint8_t address)
 
 void LT_3887FaultLog::release()
 {
-  free(faultLog3887);
   faultLog3887 = 0;
 }
 
@@ -85,6 +82,18 @@ uint16_t LT_3887FaultLog::getBinarySize()
   return 147;
 }
 
+uint64_t LT_3887FaultLog::getFaultTime200us()
+{
+  if (faultLog3887 == NULL)
+    return 0;
+  return getSharedTime200us(faultLog3887->preamble.shared_time);
+}
+
+uint8_t LT_3887FaultLog::getLoopCount()
+{
+  return faultLog3887 == NULL ? 0 : 4;
+}
+
 void LT_3887FaultLog::dumpBinary()
 {
   dumpBin((uint8_t *)faultLog3887, 147);
@@ -92,8 +101,6 @@ void LT_3887FaultLog::dumpBinary()
 
 void LT_3887FaultLog::print()
 {
-  buffer = new char[FILE_TEXT_LINE_MAX];
-
   printTitle();
 
   printTime();
@@ -101,9 +108,6 @@ void LT_3887FaultLog::print()
   printPeaks();
 
   printAllLoops();
-
-
-  delete [] buffer;
 }
 
 
@@ -42,8 +42,6 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 LT_3888FaultLog::LT_3888FaultLog(LT_PMBus *pmbus):LT_EEDataFaultLog(pmbus)
 {
   faultLog3888 = NULL;
-
-  buffer = NULL;
 }
 
 /*
@@ -54,11 +52,11 @@ LT_3888FaultLog::LT_3888FaultLog(LT_PMBus *pmbus):LT_EEDataFaultLog(pmbus)
 void LT_3888FaultLog::read(uint8_t address)
 {
 #ifdef RAW_EEPROM
-  uint8_t *data = (uint8_t *) malloc(sizeof(uint8_t) * 54 * 2); // Becuse CRC is stripped, the acutal data size is smaller
+  uint8_t *data = logData; // CRC is stripped, so only 54 words of the buffer are used
 
   getNvmBlock(address, 192*2, 54, false, data);
 #else
-  uint8_t *data = (uint8_t *) malloc(147);
+  uint8_t *data = logData;
   data[0] = 0x00;
 
   pmbus_->smbus()->readBlock(address, MFR_FAULT_LOG, data, 147);
@@ -69,7 +67,6 @@ void LT_3888FaultLog::read(uint8_t address)
 
 void LT_3888FaultLog::release()
 {
-  free(faultLog3888);
   faultLog3888 = 0;
 }
 
@@ -83,6 +80,18 @@ uint16_t LT_3888FaultLog::getBinarySize()
   return 147;
 }
 
+uint64_t LT_3888FaultLog::getFaultTime200us()
+{
+  if (faultLog3888 == NULL)
+    return 0;
+  return getSharedTime200us(faultLog3888->preamble.shared_time);
+}
+
+uint8_t LT_3888FaultLog::getLoopCount()
+{
+  return faultLog3888 == NULL ? 0 : 4;
+}
+
 void LT_3888FaultLog::dumpBinary()
 {
   dumpBin((uint8_t *)faultLog3888, 147);
@@ -90,8 +99,6 @@ void LT_3888FaultLog::dumpBinary()
 
 void LT_3888FaultLog::print()
 {
-  buffer = new char[FILE_TEXT_LINE_MAX];
-
   printTitle();
 
   printTime();
@@ -99,9 +106,6 @@ void LT_3888FaultLog::print()
   printPeaks();
 
   printAllLoops();
-
-
-  delete [] buffer;
 }
 
 
@@ -42,8 +42,6 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 LT_7880FaultLog::LT_7880FaultLog(LT_PMBus *pmbus):LT_EEDataFaultLog(pmbus)
 {
   faultLog7880 = NULL;
-
-  buffer = NULL;
 }
 
 
@@ -56,11 +54,11 @@ void
 LT_7880FaultLog::read(uint8_t address)
 {
 #ifdef RAW_EEPROM
-  uint8_t *data = (uint8_t *) malloc(sizeof(uint8_t) * 54 * 2); // Becuse CRC is stripped, the acutal data size is smaller
+  uint8_t *data = logData; // CRC is stripped, so only 54 words of the buffer are used
 
   getNvmBlock(address, 192*2, 54, false, data);
 #else
-  uint8_t *data = (uint8_t *) malloc(147);
+  uint8_t *data = logData;
   data[0] = 0x00;
 
   pmbus_->smbus()->readBlock(address, MFR_FAULT_LOG, data, 147);
@@ -71,7 +69,6 @@ LT_7880FaultLog::read(uint8_t address)
 
 void LT_7880FaultLog::release()
 {
-  free(faultLog7880);
   faultLog7880 = 0;
 }
 
@@ -85,6 +82,18 @@ uint16_t LT_7880FaultLog::getBinarySize()
   return 147;
 }
 
+uint64_t LT_7880FaultLog::getFaultTime200us()
+{
+  if (faultLog7880 == NULL)
+    return 0;
+  return getSharedTime200us(faultLog7880->preamble.shared_time);
+}
+
+uint8_t LT_7880FaultLog::getLoopCount()
+{
+  return faultLog7880 == NULL ? 0 : 6;
+}
+
 void LT_7880FaultLog::dumpBinary()
 {
   dumpBin((uint8_t *)faultLog7880, 147);
@@ -92,8 +101,6 @@ void LT_7880FaultLog::dumpBinary()
 
 void LT_7880FaultLog::print()
 {
-  buffer = new char[FILE_TEXT_LINE_MAX];
-
   printTitle();
 
   printTime();
@@ -101,9 +108,6 @@ void LT_7880FaultLog::print()
   printPeaks();
 
   printAllLoops();
-
-
-  delete [] buffer;
 }
 
 
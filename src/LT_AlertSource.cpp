@@ -0,0 +1,111 @@
+/*
+Copyright (c) 2020, Analog Devices Inc
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  * Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  * Neither the name of the Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived from this
+    software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "LT_AlertSource.h"
+#include "LT_Exception.h"
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+
+LT_GpioAlertSource::LT_GpioAlertSource(const char *chip, uint32_t line)
+{
+  struct gpioevent_request req;
+
+  lineFd_ = -1;
+  chipFd_ = open(chip, O_RDONLY);
+  if (chipFd_ < 0)
+    throw LT_Exception("Fail to open GPIO chip");
+
+  // SMBALERT# is active low, so the alert starts on the falling edge.
+  memset(&req, 0, sizeof(req));
+  req.lineoffset = line;
+  req.handleflags = GPIOHANDLE_REQUEST_INPUT;
+  req.eventflags = GPIOEVENT_REQUEST_FALLING_EDGE;
+  strncpy(req.consumer_label, "smbalert", sizeof(req.consumer_label) - 1);
+  if (ioctl(chipFd_, GPIO_GET_LINEEVENT_IOCTL, &req) < 0)
+  {
+    close(chipFd_);
+    throw LT_Exception("Fail to request GPIO line event");
+  }
+  lineFd_ = req.fd;
+}
+
+LT_GpioAlertSource::~LT_GpioAlertSource()
+{
+  if (lineFd_ >= 0)
+    close(lineFd_);
+  if (chipFd_ >= 0)
+    close(chipFd_);
+}
+
+int LT_GpioAlertSource::getFd()
+{
+  return lineFd_;
+}
+
+void LT_GpioAlertSource::acknowledge()
+{
+  struct gpioevent_data event;
+
+  if (read(lineFd_, &event, sizeof(event)) < 0)
+    throw LT_Exception("Fail to read GPIO event");
+}
+
+bool LT_GpioAlertSource::isAsserted()
+{
+  struct gpiohandle_data data;
+
+  memset(&data, 0, sizeof(data));
+  if (ioctl(lineFd_, GPIOHANDLE_GET_LINE_VALUES_IOCTL, &data) < 0)
+    throw LT_Exception("Fail to read GPIO line");
+  return data.values[0] == 0;
+}
+
+LT_FdAlertSource::LT_FdAlertSource(int fd):fd_(fd)
+{
+}
+
+int LT_FdAlertSource::getFd()
+{
+  return fd_;
+}
+
+void LT_FdAlertSource::acknowledge()
+{
+  uint8_t buffer[64];
+
+  if (read(fd_, buffer, sizeof(buffer)) < 0)
+    throw LT_Exception("Fail to read alert");
+}
+
+bool LT_FdAlertSource::isAsserted()
+{
+  // Edge only, there is no line to look at.
+  return false;
+}
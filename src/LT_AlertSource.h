@@ -0,0 +1,86 @@
+/*
+Copyright (c) 2020, Analog Devices Inc
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  * Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  * Neither the name of the Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived from this
+    software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LT_AlertSource_H_
+#define LT_AlertSource_H_
+
+#include <stdint.h>
+
+//! Something that can be waited on for SMBALERT#, such as a GPIO line.
+class LT_AlertSource
+{
+  public:
+    virtual ~LT_AlertSource() {}
+
+    //! File descriptor that becomes readable when the alert fires.
+    //! @return descriptor or < 0 if the source is not open
+    virtual int getFd() = 0;
+
+    //! Consume the event that made the descriptor readable.
+    virtual void acknowledge() = 0;
+
+    //! Is the alert line still asserted? Used to find more devices pulling it low.
+    //! @return true if asserted
+    virtual bool isAsserted() = 0;
+};
+
+//! SMBALERT# connected to a GPIO, watched with the GPIO character device.
+class LT_GpioAlertSource : public LT_AlertSource
+{
+  protected:
+    int chipFd_;
+    int lineFd_;
+
+  public:
+    //! Constructor
+    LT_GpioAlertSource(const char *chip,    //!< GPIO chip, for example /dev/gpiochip0.
+                       uint32_t line        //!< line offset on the chip.
+                      );
+    ~LT_GpioAlertSource();
+
+    int getFd();
+    void acknowledge();
+    bool isAsserted();
+};
+
+//! Any file descriptor used as an alert, for example a pipe or eventfd in a test stand.
+class LT_FdAlertSource : public LT_AlertSource
+{
+  protected:
+    int fd_;
+
+  public:
+    //! Constructor
+    LT_FdAlertSource(int fd     //!< descriptor, not closed by this object.
+                    );
+
+    int getFd();
+    void acknowledge();
+    bool isAsserted();
+};
+
+#endif /* LT_AlertSource_H_ */
@@ -0,0 +1,233 @@
+/*
+Copyright (c) 2020, Analog Devices Inc
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  * Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  * Neither the name of the Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived from this
+    software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "LT_CodecBenchmark.h"
+#include "LT_Crc8.h"
+#include "LT_HexImage.h"
+#include "LT_Clock.h"
+#include <stdio.h>
+#include <string.h>
+#ifdef DMALLOC
+#include <dmalloc.h>
+#else
+#include <stdlib.h>
+#endif
+
+// Bytes of random data the CRC paths run over
+#define BENCH_CRC_BYTES     4194304
+// Random spans checked per CRC path
+#define BENCH_CRC_SPANS     20000
+// Eight byte records in the hex image
+#define BENCH_HEX_RECORDS   262144
+
+LT_CodecBenchmark::LT_CodecBenchmark()
+{
+  byteCnt_ = BENCH_CRC_BYTES;
+  bytes_ = (uint8_t *) malloc(byteCnt_);
+  failures_ = 0;
+}
+
+LT_CodecBenchmark::~LT_CodecBenchmark()
+{
+  free(bytes_);
+}
+
+/*
+ * CRC-8 one bit at a time, independent of the tables
+ */
+static uint8_t crc8Bitwise(uint8_t crc, const uint8_t *data, size_t length)
+{
+  uint8_t bit;
+
+  while (length-- > 0)
+  {
+    crc ^= *data++;
+    for (bit = 0; bit < 8; bit++)
+      crc = (crc & 0x80) ? (uint8_t) ((crc << 1) ^ 0x07) : (uint8_t) (crc << 1);
+  }
+  return crc;
+}
+
+void LT_CodecBenchmark::report(const char *name, uint64_t ns, size_t bytes, uint32_t mismatches)
+{
+  printf("%-36s %8lu bytes  %8.3f ns/byte  %u mismatches\n", name, (unsigned long) bytes,
+         (double) ns / bytes, mismatches);
+}
+
+/*
+ * Check and time the CRC-8 paths
+ *
+ * Random spans of 0 to 300 bytes at every alignment, with random starting CRCs,
+ * must give the same CRC on every path as the bitwise reference. Timing covers
+ * 32 byte NVM blocks, the common case, and one large buffer.
+ */
+void LT_CodecBenchmark::benchCrc()
+{
+  typedef uint8_t (*CrcFunction)(uint8_t, const uint8_t *, size_t);
+  static const struct
+  {
+    const char *name;
+    CrcFunction update;
+  } paths[] =
+  {
+    { "LT_Crc8::updateTable", LT_Crc8::updateTable },
+    { "LT_Crc8::updateSlice8", LT_Crc8::updateSlice8 },
+    { "LT_Crc8::updateClmul", LT_Crc8::updateClmul },
+    { "LT_Crc8::update", LT_Crc8::update },
+  };
+  uint8_t *bytes = bytes_;
+  size_t size = byteCnt_;
+  size_t i, block, offset, length;
+  uint32_t p, span, mismatches, seed = 12345;
+  uint8_t crc, expected;
+  volatile uint8_t sink = 0;
+  uint64_t start;
+
+  for (i = 0; i < size; i++)
+  {
+    seed = seed * 1664525 + 1013904223;
+    bytes[i] = (uint8_t) (seed >> 24);
+  }
+  printf("CRC-8, carry-less multiply %s\n", LT_Crc8::hasClmul() ? "available" : "not available");
+
+  for (p = 0; p < sizeof(paths) / sizeof(paths[0]); p++)
+  {
+    mismatches = 0;
+    seed = 54321;
+    for (span = 0; span < BENCH_CRC_SPANS; span++)
+    {
+      seed = seed * 1664525 + 1013904223;
+      offset = (seed >> 8) % 64;
+      length = (seed >> 16) % 301;
+      crc = (uint8_t) seed;
+      expected = crc8Bitwise(crc, bytes + offset, length);
+      if (paths[p].update(crc, bytes + offset, length) != expected)
+        mismatches++;
+    }
+    if (paths[p].update(0, bytes, size) != crc8Bitwise(0, bytes, size))
+      mismatches++;
+    failures_ += mismatches;
+
+    start = LT_Clock::nowNs();
+    for (block = 0; block + 32 <= size; block += 32)
+      sink ^= paths[p].update(0, bytes + block, 31);
+    report(paths[p].name, LT_Clock::nowNs() - start, size / 32 * 31, mismatches);
+
+    start = LT_Clock::nowNs();
+    sink ^= paths[p].update(0, bytes, size);
+    report("  one buffer", LT_Clock::nowNs() - start, size, 0);
+  }
+}
+
+/*
+ * Check and time hex image decoding
+ *
+ * A hex image of eight byte write byte records, 16 data bytes per line, is
+ * decoded and compared to the records it was made from. memcpy of the same
+ * text is the bandwidth to compare with. A wrong checksum and a character
+ * that is not hex must each fail the load.
+ */
+void LT_CodecBenchmark::benchHex()
+{
+  uint32_t recordBytes = BENCH_HEX_RECORDS * 8;
+  uint32_t lines = recordBytes / 16;
+  size_t textLength = (size_t) lines * 45 + 13;
+  char *text = (char *) malloc(textLength + 1);
+  char *copy = (char *) malloc(textLength + 1);
+  uint8_t *records = (uint8_t *) malloc(recordBytes);
+  uint32_t i, j, line, seed = 777, mismatches = 0, accepted = 0;
+  LT_HexImage image;
+  uint64_t start, ns;
+  uint8_t sum;
+  char *p;
+
+  for (i = 0; i < recordBytes; i += 8)
+  {
+    records[i] = 8;
+    records[i + 1] = 0;
+    records[i + 2] = RECORD_TYPE_PMBUS_WRITE_BYTE;
+    records[i + 3] = 0;
+    for (j = 4; j < 8; j++)
+    {
+      seed = seed * 1664525 + 1013904223;
+      records[i + j] = (uint8_t) (seed >> 24);
+    }
+  }
+  p = text;
+  for (line = 0; line < lines; line++)
+  {
+    sum = (uint8_t) (16 + (line * 16 >> 8) + line * 16);
+    p += sprintf(p, ":10%04X00", (line * 16) & 0xFFFF);
+    for (i = 0; i < 16; i++)
+    {
+      sum += records[line * 16 + i];
+      p += sprintf(p, "%02X", records[line * 16 + i]);
+    }
+    p += sprintf(p, "%02X\r\n", (uint8_t) -sum);
+  }
+  p += sprintf(p, ":00000001FF\r\n");
+  textLength = p - text;
+
+  start = LT_Clock::nowNs();
+  memcpy(copy, text, textLength);
+  ns = LT_Clock::nowNs() - start;
+  printf("%-36s %8lu bytes  %8.3f ns/byte\n", "memcpy of the hex text", (unsigned long) textLength,
+         (double) ns / textLength);
+
+  start = LT_Clock::nowNs();
+  if (!image.loadData(text, textLength) || image.getRecordCount() != BENCH_HEX_RECORDS + 1
+      || memcmp(image.getData(), records, recordBytes) != 0)
+    mismatches++;
+  ns = LT_Clock::nowNs() - start;
+  printf("%-36s %8lu bytes  %8.3f ns/byte  %u mismatches\n", "LT_HexImage::loadData", (unsigned long) textLength,
+         (double) ns / textLength, mismatches);
+
+  // Last data line: a checksum off by one, then a bad digit.
+  p = text + (size_t) (lines - 1) * 45;
+  p[41] = p[41] == '0' ? '1' : '0';
+  if (image.loadData(text, textLength))
+    accepted++;
+  p[41] = copy[p - text + 41];
+  p[20] = 'G';
+  if (image.loadData(text, textLength))
+    accepted++;
+  printf("Corrupt hex images: %u of 2 accepted\n", accepted);
+
+  failures_ += mismatches + accepted;
+  free(records);
+  free(copy);
+  free(text);
+}
+
+uint32_t LT_CodecBenchmark::run()
+{
+  failures_ = 0;
+  benchCrc();
+  benchHex();
+  printf("%u codec checks failed\n", failures_);
+  return failures_;
+}
@@ -0,0 +1,58 @@
+/*
+Copyright (c) 2020, Analog Devices Inc
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  * Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  * Neither the name of the Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived from this
+    software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LT_CodecBenchmark_H_
+#define LT_CodecBenchmark_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+//! Measures the CRC-8 paths in LT_Crc8 and hex image decoding, and checks them.
+//! Every CRC path must match a bitwise reference over random spans at every
+//! alignment, and a hex image must decode to the records it was made from while
+//! a corrupt one must fail to load. Any of these that does not hold is a failure.
+class LT_CodecBenchmark
+{
+  protected:
+    uint8_t *bytes_;        //!< random data for the CRC paths.
+    size_t byteCnt_;
+    uint32_t failures_;
+
+    void report(const char *name, uint64_t ns, size_t bytes, uint32_t mismatches);
+    void benchCrc();
+    void benchHex();
+
+  public:
+    LT_CodecBenchmark();
+    ~LT_CodecBenchmark();
+
+    //! Run all benchmarks and checks and print a line per path.
+    //! @return number of failed checks.
+    uint32_t run();
+};
+
+#endif /* LT_CodecBenchmark_H_ */
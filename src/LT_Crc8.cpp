@@ -0,0 +1,189 @@
+/*
+Copyright (c) 2020, Analog Devices Inc
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  * Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  * Neither the name of the Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived from this
+    software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "LT_Crc8.h"
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define CRC8_CLMUL_X86  1
+#elif defined(__aarch64__) && (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_AES))
+#include <arm_neon.h>
+#define CRC8_PMULL      1
+#endif
+
+#define CRC8_POLY       0x107
+// Spans shorter than this are faster with the tables.
+#define CRC8_CLMUL_MIN  64
+
+/*
+ * Tables and folding constants, built once at startup
+ *
+ * slice[0] is the byte table. slice[k][x] is the CRC of x followed by k zero
+ * bytes, so eight bytes are one lookup each and an XOR. Folding uses
+ * x^128 mod P and x^192 mod P to move 128 bits ahead by 128 bits.
+ */
+static struct Crc8Tables
+{
+  uint8_t slice[8][256];
+  uint64_t k128;
+  uint64_t k192;
+
+  static uint8_t xPowMod(uint16_t n)
+  {
+    uint16_t r = 1;
+    while (n-- > 0)
+    {
+      r <<= 1;
+      if (r & 0x100)
+        r ^= CRC8_POLY;
+    }
+    return (uint8_t) r;
+  }
+
+  Crc8Tables()
+  {
+    for (uint16_t x = 0; x < 256; x++)
+    {
+      uint16_t crc = x;
+      for (uint8_t bit = 0; bit < 8; bit++)
+        crc = (crc & 0x80) ? ((crc << 1) ^ CRC8_POLY) : (crc << 1);
+      slice[0][x] = (uint8_t) crc;
+    }
+    for (uint8_t k = 1; k < 8; k++)
+      for (uint16_t x = 0; x < 256; x++)
+        slice[k][x] = slice[0][slice[k - 1][x]];
+    k128 = xPowMod(128);
+    k192 = xPowMod(192);
+  }
+} tables_;
+
+uint8_t LT_Crc8::updateTable(uint8_t crc, const uint8_t *data, size_t length)
+{
+  for (size_t i = 0; i < length; i++)
+    crc = tables_.slice[0][crc ^ data[i]];
+  return crc;
+}
+
+uint8_t LT_Crc8::updateSlice8(uint8_t crc, const uint8_t *data, size_t length)
+{
+  while (length >= 8)
+  {
+    crc = tables_.slice[7][crc ^ data[0]] ^ tables_.slice[6][data[1]] ^
+          tables_.slice[5][data[2]] ^ tables_.slice[4][data[3]] ^
+          tables_.slice[3][data[4]] ^ tables_.slice[2][data[5]] ^
+          tables_.slice[1][data[6]] ^ tables_.slice[0][data[7]];
+    data += 8;
+    length -= 8;
+  }
+  return updateTable(crc, data, length);
+}
+
+/*
+ * Carry-less multiply
+ *
+ * Sixteen bytes are loaded byte reversed, so the first byte is the most
+ * significant, as in this CRC. The CRC so far is XORed into the first byte.
+ * Each step folds the 128 bits so far onto the next 16 bytes; the products are
+ * at most 71 bits. The folded 16 bytes and the remainder finish with the tables.
+ */
+#if CRC8_CLMUL_X86
+__attribute__((target("pclmul,ssse3")))
+static uint8_t clmulFold(uint8_t crc, const uint8_t *data, size_t blocks)
+{
+  const __m128i reverse = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+  const __m128i k = _mm_set_epi64x(tables_.k192, tables_.k128);
+  uint8_t folded[16];
+  __m128i a;
+
+  a = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) data), reverse);
+  a = _mm_xor_si128(a, _mm_set_epi8((char) crc, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0));
+  for (size_t i = 1; i < blocks; i++)
+  {
+    __m128i b = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (data + 16 * i)), reverse);
+    a = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(a, k, 0x00), _mm_clmulepi64_si128(a, k, 0x11)), b);
+  }
+  _mm_storeu_si128((__m128i *) folded, _mm_shuffle_epi8(a, reverse));
+  return LT_Crc8::updateSlice8(0, folded, 16);
+}
+#elif CRC8_PMULL
+static inline uint8x16_t reverse16(uint8x16_t x)
+{
+  x = vrev64q_u8(x);
+  return vextq_u8(x, x, 8);
+}
+
+static uint8_t clmulFold(uint8_t crc, const uint8_t *data, size_t blocks)
+{
+  uint8_t folded[16];
+  uint64x2_t a64;
+  uint8x16_t a;
+
+  a = reverse16(vld1q_u8(data));
+  a = veorq_u8(a, vsetq_lane_u8(crc, vdupq_n_u8(0), 15));
+  for (size_t i = 1; i < blocks; i++)
+  {
+    uint8x16_t b = reverse16(vld1q_u8(data + 16 * i));
+    a64 = vreinterpretq_u64_u8(a);
+    poly128_t lo = vmull_p64((poly64_t) vgetq_lane_u64(a64, 0), (poly64_t) tables_.k128);
+    poly128_t hi = vmull_p64((poly64_t) vgetq_lane_u64(a64, 1), (poly64_t) tables_.k192);
+    a = veorq_u8(veorq_u8(vreinterpretq_u8_p128(lo), vreinterpretq_u8_p128(hi)), b);
+  }
+  vst1q_u8(folded, reverse16(a));
+  return LT_Crc8::updateSlice8(0, folded, 16);
+}
+#endif
+
+bool LT_Crc8::hasClmul()
+{
+#if CRC8_CLMUL_X86
+  static const bool has = __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("ssse3");
+  return has;
+#elif CRC8_PMULL
+  return true;
+#else
+  return false;
+#endif
+}
+
+uint8_t LT_Crc8::updateClmul(uint8_t crc, const uint8_t *data, size_t length)
+{
+#if CRC8_CLMUL_X86 || CRC8_PMULL
+  if (length >= 16 && hasClmul())
+  {
+    crc = clmulFold(crc, data, length / 16);
+    data += length & ~(size_t) 15;
+    length &= 15;
+  }
+#endif
+  return updateSlice8(crc, data, length);
+}
+
+uint8_t LT_Crc8::update(uint8_t crc, const uint8_t *data, size_t length)
+{
+  if (length >= CRC8_CLMUL_MIN)
+    return updateClmul(crc, data, length);
+  return updateSlice8(crc, data, length);
+}
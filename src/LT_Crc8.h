@@ -0,0 +1,62 @@
+/*
+Copyright (c) 2020, Analog Devices Inc
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  * Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  * Neither the name of the Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived from this
+    software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LT_Crc8_H_
+#define LT_Crc8_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+//! CRC-8 with polynomial 0x07, the SMBus PEC and the CRC of NVM blocks. Stateless:
+//! each call takes the CRC so far and returns the new one, starting from 0.
+//! update uses carry-less multiply (PCLMUL or PMULL) on long spans when the CPU has it,
+//! and slice-by-8 tables otherwise.
+class LT_Crc8
+{
+  public:
+    //! Add bytes to a CRC.
+    //! @return the CRC
+    static uint8_t update(uint8_t crc,            //!< CRC so far, 0 to start.
+                          const uint8_t *data,    //!< bytes to add.
+                          size_t length           //!< number of bytes.
+                         );
+
+    //! update one byte per table lookup, the reference for the others.
+    static uint8_t updateTable(uint8_t crc, const uint8_t *data, size_t length);
+
+    //! update eight bytes per step with eight tables.
+    static uint8_t updateSlice8(uint8_t crc, const uint8_t *data, size_t length);
+
+    //! update sixteen bytes per step with carry-less multiply. Falls back to
+    //! updateSlice8 if the CPU does not have it.
+    static uint8_t updateClmul(uint8_t crc, const uint8_t *data, size_t length);
+
+    //! @return true if updateClmul uses carry-less multiply.
+    static bool hasClmul();
+};
+
+#endif /* LT_Crc8_H_ */
@@ -25,6 +25,9 @@ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
 SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#ifndef LT_Exception_H_
+#define LT_Exception_H_
+
 #ifdef DMALLOC
 #include <dmalloc.h>
 #else
@@ -43,4 +46,6 @@ public:
     ~LT_Exception() throw();
 
     const char* what() const throw();
-};
\ No newline at end of file
+};
+
+#endif /* LT_Exception_H_ */
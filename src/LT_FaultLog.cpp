@@ -26,6 +26,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "LT_FaultLog.h"
+#include "LT_StoreCoordinator.h"
+#include "LT_Exception.h"
     
 LT_FaultLog::LT_FaultLog(LT_PMBus *pmbus)
 {
@@ -215,6 +217,11 @@ LT_FaultLog::disableFaultLog(uint8_t address)
 void
 LT_FaultLog::storeFaultLog(uint8_t address)
 {
+  if (pmbus_->getStoreCoordinator() != NULL)
+  {
+    pmbus_->getStoreCoordinator()->markFaultLogDirty(address);
+    return;
+  }
   pmbus_->smbus()->sendByte(address, MFR_FAULT_LOG_STORE);
   pmbus_->smbus()->waitForAck(address, 0x00);
   pmbus_->waitForNotBusy(address);
@@ -262,6 +269,26 @@ LT_FaultLog::getSharedTime200us(FaultLogTimeStamp time_stamp)
 
 }
 
+/*
+ * Read the live shared time
+ *
+ * address: PMBUS address
+ *
+ * The counter runs on the same 200us ticks as the log time stamps, so it
+ * gives the age of a logged fault.
+ */
+uint64_t
+LT_FaultLog::readSharedTime200us(uint8_t address)
+{
+  uint8_t block[32];
+  FaultLogTimeStamp time_stamp;
+
+  if (pmbus_->smbus()->readBlock(address, MFR_REAL_TIME, block, sizeof(block)) != sizeof(time_stamp))
+    throw LT_Exception("Read shared time: bad size");
+  memcpy(&time_stamp, block, sizeof(time_stamp));
+  return getSharedTime200us(time_stamp);
+}
+
 float
 LT_FaultLog::getTimeInMs(FaultLogTimeStamp time_stamp)
 {
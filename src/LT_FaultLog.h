@@ -122,6 +122,13 @@ class LT_FaultLog
     uint8_t readMfrFaultLogStatusByte(uint8_t address);
   public:
     LT_FaultLog(LT_PMBus *pmbus);
+    virtual ~LT_FaultLog() {}
+
+    //! Change the pmbus, for example to switch PEC on or off.
+    void changePMBus(LT_PMBus *pmbus)
+    {
+      pmbus_ = pmbus;
+    }
 
     bool hasFaultLog(uint8_t address);
     void enableFaultLog(uint8_t address);
@@ -129,15 +136,41 @@ class LT_FaultLog
     void clearFaultLog(uint8_t address);
     void storeFaultLog(uint8_t address);
     virtual void read(uint8_t address) = 0;
+    //! Start a read without waiting on the part, so the waits of several parts can overlap.
+    virtual void startRead(uint8_t /* address */) {}
+    //! Poll a started read once.
+    //! @return true when finishRead() will not have to wait on the part.
+    virtual bool isReadReady(uint8_t /* address */)
+    {
+      return true;
+    }
+    //! Complete a started read.
+    virtual void finishRead(uint8_t address)
+    {
+      read(address);
+    }
     virtual void print() = 0;
     virtual uint8_t *getBinary() = 0;
     virtual uint16_t getBinarySize() = 0;
     virtual void dumpBinary() = 0;
     virtual void release() = 0;
 
+    //! Time stamp of the fault in 200us ticks, or 0 if the log has no time stamp.
+    virtual uint64_t getFaultTime200us()
+    {
+      return 0;
+    }
+    //! Number of valid read loops in the log, most recent first.
+    virtual uint8_t getLoopCount()
+    {
+      return 0;
+    }
+
     void dumpBin(uint8_t *log, uint8_t size);
 
     uint64_t getSharedTime200us(FaultLogTimeStamp time_stamp);
+    //! Read the live shared time counter of the part, in 200us ticks.
+    uint64_t readSharedTime200us(uint8_t address);
     float getTimeInMs(FaultLogTimeStamp time_stamp);
     uint8_t getRawByteVal(RawByte value);
     uint16_t getRawWordVal(RawWord value);
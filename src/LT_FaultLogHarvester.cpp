@@ -0,0 +1,296 @@
+/*
+Copyright (c) 2020, Analog Devices Inc
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  * Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  * Neither the name of the Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived from this
+    software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "LT_FaultLogHarvester.h"
+#include "LT_SMBusARA.h"
+#include "LT_Exception.h"
+#include "LT_Clock.h"
+#include <unistd.h>
+#ifdef DMALLOC
+#include <dmalloc.h>
+#else
+#include <stdlib.h>
+#endif
+
+LT_FaultLogHarvester::LT_FaultLogHarvester(uint8_t maxBuses)
+{
+  maxBuses_ = maxBuses;
+  busCnt_ = 0;
+  buses_ = (Bus *) calloc(maxBuses, sizeof(Bus));
+}
+
+LT_FaultLogHarvester::~LT_FaultLogHarvester()
+{
+  release();
+  for (uint8_t i = 0; i < busCnt_; i++)
+  {
+    free(buses_[i].results);
+    free(buses_[i].pending);
+  }
+  free(buses_);
+}
+
+bool LT_FaultLogHarvester::addBus(LT_PMBus *pmbus, LT_PMBusDevice **devices)
+{
+  if (busCnt_ >= maxBuses_)
+    return false;
+
+  uint16_t count = 0;
+  buses_[busCnt_].registry.clear();
+  while (devices[count] != NULL)
+    buses_[busCnt_].registry.addDevice(devices[count++]);
+
+  // Sized once for all devices, so harvesting does not allocate.
+  buses_[busCnt_].pmbus = pmbus;
+  buses_[busCnt_].devices = devices;
+  buses_[busCnt_].results = (Result *) calloc(count + 1, sizeof(Result));
+  buses_[busCnt_].pending = (LT_FaultLog **) calloc(count + 1, sizeof(LT_FaultLog *));
+  buses_[busCnt_].resultCnt = 0;
+  buses_[busCnt_].index = busCnt_;
+  buses_[busCnt_].adapter = pmbus->smbus()->adapterKey();
+  buses_[busCnt_].next = NULL;
+  buses_[busCnt_].follower = false;
+
+  // Two threads on one adapter would interleave their transfers on its handle.
+  for (uint8_t i = 0; i < busCnt_; i++)
+  {
+    if (buses_[i].adapter == buses_[busCnt_].adapter && buses_[i].next == NULL)
+    {
+      buses_[i].next = &buses_[busCnt_];
+      buses_[busCnt_].follower = true;
+      break;
+    }
+  }
+  busCnt_++;
+  return true;
+}
+
+/*
+ * Read the logs of a list of devices on one bus
+ *
+ * All reads are started before any is completed. Parts that have to copy
+ * their log from EEPROM to RAM do it at the same time, and the reads are
+ * completed round robin as each part reports ready. A round that finds no
+ * part ready sleeps before the next, and a part that is not ready by the
+ * deadline gets an error.
+ */
+void LT_FaultLogHarvester::readLogs(Bus *bus, LT_PMBusDevice **devices)
+{
+  uint16_t count = 0;
+  while (devices[count] != NULL)
+    count++;
+  if (count == 0)
+    return;
+
+  LT_FaultLog **pending = bus->pending;
+  bus->resultCnt = 0;
+
+  uint16_t remaining = 0;
+  for (uint16_t i = 0; i < count; i++)
+  {
+    uint8_t address = devices[i]->getAddress();
+    LT_FaultLog *log = devices[i]->faultLog();
+    pending[i] = NULL;
+    if (log == NULL)
+      continue;
+    try
+    {
+      if (!log->hasFaultLog(address))
+        continue;
+      log->startRead(address);
+      pending[i] = log;
+      remaining++;
+    }
+    catch (LT_Exception &ex)
+    {
+      Result *result = &bus->results[bus->resultCnt++];
+      result->bus = bus->index;
+      result->address = address;
+      result->device = devices[i];
+      result->log = NULL;
+      result->error = ex.what();
+    }
+  }
+
+  uint64_t deadline = LT_Clock::nowUs() + FAULT_LOG_HARVEST_TIMEOUT_US;
+  while (remaining > 0)
+  {
+    bool late = LT_Clock::nowUs() > deadline;
+    uint16_t done = 0;
+    for (uint16_t i = 0; i < count; i++)
+    {
+      if (pending[i] == NULL)
+        continue;
+
+      uint8_t address = devices[i]->getAddress();
+      Result *result = &bus->results[bus->resultCnt];
+      try
+      {
+        if (!pending[i]->isReadReady(address))
+        {
+          if (!late)
+            continue;
+          throw LT_Exception("Fault log read timed out");
+        }
+        pending[i]->finishRead(address);
+        result->log = pending[i];
+        result->error = NULL;
+      }
+      catch (LT_Exception &ex)
+      {
+        pending[i]->release();
+        result->log = NULL;
+        result->error = ex.what();
+      }
+      if (result->log != NULL)
+      {
+        // Tie the device clock to the host clock, the timeline needs both.
+        try
+        {
+          uint64_t before = LT_Clock::nowUs();
+          result->captureTime200us = result->log->readSharedTime200us(address);
+          result->captureTimeUs = (before + LT_Clock::nowUs()) / 2;
+        }
+        catch (LT_Exception &ex)
+        {
+          result->error = ex.what();
+        }
+      }
+      result->bus = bus->index;
+      result->address = address;
+      result->device = devices[i];
+      bus->resultCnt++;
+      pending[i] = NULL;
+      remaining--;
+      done++;
+    }
+    if (done == 0 && remaining > 0)
+      usleep(FAULT_LOG_HARVEST_POLL_US);
+  }
+}
+
+void *LT_FaultLogHarvester::harvestBus(void *arg)
+{
+  for (Bus *bus = (Bus *) arg; bus != NULL; bus = bus->next)
+  {
+    if (bus->alertOnly)
+    {
+      LT_SMBusARA ara(bus->pmbus->smbus());
+      LT_PMBusDevice **devices = ara.getDevices(&bus->registry);
+      readLogs(bus, devices);
+      free(devices);
+    }
+    else
+      readLogs(bus, bus->devices);
+  }
+
+  return NULL;
+}
+
+uint16_t LT_FaultLogHarvester::harvest(bool alertOnly)
+{
+  release();
+
+  // One thread per adapter, started on the first bus added for it.
+  uint8_t started;
+  for (started = 0; started < busCnt_; started++)
+    buses_[started].alertOnly = alertOnly;
+  for (started = 0; started < busCnt_; started++)
+  {
+    if (buses_[started].follower)
+      continue;
+    if (pthread_create(&buses_[started].thread, NULL, harvestBus, &buses_[started]) != 0)
+      break;
+  }
+  // The threads already started use the buses, so they are joined before giving up.
+  for (uint8_t i = 0; i < started; i++)
+    if (!buses_[i].follower)
+      pthread_join(buses_[i].thread, NULL);
+  if (started < busCnt_)
+    throw LT_Exception("Fail to start harvest thread");
+
+  uint16_t logs = 0;
+  for (uint16_t i = 0; i < getResultCount(); i++)
+    if (getResult(i)->log != NULL)
+      logs++;
+  return logs;
+}
+
+uint16_t LT_FaultLogHarvester::getResultCount()
+{
+  uint16_t count = 0;
+  for (uint8_t i = 0; i < busCnt_; i++)
+    count += buses_[i].resultCnt;
+  return count;
+}
+
+LT_FaultLogHarvester::Result *LT_FaultLogHarvester::getResult(uint16_t index)
+{
+  for (uint8_t i = 0; i < busCnt_; i++)
+  {
+    if (index < buses_[i].resultCnt)
+      return &buses_[i].results[index];
+    index -= buses_[i].resultCnt;
+  }
+  return NULL;
+}
+
+void LT_FaultLogHarvester::addToTimeline(LT_FaultLogTimeline *timeline)
+{
+  for (uint16_t i = 0; i < getResultCount(); i++)
+  {
+    Result *result = getResult(i);
+    if (result->log != NULL && result->error == NULL)
+      timeline->add(result->bus, result->address, result->log, result->captureTimeUs, result->captureTime200us);
+  }
+}
+
+void LT_FaultLogHarvester::print()
+{
+  for (uint16_t i = 0; i < getResultCount(); i++)
+  {
+    Result *result = getResult(i);
+    if (result->log != NULL)
+      result->log->print();
+    if (result->error != NULL)
+      printf("Fault log bus %d 0x%02x: %s\n", result->bus, result->address, result->error);
+  }
+}
+
+void LT_FaultLogHarvester::release()
+{
+  for (uint8_t i = 0; i < busCnt_; i++)
+  {
+    for (uint16_t j = 0; j < buses_[i].resultCnt; j++)
+    {
+      LT_FaultLog *log = buses_[i].results[j].log;
+      if (log != NULL)
+        log->release();
+    }
+    buses_[i].resultCnt = 0;
+  }
+}
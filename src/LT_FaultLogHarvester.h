@@ -0,0 +1,123 @@
+/*
+Copyright (c) 2020, Analog Devices Inc
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  * Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  * Neither the name of the Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived from this
+    software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LT_FaultLogHarvester_H_
+#define LT_FaultLogHarvester_H_
+
+#include <stdint.h>
+#include <pthread.h>
+#include "LT_PMBus.h"
+#include "LT_PMBusRegistry.h"
+#include "LT_PMBusDevice.h"
+#include "LT_FaultLog.h"
+#include "LT_FaultLogTimeline.h"
+
+//! Time a started fault log read may take before it is given up, in microseconds.
+#define FAULT_LOG_HARVEST_TIMEOUT_US 1000000
+//! Time between two rounds of polls while no part is ready, in microseconds.
+#define FAULT_LOG_HARVEST_POLL_US 1000
+
+//! Reads the fault logs of many devices as fast as possible, for example after SMBALERT.
+//! Each adapter is harvested by its own thread; buses added for the same adapter, for
+//! example with and without PEC, are harvested one after the other on that thread.
+//! On a bus, all reads are started first and
+//! then completed in the order the parts become ready, so the EEPROM wait of one part
+//! does not hold up the others.
+class LT_FaultLogHarvester
+{
+  public:
+    struct Result
+    {
+      public:
+        uint8_t bus;              //!< index of the bus in the order it was added.
+        uint8_t address;          //!< address of the device.
+        LT_PMBusDevice *device;   //!< the device.
+        LT_FaultLog *log;         //!< the log read, owned by the device, or NULL if the read failed.
+        uint64_t captureTimeUs;   //!< host time when the log was read.
+        uint64_t captureTime200us; //!< live device shared time read with the log.
+        const char *error;        //!< error text, or NULL on success. Also set with a log whose live shared time could not be read.
+    };
+
+  protected:
+    struct Bus
+    {
+      public:
+        LT_PMBus *pmbus;
+        LT_PMBusDevice **devices;
+        LT_PMBusRegistry registry;
+        Result *results;
+        LT_FaultLog **pending;
+        uint16_t resultCnt;
+        bool alertOnly;
+        uint8_t index;
+        long adapter;             //!< adapterKey() of the bus.
+        Bus *next;                //!< next bus on the same adapter, harvested by the same thread.
+        bool follower;            //!< an earlier bus is on the same adapter.
+        pthread_t thread;
+    };
+
+    Bus *buses_;
+    uint8_t maxBuses_;
+    uint8_t busCnt_;
+
+    static void *harvestBus(void *arg);
+    static void readLogs(Bus *bus, LT_PMBusDevice **devices);
+
+  public:
+    //! Constructor
+    LT_FaultLogHarvester(uint8_t maxBuses //!< maximum number of buses.
+                        );
+    ~LT_FaultLogHarvester();
+
+    //! Add a bus and the devices detected on it.
+    //! @return false if there is no room for the bus.
+    bool addBus(LT_PMBus *pmbus,            //!< the bus.
+                LT_PMBusDevice **devices    //!< NULL terminated list of devices on the bus.
+               );
+
+    //! Read the fault logs on all buses in parallel. Releases the results of the previous harvest.
+    //! @return number of logs read.
+    uint16_t harvest(bool alertOnly      //!< only devices that answer the alert response address if true.
+                    );
+
+    //! Get the number of results, including failed reads.
+    uint16_t getResultCount();
+
+    //! Get a result, ordered by bus, then by the order the reads completed.
+    Result *getResult(uint16_t index);
+
+    //! Add all logs read to a timeline.
+    void addToTimeline(LT_FaultLogTimeline *timeline);
+
+    //! Pretty prints all logs read.
+    void print();
+
+    //! Releases all logs read.
+    void release();
+};
+
+#endif /* LT_FaultLogHarvester_H_ */
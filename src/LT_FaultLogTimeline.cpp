@@ -0,0 +1,199 @@
+/*
+Copyright (c) 2020, Analog Devices Inc
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  * Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  * Neither the name of the Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived from this
+    software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "LT_FaultLogTimeline.h"
+#ifdef DMALLOC
+#include <dmalloc.h>
+#else
+#include <stdlib.h>
+#endif
+
+/*
+ * Cursor into one log while merging. Loops are stored most recent first, so
+ * a cursor walks from the oldest loop down to loop 0.
+ */
+struct MergeCursor
+{
+  int64_t timeUs;
+  uint16_t source;
+  int16_t loop;
+};
+
+static bool
+before(const MergeCursor *a, const MergeCursor *b)
+{
+  if (a->timeUs != b->timeUs)
+    return a->timeUs < b->timeUs;
+  return a->source < b->source;
+}
+
+static void
+siftDown(MergeCursor *heap, uint16_t size, uint16_t i)
+{
+  MergeCursor c = heap[i];
+  while (1)
+  {
+    uint16_t child = 2 * i + 1;
+    if (child >= size)
+      break;
+    if (child + 1 < size && before(&heap[child + 1], &heap[child]))
+      child++;
+    if (!before(&heap[child], &c))
+      break;
+    heap[i] = heap[child];
+    i = child;
+  }
+  heap[i] = c;
+}
+
+LT_FaultLogTimeline::LT_FaultLogTimeline(uint16_t maxSources)
+{
+  maxSources_ = maxSources;
+  sources_ = (Source *) malloc(sizeof(Source) * maxSources);
+  sourceCnt_ = 0;
+  events_ = NULL;
+  eventCnt_ = 0;
+}
+
+LT_FaultLogTimeline::~LT_FaultLogTimeline()
+{
+  free(sources_);
+  free(events_);
+}
+
+/*
+ * Add a log to the timeline
+ *
+ * The device clock is tied to the host clock at the moment of capture, so the
+ * fault happened (live - logged) ticks before the capture. A live counter
+ * below the logged one means the part restarted since the fault, and the log
+ * can not be placed.
+ */
+bool LT_FaultLogTimeline::add(uint8_t bus, uint8_t address, LT_FaultLog *log, uint64_t captureTimeUs, uint64_t captureTime200us, uint32_t loopPeriodUs)
+{
+  if (sourceCnt_ >= maxSources_ || log == NULL)
+    return false;
+
+  uint8_t loops = log->getLoopCount();
+  if (loops == 0)
+    return false;
+
+  uint64_t faultTime200us = log->getFaultTime200us();
+  if (captureTime200us < faultTime200us)
+    return false;
+
+  Source *s = &sources_[sourceCnt_++];
+  s->bus = bus;
+  s->address = address;
+  s->log = log;
+  s->faultUs = (int64_t) captureTimeUs - (int64_t) ((captureTime200us - faultTime200us) * 200);
+  s->loopPeriodUs = loopPeriodUs;
+  s->loops = loops;
+  return true;
+}
+
+int64_t LT_FaultLogTimeline::loopTime(uint16_t source, uint8_t loop)
+{
+  Source *s = &sources_[source];
+  return s->faultUs - (int64_t) loop * s->loopPeriodUs;
+}
+
+/*
+ * K-way merge of the loops of all logs
+ *
+ * Each log is already in time order, so a heap of one cursor per log gives
+ * the merged order in O(n log k) for n loops from k logs.
+ */
+uint16_t LT_FaultLogTimeline::build()
+{
+  uint16_t total = 0;
+  for (uint16_t i = 0; i < sourceCnt_; i++)
+    total += sources_[i].loops;
+
+  free(events_);
+  events_ = (Event *) malloc(sizeof(Event) * (total ? total : 1));
+  eventCnt_ = 0;
+
+  MergeCursor *heap = (MergeCursor *) malloc(sizeof(MergeCursor) * (sourceCnt_ ? sourceCnt_ : 1));
+  uint16_t size = 0;
+  for (uint16_t i = 0; i < sourceCnt_; i++)
+  {
+    heap[size].source = i;
+    heap[size].loop = sources_[i].loops - 1;
+    heap[size].timeUs = loopTime(i, heap[size].loop);
+    size++;
+  }
+  for (int i = size / 2 - 1; i >= 0; i--)
+    siftDown(heap, size, i);
+
+  while (size > 0)
+  {
+    MergeCursor *top = &heap[0];
+    Event *e = &events_[eventCnt_++];
+    e->timeUs = top->timeUs;
+    e->bus = sources_[top->source].bus;
+    e->address = sources_[top->source].address;
+    e->loop = top->loop;
+    e->source = top->source;
+    e->log = sources_[top->source].log;
+
+    if (top->loop > 0)
+    {
+      top->loop--;
+      top->timeUs = loopTime(top->source, top->loop);
+    }
+    else
+      heap[0] = heap[--size];
+    if (size > 0)
+      siftDown(heap, size, 0);
+  }
+
+  free(heap);
+  return eventCnt_;
+}
+
+void LT_FaultLogTimeline::print()
+{
+  if (eventCnt_ == 0)
+  {
+    printf("No fault log events\n");
+    return;
+  }
+
+  int64_t start = events_[0].timeUs;
+  printf("Fault Log Timeline (oldest first)\n");
+  for (uint16_t i = 0; i < eventCnt_; i++)
+  {
+    printf("%+12.1f ms  Bus: %d  0x%02x  Loop: %d\n", (events_[i].timeUs - start) / 1000.0, events_[i].bus, events_[i].address, events_[i].loop);
+  }
+}
+
+void LT_FaultLogTimeline::clear()
+{
+  sourceCnt_ = 0;
+  eventCnt_ = 0;
+}
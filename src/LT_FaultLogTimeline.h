@@ -0,0 +1,114 @@
+/*
+Copyright (c) 2020, Analog Devices Inc
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  * Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  * Neither the name of the Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived from this
+    software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LT_FaultLogTimeline_H_
+#define LT_FaultLogTimeline_H_
+
+#include <stdint.h>
+#include "LT_FaultLog.h"
+
+//! Default time between two fault log read loops in microseconds.
+#define FAULT_LOG_LOOP_PERIOD_US 100000
+
+//! Merges the read loops of fault logs from many devices into one time ordered list.
+//! Each device counts shared time in 200us ticks from its own power up, so a fault is
+//! placed on the host clock by its age: the live counter read at capture minus the
+//! counter in the log.
+class LT_FaultLogTimeline
+{
+  public:
+    struct Event
+    {
+      public:
+        int64_t timeUs;       //!< host time of the loop in microseconds.
+        uint8_t bus;          //!< bus the device is on.
+        uint8_t address;      //!< address of the device that logged the loop.
+        uint8_t loop;         //!< loop index in the device log, 0 is the most recent.
+        uint16_t source;      //!< index of the log in the order it was added.
+        LT_FaultLog *log;     //!< the log holding the loop data.
+    };
+
+  protected:
+    struct Source
+    {
+      public:
+        uint8_t bus;
+        uint8_t address;
+        LT_FaultLog *log;
+        int64_t faultUs;
+        uint32_t loopPeriodUs;
+        uint8_t loops;
+    };
+
+    Source *sources_;
+    uint16_t maxSources_;
+    uint16_t sourceCnt_;
+    Event *events_;
+    uint16_t eventCnt_;
+
+    int64_t loopTime(uint16_t source, uint8_t loop);
+
+  public:
+    //! Constructor
+    LT_FaultLogTimeline(uint16_t maxSources //!< maximum number of logs that can be added.
+                       );
+    ~LT_FaultLogTimeline();
+
+    //! Add a log that has already been read.
+    //! @return false if the log is empty, older than the live counter or the timeline is full.
+    bool add(uint8_t bus,                 //!< bus the log was read on, to tell apart equal addresses.
+             uint8_t address,             //!< address the log was read from.
+             LT_FaultLog *log,            //!< the log, must stay valid until clear().
+             uint64_t captureTimeUs,      //!< host time when the log was read.
+             uint64_t captureTime200us,   //!< live device shared time read with the log.
+             uint32_t loopPeriodUs = FAULT_LOG_LOOP_PERIOD_US //!< time between read loops.
+            );
+
+    //! Merge all loops of all added logs, oldest first.
+    //! @return number of events.
+    uint16_t build();
+
+    //! Get the merged events. Valid until the next build() or clear().
+    Event *getEvents()
+    {
+      return events_;
+    }
+
+    //! Get the number of merged events.
+    uint16_t getEventCount()
+    {
+      return eventCnt_;
+    }
+
+    //! Pretty prints the merged events.
+    void print();
+
+    //! Forget all logs and events. Does not release the logs.
+    void clear();
+};
+
+#endif /* LT_FaultLogTimeline_H_ */
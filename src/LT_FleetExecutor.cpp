@@ -0,0 +1,277 @@
+/*
+Copyright (c) 2020, Analog Devices Inc
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  * Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  * Neither the name of the Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived from this
+    software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "LT_FleetExecutor.h"
+#include "LT_Clock.h"
+#include "LT_Exception.h"
+#include <stdio.h>
+#include <string.h>
+#ifdef DMALLOC
+#include <dmalloc.h>
+#else
+#include <stdlib.h>
+#endif
+
+LT_FleetExecutor::LT_FleetExecutor(uint8_t maxBuses)
+{
+  maxPartitions_ = maxBuses;
+  partitionCnt_ = 0;
+  partitions_ = (Partition *) calloc(maxBuses, sizeof(Partition));
+  operation_ = FLEET_READ_STATUS;
+  voltage_ = 0.0;
+  elapsedUs_ = 0;
+}
+
+LT_FleetExecutor::~LT_FleetExecutor()
+{
+  clear();
+  free(partitions_);
+}
+
+void LT_FleetExecutor::clear()
+{
+  for (uint8_t i = 0; i < partitionCnt_; i++)
+    free(partitions_[i].results);
+  memset(partitions_, 0, maxPartitions_ * sizeof(Partition));
+  partitionCnt_ = 0;
+}
+
+/*
+ * Find the partition of a bus, adding one if it is new, and make room for
+ * one more target in it.
+ */
+LT_FleetExecutor::Result *LT_FleetExecutor::addTarget(LT_SMBus *smbus)
+{
+  long adapter = smbus->adapterKey();
+  Partition *partition = NULL;
+  Result *results;
+  uint8_t i;
+
+  for (i = 0; i < partitionCnt_; i++)
+    if (partitions_[i].adapter == adapter)
+      partition = &partitions_[i];
+  if (partition == NULL)
+  {
+    if (partitionCnt_ >= maxPartitions_)
+      return NULL;
+    partition = &partitions_[partitionCnt_++];
+    partition->adapter = adapter;
+    partition->executor = this;
+  }
+
+  if (partition->targetCnt == partition->capacity)
+  {
+    uint16_t capacity = partition->capacity == 0 ? 16 : 2 * partition->capacity;
+    if ((results = (Result *) realloc(partition->results, capacity * sizeof(Result))) == NULL)
+      return NULL;
+    partition->results = results;
+    partition->capacity = capacity;
+  }
+
+  results = &partition->results[partition->targetCnt++];
+  memset(results, 0, sizeof(Result));
+  return results;
+}
+
+bool LT_FleetExecutor::addDevice(LT_PMBusDevice *device)
+{
+  Result *result;
+
+  if ((result = addTarget(device->pmbus()->smbus())) == NULL)
+    return false;
+  result->address = device->getAddress();
+  result->device = device;
+  return true;
+}
+
+bool LT_FleetExecutor::addRail(LT_PMBusRail *rail)
+{
+  Result *result;
+
+  if ((result = addTarget(rail->pmbus()->smbus())) == NULL)
+    return false;
+  result->address = rail->getAddress();
+  result->rail = rail;
+  return true;
+}
+
+bool LT_FleetExecutor::addDevices(LT_PMBusDevice **devices)
+{
+  while (devices != NULL && *devices != NULL)
+    if (!addDevice(*devices++))
+      return false;
+  return true;
+}
+
+bool LT_FleetExecutor::addRails(LT_PMBusRail **rails)
+{
+  while (rails != NULL && *rails != NULL)
+    if (!addRail(*rails++))
+      return false;
+  return true;
+}
+
+/*
+ * Run the operation on one target. A rail uses the rail address for
+ * commands every phase follows and visits each device for the others.
+ */
+void LT_FleetExecutor::runTarget(Result *result)
+{
+  LT_PMBusDevice *device = result->device;
+  LT_PMBusRail *rail = result->rail;
+  const tRailPhase *phase;
+  uint16_t i;
+
+  result->value = 0;
+  result->error = NULL;
+  try
+  {
+    switch (operation_)
+    {
+      case FLEET_MARGIN_HIGH:
+        device != NULL ? device->marginHigh() : rail->marginHigh();
+        break;
+      case FLEET_MARGIN_LOW:
+        device != NULL ? device->marginLow() : rail->marginLow();
+        break;
+      case FLEET_MARGIN_OFF:
+        device != NULL ? device->marginOff() : rail->marginOff();
+        break;
+      case FLEET_CLEAR_FAULTS:
+        device != NULL ? device->clearFaults() : rail->clearFaults();
+        break;
+      case FLEET_COMPARE_NVM:
+        if (device != NULL)
+          result->value = device->pmbus()->compareRamWithNvm(device->getAddress());
+        else
+        {
+          result->value = 1;
+          for (i = 0; i < rail->getNoPages(); i++)
+          {
+            phase = rail->getPhase(i);
+            if (phase->firstOfDevice && !rail->pmbus()->compareRamWithNvm(phase->address))
+              result->value = 0;
+          }
+        }
+        break;
+      case FLEET_READ_STATUS:
+        result->value = device != NULL ? device->readStatusWord() : rail->readStatusWord();
+        break;
+      case FLEET_SET_VOUT:
+        device != NULL ? device->setVout(voltage_) : rail->setVout(voltage_);
+        break;
+    }
+  }
+  catch (LT_Exception &ex)
+  {
+    result->error = ex.what();
+  }
+}
+
+void *LT_FleetExecutor::runPartition(void *arg)
+{
+  Partition *partition = (Partition *) arg;
+  uint64_t start = LT_Clock::nowUs();
+
+  for (uint16_t i = 0; i < partition->targetCnt; i++)
+    partition->executor->runTarget(&partition->results[i]);
+  partition->elapsedUs = LT_Clock::nowUs() - start;
+
+  return NULL;
+}
+
+uint16_t LT_FleetExecutor::run(Operation operation, float voltage)
+{
+  uint64_t start = LT_Clock::nowUs();
+  uint16_t failed = 0;
+  uint8_t i;
+
+  operation_ = operation;
+  voltage_ = voltage;
+
+  // A single bus runs on the calling thread.
+  if (partitionCnt_ == 1)
+    runPartition(&partitions_[0]);
+  else
+  {
+    for (i = 0; i < partitionCnt_; i++)
+      if (pthread_create(&partitions_[i].thread, NULL, runPartition, &partitions_[i]) != 0)
+      {
+        while (i-- > 0)
+          pthread_join(partitions_[i].thread, NULL);
+        throw LT_Exception("Fail to start fleet thread");
+      }
+    for (i = 0; i < partitionCnt_; i++)
+      pthread_join(partitions_[i].thread, NULL);
+  }
+  elapsedUs_ = LT_Clock::nowUs() - start;
+
+  for (uint16_t j = 0; j < getResultCount(); j++)
+    if (getResult(j)->error != NULL)
+      failed++;
+  return failed;
+}
+
+uint16_t LT_FleetExecutor::getResultCount()
+{
+  uint16_t count = 0;
+  for (uint8_t i = 0; i < partitionCnt_; i++)
+    count += partitions_[i].targetCnt;
+  return count;
+}
+
+LT_FleetExecutor::Result *LT_FleetExecutor::getResult(uint16_t index)
+{
+  for (uint8_t i = 0; i < partitionCnt_; i++)
+  {
+    if (index < partitions_[i].targetCnt)
+      return &partitions_[i].results[index];
+    index -= partitions_[i].targetCnt;
+  }
+  return NULL;
+}
+
+void LT_FleetExecutor::print()
+{
+  for (uint16_t i = 0; i < getResultCount(); i++)
+  {
+    Result *result = getResult(i);
+    printf("%s 0x%02x: ", result->device != NULL ? "Device" : "Rail", result->address);
+    if (result->error != NULL)
+      printf("%s\n", result->error);
+    else if (operation_ == FLEET_READ_STATUS)
+      printf("STATUS_WORD 0x%04x\n", result->value);
+    else if (operation_ == FLEET_COMPARE_NVM)
+      printf("%s\n", result->value ? "RAM matches NVM" : "RAM differs from NVM");
+    else
+      printf("ok\n");
+  }
+  for (uint8_t i = 0; i < partitionCnt_; i++)
+    printf("Bus %u: %u targets in %lu us\n", i, partitions_[i].targetCnt,
+           (unsigned long) partitions_[i].elapsedUs);
+  printf("All buses in %lu us\n", (unsigned long) elapsedUs_);
+}
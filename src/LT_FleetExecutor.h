@@ -0,0 +1,137 @@
+/*
+Copyright (c) 2020, Analog Devices Inc
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  * Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  * Neither the name of the Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived from this
+    software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LT_FleetExecutor_H_
+#define LT_FleetExecutor_H_
+
+#include <stdint.h>
+#include <pthread.h>
+#include "LT_PMBus.h"
+#include "LT_PMBusDevice.h"
+#include "LT_PMBusRail.h"
+
+//! Runs one operation on many devices and rails at once. Targets are grouped by the
+//! adapter they are on, and each adapter is driven by its own thread, so an action on the
+//! whole fleet takes about as long as the busiest bus. Results and errors are kept per target.
+class LT_FleetExecutor
+{
+  public:
+    enum Operation
+    {
+      FLEET_MARGIN_HIGH,
+      FLEET_MARGIN_LOW,
+      FLEET_MARGIN_OFF,
+      FLEET_CLEAR_FAULTS,
+      FLEET_COMPARE_NVM,    //!< value is 1 if RAM matches NVM.
+      FLEET_READ_STATUS,    //!< value is STATUS_WORD, or'ed over the pages of a rail.
+      FLEET_SET_VOUT
+    };
+
+    struct Result
+    {
+      public:
+        uint8_t address;          //!< address of the device, or rail address.
+        LT_PMBusDevice *device;   //!< the device, or NULL for a rail.
+        LT_PMBusRail *rail;       //!< the rail, or NULL for a device.
+        uint16_t value;           //!< value read, see Operation.
+        const char *error;        //!< error text, or NULL on success.
+    };
+
+  protected:
+    struct Partition
+    {
+      public:
+        long adapter;             //!< adapterKey() of the bus.
+        Result *results;          //!< one per target, the target is in device or rail.
+        uint16_t targetCnt;
+        uint16_t capacity;
+        uint64_t elapsedUs;       //!< time of the last run on this bus.
+        LT_FleetExecutor *executor;
+        pthread_t thread;
+    };
+
+    Partition *partitions_;
+    uint8_t maxPartitions_;
+    uint8_t partitionCnt_;
+    Operation operation_;
+    float voltage_;
+    uint64_t elapsedUs_;
+
+    Result *addTarget(LT_SMBus *smbus);
+    static void *runPartition(void *arg);
+    void runTarget(Result *result);
+
+  public:
+    //! Constructor
+    LT_FleetExecutor(uint8_t maxBuses //!< maximum number of adapters.
+                    );
+    ~LT_FleetExecutor();
+
+    //! Add a device.
+    //! @return false if there is no room for its bus.
+    bool addDevice(LT_PMBusDevice *device //!< the device.
+                  );
+
+    //! Add a rail.
+    //! @return false if there is no room for its bus.
+    bool addRail(LT_PMBusRail *rail //!< the rail.
+                );
+
+    //! Add a NULL terminated list of devices, like LT_PMBusDetect::getDevices().
+    //! @return false if there is no room for a bus.
+    bool addDevices(LT_PMBusDevice **devices);
+
+    //! Add a NULL terminated list of rails, like LT_PMBusDetect::getRails().
+    //! @return false if there is no room for a bus.
+    bool addRails(LT_PMBusRail **rails);
+
+    //! Forget all targets.
+    void clear();
+
+    //! Run an operation on all targets, one thread per bus. Replaces the previous results.
+    //! @return number of targets that failed.
+    uint16_t run(Operation operation,   //!< what to do.
+                 float voltage = 0.0    //!< output voltage for FLEET_SET_VOUT.
+                );
+
+    //! Get the number of buses the targets are on.
+    uint8_t getBusCount()
+    {
+      return partitionCnt_;
+    }
+
+    //! Get the number of results, one per target.
+    uint16_t getResultCount();
+
+    //! Get a result, ordered by bus, then by the order the targets were added.
+    Result *getResult(uint16_t index);
+
+    //! Print the results and the time per bus.
+    void print();
+};
+
+#endif /* LT_FleetExecutor_H_ */
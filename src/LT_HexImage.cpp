@@ -0,0 +1,393 @@
+/*
+Copyright (c) 2020, Analog Devices Inc
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  * Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  * Neither the name of the Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived from this
+    software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "LT_HexImage.h"
+#include "hex_file_parser.h"
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef DMALLOC
+#include <dmalloc.h>
+#else
+#include <stdlib.h>
+#endif
+
+#define CACHE_MAGIC 0x4943544c   // "LTCI"
+#define CACHE_VERSION 2
+#define RECORD_ALIGN 4
+
+/*
+ * The end of file hex record is replaced by an END_OF_RECORDS record, as
+ * parse_hex() does.
+ */
+static const uint8_t endOfRecords[] = {4, 0, RECORD_TYPE_END_OF_RECORDS, 0, 0, 0, 0, 0};
+
+LT_HexImage::LT_HexImage()
+{
+  data_ = NULL;
+  dataLength_ = 0;
+  spans_ = NULL;
+  spanCnt_ = 0;
+  map_ = NULL;
+  mapLength_ = 0;
+}
+
+LT_HexImage::~LT_HexImage()
+{
+  release();
+}
+
+void LT_HexImage::release()
+{
+  if (map_ != NULL)
+    munmap(map_, mapLength_);
+  else
+    free(data_);
+  map_ = NULL;
+  mapLength_ = 0;
+  data_ = NULL;
+  dataLength_ = 0;
+  spans_ = NULL;
+  spanCnt_ = 0;
+}
+
+bool LT_HexImage::load(const char *path)
+{
+  struct stat st;
+  void *map;
+  bool ok;
+  int fd;
+
+  if ((fd = open(path, O_RDONLY)) < 0)
+    return false;
+  if (fstat(fd, &st) < 0 || st.st_size == 0)
+  {
+    close(fd);
+    return false;
+  }
+  map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED)
+    return false;
+  madvise(map, st.st_size, MADV_SEQUENTIAL);
+
+  ok = loadData((const char *) map, st.st_size);
+  munmap(map, st.st_size);
+  return ok;
+}
+
+bool LT_HexImage::loadData(const char *text, size_t length)
+{
+  release();
+
+  if (!decode(text, length) || !split())
+  {
+    release();
+    return false;
+  }
+  return true;
+}
+
+/*
+ * The copy is followed by room for the spans, as decode() leaves it.
+ */
+bool LT_HexImage::loadRecords(const uint8_t *records, uint32_t length)
+{
+  size_t spanCapacity = length / sizeof(tRecordHeaderLengthAndType) + 1;
+  size_t spanStart = (length + sizeof(Span) - 1) / sizeof(Span) * sizeof(Span);
+
+  release();
+  if (length == 0 || (data_ = (uint8_t *) malloc(spanStart + spanCapacity * sizeof(Span))) == NULL)
+    return false;
+  spans_ = (Span *) (data_ + spanStart);
+  memcpy(data_, records, length);
+  dataLength_ = length;
+
+  if (!split())
+  {
+    release();
+    return false;
+  }
+  return true;
+}
+
+/*
+ * Decode the data of each hex record into data_. The output is sized from
+ * the text length: every decoded byte costs at least two characters, and a
+ * record is at least four bytes, so the spans fit behind the data.
+ *
+ * Every record checksum is checked while its line is decoded, and a bad one
+ * fails the whole image, so a corrupt file is rejected before anything is
+ * sent to a device. The checksum byte of a data record lands after its data
+ * and is overwritten by the next record.
+ */
+bool LT_HexImage::decode(const char *text, size_t length)
+{
+  const char *p = text;
+  const char *end = text + length;
+  size_t capacity = length / 2 + sizeof(endOfRecords);
+  size_t spanCapacity = capacity / sizeof(tRecordHeaderLengthAndType) + 1;
+  size_t spanStart = (capacity + sizeof(Span) - 1) / sizeof(Span) * sizeof(Span);
+  uint8_t header[4];
+  uint8_t other[256];
+  uint8_t count, type, sum;
+  uint32_t out = 0;
+
+  if ((data_ = (uint8_t *) malloc(spanStart + spanCapacity * sizeof(Span))) == NULL)
+    return false;
+  spans_ = (Span *) (data_ + spanStart);
+
+  while (p < end)
+  {
+    if ((p = (const char *) memchr(p, ':', end - p)) == NULL)
+      break;
+    p++;
+    if (end - p < 10)
+      return false;
+
+    sum = 0;
+    if (!decode_hex(p, sizeof(header), header, &sum))
+      return false;
+    count = header[0];
+    type = header[3];
+    p += 8;
+    if (end - p < count * 2 + 2)
+      return false;
+
+    // Data and checksum in one pass, the sum of all record bytes must be 0.
+    if (!decode_hex(p, count + 1, type == 0 ? data_ + out : other, &sum) || sum != 0)
+      return false;
+    p += count * 2 + 2;
+
+    if (type == 0)
+      out += count;
+    else if (type == 1)
+    {
+      memcpy(data_ + out, endOfRecords, sizeof(endOfRecords));
+      out += sizeof(endOfRecords);
+      break;
+    }
+  }
+  dataLength_ = out;
+  return out > 0;
+}
+
+/*
+ * Find the records in the decoded data. Length includes the record header.
+ */
+bool LT_HexImage::split()
+{
+  pRecordHeaderLengthAndType record;
+  uint32_t offset = 0;
+  uint16_t length;
+
+  while (offset + sizeof(tRecordHeaderLengthAndType) <= dataLength_)
+  {
+    record = (pRecordHeaderLengthAndType) (data_ + offset);
+    length = record->Length;
+    if (record->RecordType == RECORD_TYPE_END_OF_RECORDS && length < sizeof(endOfRecords))
+      length = sizeof(endOfRecords);
+    if (length < sizeof(tRecordHeaderLengthAndType) || offset + length > dataLength_)
+      return false;
+
+    spans_[spanCnt_].offset = offset;
+    spans_[spanCnt_].length = length;
+    spans_[spanCnt_].type = record->RecordType;
+    spanCnt_++;
+    offset += length;
+    if (record->RecordType == RECORD_TYPE_END_OF_RECORDS)
+      break;
+  }
+  return spanCnt_ > 0;
+}
+
+/*
+ * 64 bit FNV-1a.
+ */
+uint64_t LT_HexImage::hash(const void *data, size_t length, uint64_t seed)
+{
+  const uint8_t *p = (const uint8_t *) data;
+  uint64_t h = seed;
+
+  while (length--)
+  {
+    h ^= *p++;
+    h *= 0x100000001b3ULL;
+  }
+  return h;
+}
+
+bool LT_HexImage::loadCached(const char *path)
+{
+  struct stat st;
+  char *cachePath;
+  void *map;
+  uint64_t sourceHash;
+  bool ok;
+  int fd;
+
+  if ((fd = open(path, O_RDONLY)) < 0)
+    return false;
+  if (fstat(fd, &st) < 0 || st.st_size == 0)
+  {
+    close(fd);
+    return false;
+  }
+  map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED)
+    return false;
+  madvise(map, st.st_size, MADV_SEQUENTIAL);
+
+  sourceHash = hash(map, st.st_size, HEX_IMAGE_HASH_SEED);
+  cachePath = (char *) malloc(strlen(path) + sizeof(HEX_IMAGE_CACHE_EXT));
+  strcpy(cachePath, path);
+  strcat(cachePath, HEX_IMAGE_CACHE_EXT);
+
+  release();
+  if ((ok = mapCache(cachePath, sourceHash)) == false)
+  {
+    ok = loadData((const char *) map, st.st_size);
+    // The cache is only an optimization, so failing to write it is not an error.
+    if (ok)
+      writeCache(cachePath, sourceHash);
+  }
+
+  free(cachePath);
+  munmap(map, st.st_size);
+  return ok;
+}
+
+/*
+ * Map a cache file and use it in place if it belongs to the source text and
+ * is intact.
+ */
+bool LT_HexImage::mapCache(const char *path, uint64_t sourceHash)
+{
+  CacheHeader *header;
+  struct stat st;
+  size_t spanBytes;
+  void *map;
+  int fd;
+
+  if ((fd = open(path, O_RDONLY)) < 0)
+    return false;
+  if (fstat(fd, &st) < 0 || (size_t) st.st_size < sizeof(CacheHeader))
+  {
+    close(fd);
+    return false;
+  }
+  map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED)
+    return false;
+
+  header = (CacheHeader *) map;
+  spanBytes = (size_t) header->spanCnt * sizeof(Span);
+  if (header->magic != CACHE_MAGIC
+      || header->version != CACHE_VERSION
+      || header->headerSize != sizeof(CacheHeader)
+      || header->sourceHash != sourceHash
+      || header->spanCnt == 0
+      || sizeof(CacheHeader) + spanBytes + header->dataLength != (size_t) st.st_size
+      || hash((uint8_t *) map + sizeof(CacheHeader), spanBytes + header->dataLength, HEX_IMAGE_HASH_SEED) != header->checksum)
+  {
+    munmap(map, st.st_size);
+    return false;
+  }
+
+  map_ = map;
+  mapLength_ = st.st_size;
+  spans_ = (Span *) ((uint8_t *) map + sizeof(CacheHeader));
+  spanCnt_ = header->spanCnt;
+  data_ = (uint8_t *) spans_ + spanBytes;
+  dataLength_ = header->dataLength;
+  return true;
+}
+
+/*
+ * Write the image with every record aligned, so records can be used in
+ * place from the mapping. The file is written under a temporary name and
+ * renamed, so a reader never sees a partial cache.
+ */
+bool LT_HexImage::writeCache(const char *path, uint64_t sourceHash)
+{
+  CacheHeader header;
+  Span *spans;
+  uint8_t *data;
+  uint32_t length = 0;
+  uint32_t i;
+  char *tmpPath;
+  FILE *fd;
+  bool ok;
+
+  for (i = 0; i < spanCnt_; i++)
+    length += (spans_[i].length + RECORD_ALIGN - 1) & ~(RECORD_ALIGN - 1);
+
+  spans = (Span *) malloc(spanCnt_ * sizeof(Span) + length);
+  if (spans == NULL)
+    return false;
+  data = (uint8_t *) (spans + spanCnt_);
+  memset(data, 0, length);
+  length = 0;
+  for (i = 0; i < spanCnt_; i++)
+  {
+    spans[i] = spans_[i];
+    spans[i].offset = length;
+    memcpy(data + length, data_ + spans_[i].offset, spans_[i].length);
+    length += (spans_[i].length + RECORD_ALIGN - 1) & ~(RECORD_ALIGN - 1);
+  }
+
+  header.magic = CACHE_MAGIC;
+  header.version = CACHE_VERSION;
+  header.headerSize = sizeof(CacheHeader);
+  header.sourceHash = sourceHash;
+  header.spanCnt = spanCnt_;
+  header.dataLength = length;
+  header.checksum = hash(spans, spanCnt_ * sizeof(Span) + length, HEX_IMAGE_HASH_SEED);
+
+  tmpPath = (char *) malloc(strlen(path) + 5);
+  sprintf(tmpPath, "%s.tmp", path);
+  ok = false;
+  if ((fd = fopen(tmpPath, "wb")) != NULL)
+  {
+    ok = fwrite(&header, sizeof(header), 1, fd) == 1
+         && fwrite(spans, spanCnt_ * sizeof(Span) + length, 1, fd) == 1;
+    ok = (fclose(fd) == 0) && ok;
+    if (ok)
+      ok = rename(tmpPath, path) == 0;
+    if (!ok)
+      unlink(tmpPath);
+  }
+
+  free(tmpPath);
+  free(spans);
+  return ok;
+}
@@ -0,0 +1,154 @@
+/*
+Copyright (c) 2020, Analog Devices Inc
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  * Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  * Neither the name of the Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived from this
+    software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LT_HexImage_H_
+#define LT_HexImage_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "record_type_definitions.h"
+
+//! Extension of the compiled image cache written next to a hex file.
+#define HEX_IMAGE_CACHE_EXT ".ltc"
+
+//! Starting value of LT_HexImage::hash().
+#define HEX_IMAGE_HASH_SEED 0xcbf29ce484222325ULL
+
+//! An ISP hex file decoded into LTC records.
+//! The file is mapped and decoded in one pass into a single allocation that
+//! holds the record bytes followed by the record spans. A decoded image can be
+//! kept in a binary cache next to the hex file, which is mapped as is.
+class LT_HexImage
+{
+  public:
+    struct Span
+    {
+      public:
+        uint32_t offset;    //!< offset of the record in the decoded data.
+        uint16_t length;    //!< bytes of the record in the decoded data.
+        uint16_t type;      //!< record type.
+    };
+
+  protected:
+    //! Layout of the cache file. Spans follow the header, and the data
+    //! follows the spans with each record aligned to RECORD_ALIGN bytes.
+    struct CacheHeader
+    {
+      public:
+        uint32_t magic;
+        uint16_t version;
+        uint16_t headerSize;
+        uint64_t sourceHash;    //!< hash of the hex text the cache was made from.
+        uint32_t spanCnt;
+        uint32_t dataLength;
+        uint64_t checksum;      //!< hash of the spans and data.
+    };
+
+    uint8_t *data_;
+    uint32_t dataLength_;
+    Span *spans_;
+    uint32_t spanCnt_;
+    void *map_;
+    size_t mapLength_;
+
+    bool decode(const char *text, size_t length);
+    bool split();
+    bool mapCache(const char *path, uint64_t sourceHash);
+    bool writeCache(const char *path, uint64_t sourceHash);
+
+  public:
+    LT_HexImage();
+    ~LT_HexImage();
+
+    //! Map a hex file and decode it.
+    //! @return true if the file was read and decoded.
+    bool load(const char *path    //!< path of the hex file.
+             );
+
+    //! Decode hex text already in memory.
+    //! @return true if the text was decoded.
+    bool loadData(const char *text,   //!< hex text, need not be terminated.
+                  size_t length       //!< length of the text.
+                 );
+
+    //! Load records that are already decoded, like the output of a pass
+    //! over another image.
+    //! @return true if the records were split.
+    bool loadRecords(const uint8_t *records, //!< records back to back.
+                     uint32_t length         //!< bytes of records.
+                    );
+
+    //! Load a hex file through its compiled cache. The cache is used when it
+    //! was made from the same hex text, otherwise the file is decoded and the
+    //! cache is written again.
+    //! @return true if the image was loaded.
+    bool loadCached(const char *path    //!< path of the hex file.
+                   );
+
+    //! Free the decoded image.
+    void release();
+
+    //! Hash used to key the cache.
+    static uint64_t hash(const void *data,  //!< data to hash.
+                         size_t length,     //!< length of the data.
+                         uint64_t seed      //!< hash to continue from, or HEX_IMAGE_HASH_SEED.
+                        );
+
+    //! Get the number of records.
+    uint32_t getRecordCount()
+    {
+      return spanCnt_;
+    }
+
+    //! Get a record span.
+    const Span *getSpan(uint32_t index //!< record index.
+                       )
+    {
+      return &spans_[index];
+    }
+
+    //! Get a record in place. Valid until the image is released.
+    pRecordHeaderLengthAndType getRecord(uint32_t index //!< record index.
+                                        )
+    {
+      return (pRecordHeaderLengthAndType) (data_ + spans_[index].offset);
+    }
+
+    //! Get the decoded record bytes.
+    const uint8_t *getData()
+    {
+      return data_;
+    }
+
+    //! Get the number of decoded record bytes.
+    uint32_t getLength()
+    {
+      return dataLength_;
+    }
+};
+
+#endif /* LT_HexImage_H_ */
@@ -0,0 +1,132 @@
+/*
+Copyright (c) 2020, Analog Devices Inc
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  * Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  * Neither the name of the Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived from this
+    software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "LT_IspArena.h"
+#ifdef DMALLOC
+#include <dmalloc.h>
+#else
+#include <stdlib.h>
+#endif
+
+#define ARENA_ALIGN 8
+
+static thread_local LT_IspArena *session = NULL;
+
+LT_IspArena::LT_IspArena(size_t chunkSize)
+{
+  chunks_ = NULL;
+  chunkSize_ = chunkSize;
+}
+
+LT_IspArena::~LT_IspArena()
+{
+  release();
+}
+
+void *LT_IspArena::alloc(size_t size)
+{
+  Chunk *chunk = chunks_;
+  uint8_t *p;
+
+  size = (size + ARENA_ALIGN - 1) & ~(size_t) (ARENA_ALIGN - 1);
+  if (chunk == NULL || chunk->size - chunk->used < size)
+  {
+    // Big requests get a chunk of their own.
+    size_t chunkSize = size > chunkSize_ ? size : chunkSize_;
+    if ((chunk = (Chunk *) malloc(sizeof(Chunk) + chunkSize)) == NULL)
+      return NULL;
+    chunk->size = chunkSize;
+    chunk->used = 0;
+    chunk->next = chunks_;
+    chunks_ = chunk;
+  }
+
+  p = (uint8_t *) (chunk + 1) + chunk->used;
+  chunk->used += size;
+  return p;
+}
+
+void LT_IspArena::reset()
+{
+  if (chunks_ == NULL)
+    return;
+
+  Chunk *keep = chunks_;
+  chunks_ = chunks_->next;
+  release();
+  keep->used = 0;
+  keep->next = NULL;
+  chunks_ = keep;
+}
+
+void LT_IspArena::release()
+{
+  Chunk *next;
+
+  while (chunks_ != NULL)
+  {
+    next = chunks_->next;
+    free(chunks_);
+    chunks_ = next;
+  }
+}
+
+size_t LT_IspArena::getUsed()
+{
+  size_t used = 0;
+  for (Chunk *chunk = chunks_; chunk != NULL; chunk = chunk->next)
+    used += chunk->used;
+  return used;
+}
+
+void ispBeginSession(LT_IspArena *arena)
+{
+  session = arena;
+}
+
+void ispEndSession()
+{
+  session = NULL;
+}
+
+void *ispAlloc(size_t size)
+{
+  if (session != NULL)
+    return session->alloc(size);
+  return malloc(size);
+}
+
+void ispFree(void *p)
+{
+  if (session == NULL)
+    free(p);
+}
+
+bool ispInSession()
+{
+  return session != NULL;
+}
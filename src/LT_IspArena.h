@@ -0,0 +1,84 @@
+/*
+Copyright (c) 2020, Analog Devices Inc
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  * Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  * Neither the name of the Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived from this
+    software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LT_IspArena_H_
+#define LT_IspArena_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+//! Default size of an arena chunk.
+#define ISP_ARENA_CHUNK 65536
+
+//! Bump allocator for one ISP session. Records and NVM buffers are carved
+//! out of large chunks and all released together when the session ends.
+class LT_IspArena
+{
+  protected:
+    struct Chunk
+    {
+      public:
+        Chunk *next;
+        size_t size;
+        size_t used;
+    };
+
+    Chunk *chunks_;
+    size_t chunkSize_;
+
+  public:
+    LT_IspArena(size_t chunkSize = ISP_ARENA_CHUNK //!< size of each chunk.
+               );
+    ~LT_IspArena();
+
+    //! Allocate memory aligned to 8 bytes. Never freed on its own.
+    //! @return memory or NULL
+    void *alloc(size_t size //!< bytes to allocate.
+               );
+
+    //! Forget all allocations, keeping the most recent chunk for reuse.
+    void reset();
+
+    //! Free all chunks.
+    void release();
+
+    //! Get the number of bytes allocated.
+    size_t getUsed();
+};
+
+//! Make an arena the owner of ISP records and buffers until ispEndSession.
+extern void ispBeginSession(LT_IspArena *arena);
+//! Return to malloc/free for ISP records and buffers.
+extern void ispEndSession();
+//! Allocate an ISP record or buffer from the session arena, or malloc without a session.
+extern void *ispAlloc(size_t size);
+//! Free an ISP record or buffer. Does nothing inside a session.
+extern void ispFree(void *p);
+//! Ask if a session is active.
+extern bool ispInSession();
+
+#endif /* LT_IspArena_H_ */
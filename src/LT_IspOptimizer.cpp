@@ -0,0 +1,389 @@
+/*
+Copyright (c) 2020, Analog Devices Inc
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  * Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  * Neither the name of the Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived from this
+    software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "LT_IspOptimizer.h"
+#include "LT_HexImage.h"
+#include "nvm_data_helpers.h"
+#include <stdio.h>
+#include <string.h>
+#ifdef DMALLOC
+#include <dmalloc.h>
+#else
+#include <stdlib.h>
+#endif
+
+#define NO_POLL 0xFFFFFFFF
+
+#define PAGE 0x00
+#define WRITE_PROTECT 0x10
+#define STORE_USER_ALL 0x15
+#define RESTORE_USER_ALL 0x16
+#define MFR_COMMON 0xEF
+#define MFR_COMMON_NOT_BUSY 0x40
+
+#define GLOBAL_ADDRESS_PAGED 0x5B
+#define GLOBAL_ADDRESS 0x5A
+
+/*
+ * Index of a command in Device::written, or -1 if it is not shadowed.
+ */
+static int shadowIndex(uint8_t command)
+{
+  if (command == PAGE)
+    return 0;
+  if (command == WRITE_PROTECT)
+    return 1;
+  return -1;
+}
+
+static bool isPoll(uint16_t type)
+{
+  switch (type)
+  {
+    case RECORD_TYPE_PMBUS_READ_BYTE_LOOP_MASK:
+    case RECORD_TYPE_PMBUS_READ_WORD_LOOP_MASK:
+    case RECORD_TYPE_PMBUS_READ_BYTE_LOOP_MASK_NOPEC:
+    case RECORD_TYPE_PMBUS_READ_WORD_LOOP_MASK_NOPEC:
+    case RECORD_TYPE_PMBUS_POLL_UNTIL_ACK_NOPEC:
+      return true;
+  }
+  return false;
+}
+
+/*
+ * Records that only read, so they leave the shadowed values alone.
+ */
+static bool isRead(uint16_t type)
+{
+  switch (type)
+  {
+    case RECORD_TYPE_PMBUS_READ_BYTE_EXPECT:
+    case RECORD_TYPE_PMBUS_READ_WORD_EXPECT:
+    case RECORD_TYPE_PMBUS_READ_BLOCK_EXPECT:
+    case RECORD_TYPE_PMBUS_READ_BYTE_EXPECT_NOPEC:
+    case RECORD_TYPE_PMBUS_READ_WORD_EXPECT_NOPEC:
+    case RECORD_TYPE_PMBUS_READ_BLOCK_EXPECT_NOPEC:
+    case RECORD_TYPE_PMBUS_READ_BYTE_EXPECT_MASK_NOPEC:
+    case RECORD_TYPE_PMBUS_READ_WORD_EXPECT_MASK_NOPEC:
+    case RECORD_TYPE_PMBUS_READ_AND_VERIFY_EE_DATA:
+      return true;
+  }
+  return false;
+}
+
+#define BUSY_AFTER_ACK 0x01
+#define BUSY_AFTER_STORE 0x02
+#define BUSY_AFTER_RESTORE 0x04
+
+/*
+ * The kind of a record after which a part reports busy until it is done, so
+ * a delay after it can wait on the busy bit instead, or 0 for other records.
+ */
+static uint8_t endsBusy(pRecordHeaderLengthAndType record)
+{
+  uint8_t command;
+
+  switch (record->RecordType)
+  {
+    case RECORD_TYPE_PMBUS_POLL_UNTIL_ACK_NOPEC:
+      return BUSY_AFTER_ACK;
+    case RECORD_TYPE_PMBUS_SEND_BYTE:
+    case RECORD_TYPE_PMBUS_SEND_BYTE_NOPEC:
+      command = ((t_RECORD_PMBUS_SEND_BYTE_NOPEC *) record)->detailedRecordHeader.CommandCode;
+      if (command == STORE_USER_ALL)
+        return BUSY_AFTER_STORE;
+      if (command == RESTORE_USER_ALL)
+        return BUSY_AFTER_RESTORE;
+  }
+  return 0;
+}
+
+/*
+ * A poll of MFR_COMMON until the part is not busy. The no PEC form has no
+ * UsePec byte, so its fields sit one byte earlier.
+ */
+static bool isBusyPoll(pRecordHeaderLengthAndType record, uint8_t *usePec)
+{
+  t_RECORD_PMBUS_READ_BYTE_LOOP_MASK *poll = (t_RECORD_PMBUS_READ_BYTE_LOOP_MASK *) record;
+  t_RECORD_PMBUS_READ_BYTE_LOOP_MASK_NOPEC *pollNoPec = (t_RECORD_PMBUS_READ_BYTE_LOOP_MASK_NOPEC *) record;
+
+  if (record->RecordType == RECORD_TYPE_PMBUS_READ_BYTE_LOOP_MASK)
+  {
+    *usePec = poll->detailedRecordHeader.UsePec;
+    return poll->detailedRecordHeader.CommandCode == MFR_COMMON
+           && poll->byteMask == MFR_COMMON_NOT_BUSY && poll->expectedDataByte == MFR_COMMON_NOT_BUSY;
+  }
+  if (record->RecordType == RECORD_TYPE_PMBUS_READ_BYTE_LOOP_MASK_NOPEC)
+  {
+    *usePec = 0;
+    return pollNoPec->detailedRecordHeader.CommandCode == MFR_COMMON
+           && pollNoPec->byteMask == MFR_COMMON_NOT_BUSY && pollNoPec->expectedDataByte == MFR_COMMON_NOT_BUSY;
+  }
+  return false;
+}
+
+LT_IspOptimizer::LT_IspOptimizer()
+{
+  memset(&report_, 0, sizeof(report_));
+  memset(devices_, 0, sizeof(devices_));
+  out_ = NULL;
+  outLength_ = 0;
+  last_ = 0;
+}
+
+void LT_IspOptimizer::forget(uint8_t address)
+{
+  Device *device = &devices_[address & 0x7F];
+
+  device->written[0] = device->written[1] = -1;
+  device->checked[0] = device->checked[1] = -1;
+  device->poll = NO_POLL;
+}
+
+void LT_IspOptimizer::forgetAll()
+{
+  int i;
+
+  for (i = 0; i < 128; i++)
+    forget(i);
+}
+
+void LT_IspOptimizer::emit(pRecordHeaderLengthAndType record, uint16_t length)
+{
+  memcpy(out_ + outLength_, record, length);
+  last_ = outLength_;
+  outLength_ += length;
+  report_.kept++;
+}
+
+void LT_IspOptimizer::optimizeRecord(pRecordHeaderLengthAndType record, uint16_t length)
+{
+  pRecordHeaderLengthAndType last = outLength_ > 0 ? (pRecordHeaderLengthAndType) (out_ + last_) : NULL;
+  t_RECORD_PMBUS_SEND_BYTE_NOPEC *addressed = (t_RECORD_PMBUS_SEND_BYTE_NOPEC *) record;
+  int16_t address;
+  uint8_t command;
+  Device *device;
+  int16_t value;
+  int shadow;
+
+  if (record->RecordType == RECORD_TYPE_DELAY_MS)
+  {
+    t_RECORD_DELAY_MS *delay = (t_RECORD_DELAY_MS *) record;
+
+    if (last != NULL && last->RecordType == RECORD_TYPE_DELAY_MS
+        && ((t_RECORD_DELAY_MS *) last)->numMs + delay->numMs <= 0xFFFF)
+    {
+      ((t_RECORD_DELAY_MS *) last)->numMs += delay->numMs;
+      report_.delays++;
+      return;
+    }
+    if (last != NULL && endsBusy(last))
+    {
+      address = ((t_RECORD_PMBUS_SEND_BYTE_NOPEC *) last)->detailedRecordHeader.DeviceAddress & 0x7F;
+      device = &devices_[address];
+      // Only where the image shows the busy bit is valid after this kind of record.
+      if (device->busyAfter & endsBusy(last))
+      {
+        t_RECORD_PMBUS_POLL_READ_BYTE_UNTIL_ACK ack;
+        t_RECORD_PMBUS_READ_BYTE_LOOP_MASK poll;
+
+        // A part writing its EEPROM may not acknowledge, and a busy poll
+        // gives up on a NACK, so wait for the acknowledge first.
+        if (last->RecordType != RECORD_TYPE_PMBUS_POLL_UNTIL_ACK_NOPEC)
+        {
+          ack.baseRecordHeader.Length = sizeof(ack);
+          ack.baseRecordHeader.RecordType = RECORD_TYPE_PMBUS_POLL_UNTIL_ACK_NOPEC;
+          ack.detailedRecordHeader.DeviceAddress = address;
+          ack.detailedRecordHeader.CommandCode = MFR_COMMON;
+          ack.timeout_in_ms = delay->numMs;
+          emit((pRecordHeaderLengthAndType) &ack, sizeof(ack));
+        }
+
+        poll.baseRecordHeader.Length = sizeof(poll);
+        poll.baseRecordHeader.RecordType = RECORD_TYPE_PMBUS_READ_BYTE_LOOP_MASK;
+        poll.detailedRecordHeader.DeviceAddress = address;
+        poll.detailedRecordHeader.CommandCode = MFR_COMMON;
+        poll.detailedRecordHeader.UsePec = device->busyPec;
+        poll.byteMask = MFR_COMMON_NOT_BUSY;
+        poll.expectedDataByte = MFR_COMMON_NOT_BUSY;
+        emit((pRecordHeaderLengthAndType) &poll, sizeof(poll));
+        device->poll = last_;
+        report_.busyPolls++;
+        report_.busyPollMs += delay->numMs;
+        return;
+      }
+    }
+    emit(record, length);
+    return;
+  }
+
+  // Records without a device mark a boundary the pass does not look across.
+  if ((address = nvmRecordAddress(record)) < 0)
+  {
+    forgetAll();
+    emit(record, length);
+    return;
+  }
+
+  command = addressed->detailedRecordHeader.CommandCode;
+  device = &devices_[address];
+  if (address == GLOBAL_ADDRESS || address == GLOBAL_ADDRESS_PAGED)
+  {
+    forgetAll();
+    emit(record, length);
+    return;
+  }
+
+  // NVM data is only buffered and does not touch the bus.
+  if (record->RecordType == RECORD_TYPE_NVM_DATA)
+  {
+    emit(record, length);
+    return;
+  }
+
+  if (isPoll(record->RecordType))
+  {
+    if (device->poll != NO_POLL && ((pRecordHeaderLengthAndType) (out_ + device->poll))->Length == record->Length
+        && memcmp(out_ + device->poll, record, length) == 0)
+    {
+      report_.polls++;
+      return;
+    }
+    emit(record, length);
+    device->poll = last_;
+    return;
+  }
+  device->poll = NO_POLL;
+
+  shadow = shadowIndex(command);
+  switch (record->RecordType)
+  {
+    case RECORD_TYPE_PMBUS_WRITE_BYTE:
+    case RECORD_TYPE_PMBUS_WRITE_BYTE_NOPEC:
+      if (shadow < 0)
+        break;
+      value = record->RecordType == RECORD_TYPE_PMBUS_WRITE_BYTE
+              ? ((t_RECORD_PMBUS_WRITE_BYTE *) record)->dataByte
+              : ((t_RECORD_PMBUS_WRITE_BYTE_NOPEC *) record)->dataByte;
+      if (device->written[shadow] == value)
+      {
+        report_.writes++;
+        return;
+      }
+      // A new page or protection can change what anything else reads.
+      forget(address);
+      device->written[shadow] = value;
+      emit(record, length);
+      return;
+    case RECORD_TYPE_PMBUS_READ_BYTE_EXPECT:
+    case RECORD_TYPE_PMBUS_READ_BYTE_EXPECT_NOPEC:
+      if (shadow < 0)
+        break;
+      value = record->RecordType == RECORD_TYPE_PMBUS_READ_BYTE_EXPECT
+              ? ((t_RECORD_PMBUS_READ_BYTE_EXPECT *) record)->expectedDataByte
+              : ((t_RECORD_PMBUS_READ_BYTE_EXPECT_NOPEC *) record)->expectedDataByte;
+      if (device->checked[shadow] == value)
+      {
+        report_.reads++;
+        return;
+      }
+      // Processing stops when a check fails, so after it the value is known.
+      device->written[shadow] = value;
+      device->checked[shadow] = value;
+      emit(record, length);
+      return;
+  }
+
+  if (!isRead(record->RecordType))
+    forget(address);
+  emit(record, length);
+}
+
+/*
+ * The first pass finds the kinds of record after which the image polls the
+ * busy bit of a device, and sizes the output for every delay becoming an
+ * acknowledge poll and a busy poll.
+ */
+bool LT_IspOptimizer::optimize(LT_HexImage *source, LT_HexImage *target)
+{
+  const LT_HexImage::Span *span;
+  pRecordHeaderLengthAndType record;
+  Device *device;
+  uint32_t capacity = 0;
+  int16_t address;
+  uint8_t usePec;
+  uint8_t kind;
+  uint32_t i;
+  bool ok;
+
+  memset(&report_, 0, sizeof(report_));
+  memset(devices_, 0, sizeof(devices_));
+  forgetAll();
+  outLength_ = 0;
+  last_ = 0;
+
+  report_.records = source->getRecordCount();
+  for (i = 0; i < report_.records; i++)
+  {
+    span = source->getSpan(i);
+    capacity += span->length;
+    if (span->type == RECORD_TYPE_DELAY_MS)
+      capacity += sizeof(t_RECORD_PMBUS_POLL_READ_BYTE_UNTIL_ACK) + sizeof(t_RECORD_PMBUS_READ_BYTE_LOOP_MASK);
+    record = source->getRecord(i);
+    if (span->type == RECORD_TYPE_DELAY_MS || (address = nvmRecordAddress(record)) < 0)
+      continue;
+    device = &devices_[address & 0x7F];
+    if (isBusyPoll(record, &usePec))
+    {
+      device->busyAfter |= device->busyPending;
+      device->busyPec = usePec;
+      device->busyPending = 0;
+    }
+    else if ((kind = endsBusy(record)) != 0)
+      device->busyPending |= kind;
+    else
+      device->busyPending = 0;
+  }
+
+  if ((out_ = (uint8_t *) malloc(capacity)) == NULL)
+    return false;
+  for (i = 0; i < report_.records; i++)
+    optimizeRecord(source->getRecord(i), source->getSpan(i)->length);
+
+  ok = target->loadRecords(out_, outLength_);
+  free(out_);
+  out_ = NULL;
+  return ok;
+}
+
+void LT_IspOptimizer::printReport()
+{
+  printf("ISP records kept %u of %u\n", report_.kept, report_.records);
+  printf("Dropped %u shadowed writes and %u repeated checks\n", report_.writes, report_.reads);
+  printf("Merged %u polls and %u delays\n", report_.polls, report_.delays);
+  printf("Replaced %u delays of %u ms with busy polls\n", report_.busyPolls, report_.busyPollMs);
+}
@@ -0,0 +1,103 @@
+/*
+Copyright (c) 2020, Analog Devices Inc
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  * Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  * Neither the name of the Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived from this
+    software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LT_IspOptimizer_H_
+#define LT_IspOptimizer_H_
+
+#include <stdint.h>
+#include "record_type_definitions.h"
+
+class LT_HexImage;
+
+//! A pass over a decoded ISP image that removes bus operations which cannot
+//! change the outcome. Writes that repeat a shadowed value are dropped, a
+//! poll that repeats the last poll of a device is dropped, back to back
+//! delays are merged, and a delay that waits for a part to finish is
+//! replaced with a poll until the part acknowledges followed by a poll of
+//! the MFR_COMMON busy bit, when the image itself polls the busy bit of that
+//! part after the same kind of record. All shadowed state is forgotten at
+//! events, so every verify section runs exactly as before.
+class LT_IspOptimizer
+{
+  public:
+    struct Report
+    {
+      public:
+        uint32_t records;         //!< records in the source image.
+        uint32_t kept;            //!< records in the optimized image.
+        uint32_t writes;          //!< writes dropped because the value was shadowed.
+        uint32_t reads;           //!< read checks dropped because the value was checked.
+        uint32_t polls;           //!< polls merged with the poll before them.
+        uint32_t delays;          //!< delays merged with the delay before them.
+        uint32_t busyPolls;       //!< delays replaced with busy polls.
+        uint32_t busyPollMs;      //!< ms of the replaced delays.
+    };
+
+  protected:
+    //! What is known about one device since the last event.
+    struct Device
+    {
+      public:
+        int16_t written[2];       //!< last value written or read of PAGE and WRITE_PROTECT, or -1.
+        int16_t checked[2];       //!< value a read check has seen since, or -1.
+        uint32_t poll;            //!< output offset of a poll with nothing after it, or NO_POLL.
+        uint8_t busyAfter;        //!< kinds of record after which the image polls the busy bit.
+        uint8_t busyPending;      //!< kinds of record since the last busy poll, while finding busyAfter.
+        uint8_t busyPec;          //!< the image polls it with PEC.
+    };
+
+    Device devices_[128];
+    Report report_;
+    uint8_t *out_;
+    uint32_t outLength_;
+    uint32_t last_;               //!< output offset of the last record.
+
+    void forget(uint8_t address);
+    void forgetAll();
+    void emit(pRecordHeaderLengthAndType record, uint16_t length);
+    void optimizeRecord(pRecordHeaderLengthAndType record, uint16_t length);
+
+  public:
+    LT_IspOptimizer();
+
+    //! Write an optimized copy of an image.
+    //! @return true if the optimized image was made.
+    bool optimize(LT_HexImage *source,  //!< decoded image.
+                  LT_HexImage *target   //!< image to receive the optimized records.
+                 );
+
+    //! Get what the last pass removed.
+    const Report *getReport()
+    {
+      return &report_;
+    }
+
+    //! Print what the last pass removed.
+    void printReport();
+};
+
+#endif /* LT_IspOptimizer_H_ */
@@ -0,0 +1,447 @@
+/*
+Copyright (c) 2020, Analog Devices Inc
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  * Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  * Neither the name of the Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived from this
+    software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "LT_IspScheduler.h"
+#include "LT_HexImage.h"
+#include "LT_Exception.h"
+#include "main_record_processor.h"
+#include "LT_Clock.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#ifdef DMALLOC
+#include <dmalloc.h>
+#else
+#include <stdlib.h>
+#endif
+
+#define ISP_BARRIER 0xFF
+#define ISP_NO_RECORD 0xFFFFFFFF
+
+#define GLOBAL_ADDRESS_PAGED 0x5B
+#define GLOBAL_ADDRESS 0x5A
+
+#define STEP_DONE 0
+#define STEP_WAIT 1
+#define STEP_FAIL 2
+
+/*
+ * One read of a loop mask record, without looping.
+ */
+static bool pollDone(pRecordHeaderLengthAndType record)
+{
+  t_RECORD_PMBUS_READ_BYTE_LOOP_MASK *byteRecord = (t_RECORD_PMBUS_READ_BYTE_LOOP_MASK *) record;
+  t_RECORD_PMBUS_READ_WORD_LOOP_MASK *wordRecord = (t_RECORD_PMBUS_READ_WORD_LOOP_MASK *) record;
+  t_RECORD_PMBUS_READ_BYTE_LOOP_MASK_NOPEC *byteNoPec = (t_RECORD_PMBUS_READ_BYTE_LOOP_MASK_NOPEC *) record;
+  t_RECORD_PMBUS_READ_WORD_LOOP_MASK_NOPEC *wordNoPec = (t_RECORD_PMBUS_READ_WORD_LOOP_MASK_NOPEC *) record;
+  LT_SMBus *smbus;
+  uint16_t value;
+
+  switch (record->RecordType)
+  {
+    case RECORD_TYPE_PMBUS_READ_BYTE_LOOP_MASK:
+      smbus = byteRecord->detailedRecordHeader.UsePec ? (LT_SMBus *) nvmSession->smbusPec : (LT_SMBus *) nvmSession->smbusNoPec;
+      value = smbus->readByte((uint8_t) byteRecord->detailedRecordHeader.DeviceAddress, byteRecord->detailedRecordHeader.CommandCode);
+      return (value & byteRecord->byteMask) == (byteRecord->expectedDataByte & byteRecord->byteMask);
+    case RECORD_TYPE_PMBUS_READ_WORD_LOOP_MASK:
+      smbus = wordRecord->detailedRecordHeader.UsePec ? (LT_SMBus *) nvmSession->smbusPec : (LT_SMBus *) nvmSession->smbusNoPec;
+      value = smbus->readWord((uint8_t) wordRecord->detailedRecordHeader.DeviceAddress, wordRecord->detailedRecordHeader.CommandCode);
+      return (value & wordRecord->wordMask) == (wordRecord->expectedDataWord & wordRecord->wordMask);
+    case RECORD_TYPE_PMBUS_READ_BYTE_LOOP_MASK_NOPEC:
+      value = nvmSession->smbusNoPec->readByte((uint8_t) byteNoPec->detailedRecordHeader.DeviceAddress, byteNoPec->detailedRecordHeader.CommandCode);
+      return (value & byteNoPec->byteMask) == (byteNoPec->expectedDataByte & byteNoPec->byteMask);
+    case RECORD_TYPE_PMBUS_READ_WORD_LOOP_MASK_NOPEC:
+      value = nvmSession->smbusNoPec->readWord((uint8_t) wordNoPec->detailedRecordHeader.DeviceAddress, wordNoPec->detailedRecordHeader.CommandCode);
+      return (value & wordNoPec->wordMask) == (wordNoPec->expectedDataWord & wordNoPec->wordMask);
+  }
+  return true;
+}
+
+/*
+ * One try of a poll until ack record. A part that is busy does not ack,
+ * which the transport reports with an exception.
+ */
+static bool ackDone(t_RECORD_PMBUS_POLL_READ_BYTE_UNTIL_ACK *record)
+{
+  try
+  {
+    nvmSession->smbusNoPec->readByte((uint8_t) record->detailedRecordHeader.DeviceAddress, record->detailedRecordHeader.CommandCode);
+  }
+  catch (LT_Exception &ex)
+  {
+    return false;
+  }
+  return true;
+}
+
+LT_IspScheduler::LT_IspScheduler()
+{
+  image_ = NULL;
+  lanes_ = NULL;
+  next_ = NULL;
+  base_ = NULL;
+  memset(sessions_, 0, sizeof(sessions_));
+}
+
+LT_IspScheduler::~LT_IspScheduler()
+{
+  release();
+}
+
+void LT_IspScheduler::release()
+{
+  int i;
+
+  // Never leave a lane session bound, even when a transport threw.
+  if (base_ != NULL)
+    nvmSession = base_;
+  for (i = 0; i < 128; i++)
+  {
+    if (sessions_[i] == NULL)
+      continue;
+    nvmSessionFree(sessions_[i]);
+    free(sessions_[i]);
+    sessions_[i] = NULL;
+  }
+  free(lanes_);
+  free(next_);
+  lanes_ = NULL;
+  next_ = NULL;
+}
+
+/*
+ * Give every record a lane, then link the records of each lane up to the
+ * next barrier.
+ */
+bool LT_IspScheduler::plan()
+{
+  uint32_t count = image_->getRecordCount();
+  uint32_t last[128];
+  pRecordHeaderLengthAndType record;
+  uint16_t eventId;
+  int16_t address;
+  uint32_t i, j;
+
+  lanes_ = (uint8_t *) malloc(count);
+  next_ = (uint32_t *) malloc(count * sizeof(uint32_t));
+  if (lanes_ == NULL || next_ == NULL)
+    return false;
+
+  for (i = 0; i < count; i++)
+  {
+    record = image_->getRecord(i);
+    lanes_[i] = ISP_BARRIER;
+    if ((address = nvmRecordAddress(record)) >= 0)
+    {
+      if (address != GLOBAL_ADDRESS && address != GLOBAL_ADDRESS_PAGED)
+        lanes_[i] = address;
+    }
+    else if (record->RecordType == RECORD_TYPE_DELAY_MS)
+    {
+      if (i > 0)
+        lanes_[i] = lanes_[i - 1];
+    }
+    else if (record->RecordType == RECORD_TYPE_EVENT)
+    {
+      eventId = ((t_RECORD_EVENT *) record)->eventId;
+      if (eventId == INSYSTEM_CHIP_BEFORE_PROGRAM || eventId == INSYSTEM_CHIP_BEFORE_VERIFY)
+      {
+        // Opens the section of the next chip.
+        for (j = i + 1; j < count; j++)
+        {
+          record = image_->getRecord(j);
+          if (record->RecordType == RECORD_TYPE_EVENT && ((t_RECORD_EVENT *) record)->eventId >= INSYSTEM_CHIP_BEFORE_PROGRAM)
+            break;
+          address = nvmRecordAddress(record);
+          if (address >= 0 && address != GLOBAL_ADDRESS && address != GLOBAL_ADDRESS_PAGED)
+          {
+            lanes_[i] = address;
+            break;
+          }
+        }
+      }
+      else if (eventId == INSYSTEM_CHIP_AFTER_VERIFY || eventId == INSYSTEM_CHIP_AFTER_PROGRAM)
+      {
+        // Closes the section of the last chip.
+        for (j = i; j-- > 0;)
+        {
+          record = image_->getRecord(j);
+          if (record->RecordType == RECORD_TYPE_EVENT && ((t_RECORD_EVENT *) record)->eventId >= INSYSTEM_CHIP_BEFORE_PROGRAM)
+            break;
+          address = nvmRecordAddress(record);
+          if (address >= 0 && address != GLOBAL_ADDRESS && address != GLOBAL_ADDRESS_PAGED)
+          {
+            lanes_[i] = address;
+            break;
+          }
+        }
+      }
+    }
+  }
+
+  for (j = 0; j < 128; j++)
+    last[j] = ISP_NO_RECORD;
+  for (i = count; i-- > 0;)
+  {
+    next_[i] = ISP_NO_RECORD;
+    if (lanes_[i] == ISP_BARRIER)
+    {
+      for (j = 0; j < 128; j++)
+        last[j] = ISP_NO_RECORD;
+      continue;
+    }
+    next_[i] = last[lanes_[i]];
+    last[lanes_[i]] = i;
+  }
+  return true;
+}
+
+/*
+ * Each device gets its own session, so the NVM data it buffers and the
+ * commit time it learns are its own.
+ */
+tNvmSession *LT_IspScheduler::getSession(uint8_t address)
+{
+  tNvmSession *session = sessions_[address];
+
+  if (session != NULL)
+    return session;
+  if ((session = (tNvmSession *) malloc(sizeof(tNvmSession))) == NULL)
+    return NULL;
+  nvmSessionInit(session, base_->pmbus, base_->smbusNoPec, base_->smbusPec);
+  session->image = base_->image;
+  session->nvmDifferential = base_->nvmDifferential;
+  memcpy(session->nvmSeen, base_->nvmSeen, sizeof(session->nvmSeen));
+  memcpy(session->nvmDirty, base_->nvmDirty, sizeof(session->nvmDirty));
+  session->nvmCommitUs = base_->nvmCommitUs;
+  session->nvmReadUs = base_->nvmReadUs;
+  sessions_[address] = session;
+  return session;
+}
+
+/*
+ * Run the current record of a lane as far as it goes without waiting.
+ * Delays, polls and NVM commits set when the lane may go on instead of
+ * blocking the bus; everything else runs through processRecord().
+ */
+int LT_IspScheduler::step(Lane *lane, uint64_t now)
+{
+  pRecordHeaderLengthAndType record = image_->getRecord(lane->record);
+  t_RECORD_NVM_DATA *nvmRecord = (t_RECORD_NVM_DATA *) record;
+  t_RECORD_PMBUS_POLL_READ_BYTE_UNTIL_ACK *ackRecord = (t_RECORD_PMBUS_POLL_READ_BYTE_UNTIL_ACK *) record;
+
+  nvmSession = lane->session;
+  if (!lane->started)
+  {
+    lane->started = true;
+    lane->start = now;
+    lane->word = 0;
+    lane->writing = false;
+    lane->first = true;
+    if (nvmSkipRecord(record))
+      return STEP_DONE;
+    if (record->RecordType == RECORD_TYPE_DELAY_MS)
+    {
+      lane->readyAt = now + ((t_RECORD_DELAY_MS *) record)->numMs * 1000ULL;
+      return STEP_WAIT;
+    }
+  }
+
+  switch (record->RecordType)
+  {
+    case RECORD_TYPE_DELAY_MS:
+      return STEP_DONE;
+    case RECORD_TYPE_PMBUS_READ_BYTE_LOOP_MASK:
+    case RECORD_TYPE_PMBUS_READ_WORD_LOOP_MASK:
+    case RECORD_TYPE_PMBUS_READ_BYTE_LOOP_MASK_NOPEC:
+    case RECORD_TYPE_PMBUS_READ_WORD_LOOP_MASK_NOPEC:
+      if (pollDone(record))
+        return STEP_DONE;
+      lane->readyAt = now + ISP_POLL_US;
+      return STEP_WAIT;
+    case RECORD_TYPE_PMBUS_POLL_UNTIL_ACK_NOPEC:
+      if (ackDone(ackRecord))
+        return STEP_DONE;
+      if (ackRecord->timeout_in_ms != 0 && now - lane->start > ackRecord->timeout_in_ms * 1000ULL)
+      {
+        printf("No ack from 0x%02x in %u ms\n", ackRecord->detailedRecordHeader.DeviceAddress, ackRecord->timeout_in_ms);
+        return STEP_FAIL;
+      }
+      lane->readyAt = now + ISP_POLL_US;
+      return STEP_WAIT;
+    case RECORD_TYPE_PMBUS_WRITE_EE_DATA:
+      if (lane->word == 0 && !lane->writing)
+      {
+        if (nvmSession->nWords == 0)
+          return STEP_DONE;
+        nvmSession->nvram_empty = 0;
+        nvmSession->nvram_somethingToVerify = 1;
+      }
+      if (lane->writing)
+      {
+        if (!nvmReady(nvmRecord))
+        {
+          lane->first = false;
+          lane->readyAt = now + ISP_POLL_US;
+          return STEP_WAIT;
+        }
+        nvmLearnReady(&nvmSession->nvmCommitUs, now - lane->start, lane->first);
+        lane->writing = false;
+        if (++lane->word >= nvmSession->nWords)
+          return STEP_DONE;
+      }
+      lane->start = LT_Clock::nowUs();
+      lane->first = true;
+      writeNvmWord(nvmRecord, lane->word);
+      lane->writing = true;
+      lane->readyAt = lane->start + nvmSession->nvmCommitUs;
+      return STEP_WAIT;
+  }
+
+  return processRecord(record) == SUCCESS ? STEP_DONE : STEP_FAIL;
+}
+
+/*
+ * Run the lanes of the records from first up to the next barrier. Each
+ * pass gives every ready lane one step, and when none is ready the bus is
+ * idle until the first one will be.
+ */
+bool LT_IspScheduler::runLanes(uint32_t first, uint32_t end)
+{
+  Lane lanes[128];
+  bool seen[128];
+  uint64_t now;
+  uint64_t wake;
+  int active = 0;
+  int count = 0;
+  int result;
+  uint32_t i;
+  int l;
+
+  memset(seen, 0, sizeof(seen));
+  for (i = first; i < end; i++)
+  {
+    if (seen[lanes_[i]])
+      continue;
+    seen[lanes_[i]] = true;
+    memset(&lanes[count], 0, sizeof(Lane));
+    lanes[count].record = i;
+    if ((lanes[count].session = getSession(lanes_[i])) == NULL)
+      return false;
+    count++;
+  }
+
+  active = count;
+  while (active > 0)
+  {
+    now = LT_Clock::nowUs();
+    for (l = 0; l < count; l++)
+    {
+      if (lanes[l].record == ISP_NO_RECORD || lanes[l].readyAt > now)
+        continue;
+      result = step(&lanes[l], now);
+      if (result == STEP_FAIL)
+        return false;
+      if (result == STEP_DONE)
+      {
+        lanes[l].record = next_[lanes[l].record];
+        lanes[l].started = false;
+        lanes[l].readyAt = 0;
+        if (lanes[l].record == ISP_NO_RECORD)
+          active--;
+      }
+      now = LT_Clock::nowUs();
+    }
+
+    wake = ~0ULL;
+    for (l = 0; l < count; l++)
+      if (lanes[l].record != ISP_NO_RECORD && lanes[l].readyAt < wake)
+        wake = lanes[l].readyAt;
+    now = LT_Clock::nowUs();
+    if (active > 0 && wake > now)
+      usleep(wake - now);
+  }
+  return true;
+}
+
+bool LT_IspScheduler::run(LT_HexImage *image, tNvmSession *session)
+{
+  pRecordHeaderLengthAndType record;
+  uint32_t count = image->getRecordCount();
+  uint64_t start = LT_Clock::nowUs();
+  uint32_t words = session->nvmWordsWritten;
+  uint32_t i, end;
+  bool ok = true;
+  uint32_t m;
+  int l;
+
+  image_ = image;
+  base_ = session;
+  if (!plan())
+  {
+    release();
+    return false;
+  }
+
+  for (i = 0; ok && i < count; i = end)
+  {
+    if (lanes_[i] == ISP_BARRIER)
+    {
+      record = image_->getRecord(i);
+      if (record->RecordType == RECORD_TYPE_END_OF_RECORDS)
+        break;
+      nvmSession = base_;
+      ok = processRecord(record) == SUCCESS;
+      end = i + 1;
+      continue;
+    }
+    for (end = i; end < count && lanes_[end] != ISP_BARRIER; end++)
+      ;
+    ok = runLanes(i, end);
+  }
+  nvmSession = base_;
+
+  // Lanes overlap, so the write time is the time of the whole run.
+  for (l = 0; l < 128; l++)
+  {
+    if (sessions_[l] == NULL)
+      continue;
+    session->nvmWordsWritten += sessions_[l]->nvmWordsWritten;
+    session->nvmWordsRead += sessions_[l]->nvmWordsRead;
+    session->nvmBusyPolls += sessions_[l]->nvmBusyPolls;
+    session->nvmReadTimeUs += sessions_[l]->nvmReadTimeUs;
+    if (sessions_[l]->nvmCommitUs > session->nvmCommitUs)
+      session->nvmCommitUs = sessions_[l]->nvmCommitUs;
+    for (m = 0; m < sessions_[l]->nvmMismatchCount; m++)
+      nvmMismatchAdd(session, &sessions_[l]->nvmMismatches[m]);
+  }
+  if (session->nvmWordsWritten > words)
+    session->nvmWriteTimeUs += LT_Clock::nowUs() - start;
+
+  release();
+  return ok;
+}
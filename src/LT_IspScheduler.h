@@ -0,0 +1,87 @@
+/*
+Copyright (c) 2020, Analog Devices Inc
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  * Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  * Neither the name of the Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived from this
+    software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LT_IspScheduler_H_
+#define LT_IspScheduler_H_
+
+#include <stdint.h>
+#include "nvm_data_helpers.h"
+
+class LT_HexImage;
+
+//! Interval between polls of a part that is not ready yet.
+#define ISP_POLL_US 100
+
+//! Runs the records of a multi-device image in per-device lanes, so that
+//! while one device waits for a delay, a poll or an NVM commit, the bus is
+//! used for the others. Records to one device keep their order. Records
+//! without a device, global addresses and system events are barriers that
+//! run alone once every lane before them is done. A chip event belongs to
+//! the lane of the chip it opens or closes, and a delay to the lane of the
+//! record before it.
+class LT_IspScheduler
+{
+  protected:
+    //! A device lane within the records between two barriers.
+    struct Lane
+    {
+      public:
+        uint32_t record;          //!< current record, or ISP_NO_RECORD when done.
+        uint64_t readyAt;         //!< time the lane may run again.
+        uint64_t start;           //!< time the current wait began.
+        uint16_t word;            //!< next NVM word of a write record.
+        bool started;             //!< the current record has begun.
+        bool writing;             //!< an NVM word was written and is committing.
+        bool first;               //!< the next poll is the first for this wait.
+        tNvmSession *session;     //!< state of the device the lane runs.
+    };
+
+    LT_HexImage *image_;
+    uint8_t *lanes_;              //!< lane of each record, or ISP_BARRIER.
+    uint32_t *next_;              //!< next record of the same lane, or ISP_NO_RECORD.
+    tNvmSession *sessions_[128];
+    tNvmSession *base_;
+
+    bool plan();
+    tNvmSession *getSession(uint8_t address);
+    int step(Lane *lane, uint64_t now);
+    bool runLanes(uint32_t first, uint32_t end);
+    void release();
+
+  public:
+    LT_IspScheduler();
+    ~LT_IspScheduler();
+
+    //! Program an image with the records of different devices interleaved.
+    //! Must run inside an ISP arena session, as records are used in place.
+    //! @return true if all records were processed.
+    bool run(LT_HexImage *image,    //!< decoded image.
+             tNvmSession *session   //!< session with the transports, which gets the statistics.
+            );
+};
+
+#endif /* LT_IspScheduler_H_ */
@@ -26,199 +26,152 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "LT_Nvm.h"
+#include "LT_HexImage.h"
+#include "LT_IspArena.h"
+#include "LT_IspOptimizer.h"
+#include "LT_IspScheduler.h"
 #include <stdio.h>
+#include <string.h>
     
-const char *icpData;
-uint16_t flashLocation = 0;
+// Legacy record source used by get_record(), one per thread.
+thread_local const char *icpData;
+thread_local uint16_t flashLocation = 0;
 
+NVM::NVM(LT_PMBus *pmbus, LT_SMBusNoPec *smbusNoPec, LT_SMBusPec *smbusPec)
+{
+  ownPmbus_ = NULL;
+  ownSmbusNoPec_ = NULL;
+  ownSmbusPec_ = NULL;
+  optimize_ = false;
+  schedule_ = false;
+  nvmSessionInit(&session_, pmbus, smbusNoPec, smbusPec);
+}
 
-LT_PMBus *pmbus__;
-LT_SMBusNoPec *smbusNoPec__;
-LT_SMBusPec *smbusPec__;
+NVM::NVM(char *dev)
+{
+  ownSmbusNoPec_ = new LT_SMBusNoPec(dev);
+  ownSmbusPec_ = new LT_SMBusPec(dev);
+  ownPmbus_ = new LT_PMBus(ownSmbusNoPec_);
+  optimize_ = false;
+  schedule_ = false;
+  nvmSessionInit(&session_, ownPmbus_, ownSmbusNoPec_, ownSmbusPec_);
+}
 
-NVM::NVM(LT_PMBus *pmbus, LT_SMBusNoPec *smbusNoPec, LT_SMBusPec *smbusPec)
+NVM::~NVM()
 {
-  pmbus__ = pmbus;
-  smbusNoPec__ = smbusNoPec;
-  smbusPec__ = smbusPec;
+  nvmSessionFree(&session_);
+  delete ownPmbus_;
+  delete ownSmbusPec_;
+  delete ownSmbusNoPec_;
 }
 
-bool NVM::programWithData(const char *data)
+/*
+ * Records of the image of the session bound to this thread. Inside an ISP
+ * arena session the records are used in place, since nothing is released
+ * until it ends. Otherwise the record processor frees each record it is
+ * given, so get_image_record() hands out copies.
+ */
+pRecordHeaderLengthAndType get_image_record(void)
 {
-  icpData = data;
-  flashLocation = 0;
+  const LT_HexImage::Span *span;
+  LT_HexImage *image;
+  uint8_t *record;
 
-  reset_parse_hex();
-  if (processRecordsOnDemand(get_record) == 0)
-  {
-    reset_parse_hex();
-    return 0;
-  }
-  reset_parse_hex();
+  if (nvmSession == NULL || (image = nvmSession->image) == NULL
+      || nvmSession->imageRecord >= image->getRecordCount())
+    return NULL;
 
-  return 1;
+  if (ispInSession())
+    return image->getRecord(nvmSession->imageRecord++);
+
+  span = image->getSpan(nvmSession->imageRecord++);
+  if ((record = (uint8_t *) ispAlloc(span->length + sizeof(tRecordHeaderLengthAndType))) == NULL)
+    return NULL;
+  memcpy(record, image->getData() + span->offset, span->length);
+  return (pRecordHeaderLengthAndType) record;
 }
 
-bool NVM::verifyWithData(const char *data)
+/*
+ * Run the records of an image with this session bound to the calling
+ * thread. Sessions on other threads are not affected.
+ */
+bool NVM::process(LT_HexImage *image, bool verify)
 {
-  icpData = data;
-  flashLocation = 0;
+  tNvmSession *previous = nvmSession;
+  LT_IspOptimizer optimizer;
+  LT_IspScheduler scheduler;
+  LT_HexImage optimized;
+  LT_IspArena arena;
+  uint8_t result;
 
-  reset_parse_hex();
-  if (verifyRecordsOnDemand(get_record) == 0)
+  if (optimize_ && optimizer.optimize(image, &optimized))
   {
-    reset_parse_hex();
-    return 0;
+    optimizer.printReport();
+    image = &optimized;
   }
-  reset_parse_hex();
 
-  return 1;
+  nvmSessionReset(&session_);
+  session_.image = image;
+  nvmSession = &session_;
+  ispBeginSession(&arena);
+  if (verify)
+    result = verifyRecordsOnDemand(get_image_record);
+  else if (schedule_)
+    result = scheduler.run(image, &session_);
+  else
+    result = processRecordsOnDemand(get_image_record);
+  ispEndSession();
+  session_.image = NULL;
+  nvmSession = previous;
+
+  return result != 0;
 }
 
-char *readFileData(const char *path)
+bool NVM::programWithData(const char *data)
 {
-  char ch[2];
-  char *chp;
-  char *line = NULL;
-  int dlen = 0;
-  char *data = NULL;
-  size_t n = 0;
-  void *r;
-  int len = 0;
-  ssize_t result;
-  const char *mode = "r";
-  FILE *fd = fopen(path, mode);
+  LT_HexImage hexImage;
 
-  if (NULL != fd)
-  {
-    while(1)
-    {
-      while (1)
-      {
-        chp = fgets(ch, 2, fd);
-        if (NULL == chp)
-        {
-          break;
-        }
-        else if (':' == ch[0])
-        {
-          break;
-        }
-      }
-      if (NULL == chp)
-        break;
-      result = getline(&line, &n, fd);
-      if (result > 0)
-      {
-        line[result-1] = '\0'; // Remove \n
-        if (len + result - 1 > dlen)
-        {
-          dlen += result;
-          if ((r = realloc(data, dlen)) <= 0)
-          {
-            printf("Can't allocate memory");
-            if (r != NULL)
-              free(r);
-            else
-              free(data);
-
-            free(line);
-            return NULL;
-          }
-          else 
-          {
-            data = (char *)r;
-          }
-        }
-        memcpy(data + len, ":", 1);
-        memcpy(data + len + 1, line, result-1);
-        free(line);
-        line = NULL;
-        len += result;
-      }
-    }
-    fclose(fd);
-
-    dlen += 1;
-    if ((r = realloc(data, dlen + 1)) <= 0)
-    {
-      if (r != NULL)
-        free(r);
-      else
-        free(data);
-
-      printf("Can't allocate memory");
-      return 0;
-    }
-    else
-      data = (char *)r;
-    data[dlen-1] = '\0';
-
-    return data;
-  }
-  else
-  {
-    return NULL;
-  }
+  if (!hexImage.loadData(data, strlen(data)))
+    return 0;
+  return process(&hexImage, false);
+}
+
+bool NVM::verifyWithData(const char *data)
+{
+  LT_HexImage hexImage;
+
+  if (!hexImage.loadData(data, strlen(data)))
+    return 0;
+  return process(&hexImage, true);
 }
 
 bool NVM::programWithFileData(const char *path)
 {
-  char *data;
-  if ((data = readFileData(path)) != NULL)
+  LT_HexImage hexImage;
+
+  if (!hexImage.loadCached(path))
   {
-    icpData = data;
-    flashLocation = 0;
-
-    reset_parse_hex();
-    if (processRecordsOnDemand(get_record) == 0)
-    {
-      printf("Error parsing\n");
-      reset_parse_hex();
-      free(data);
-      icpData = NULL;
-      return 0;
-    }
-    reset_parse_hex();
-
-    free(data);
-    icpData = NULL;
-    return 1;
+    printf("Can't open: %s", path);
+    return 0;
   }
-  else
+  if (!process(&hexImage, false))
   {
-    printf("Can't open: %s", path);
+    printf("Error parsing\n");
     return 0;
   }
+  return 1;
 }
 
 bool NVM::verifyWithFileData(const char *path)
 {
-  char *data;
-  if ((data = readFileData(path)) != NULL)
-  {
-    icpData = data;
-    flashLocation = 0;
-
-    reset_parse_hex();
-    if (verifyRecordsOnDemand(get_record) == 0)
-    {
-      reset_parse_hex();
-      free(data);
-      icpData = NULL;
-      return 0;
-    }
-    reset_parse_hex();
-
-    free(data);
-    icpData = NULL;
-    return 1;
-  }
-  else
+  LT_HexImage hexImage;
+
+  if (!hexImage.loadCached(path))
   {
     printf("Can't open: %s", path);
     return 0;
   }
+  return process(&hexImage, true);
 }
 
 uint8_t get_hex_data(void)
@@ -248,3 +201,77 @@ pRecordHeaderLengthAndType get_record(void)
 {
   return parse_record(get_record_data);
 }
+
+/*
+ * Read back the NVM of every device in the image and compare it, then
+ * program only the chips that differ. A scan that cannot complete falls
+ * back to programming everything.
+ *
+ * The unit of work is a device, not a block: the image erases the whole
+ * EEPROM with MFR_EE_ERASE, and MFR_EE_DATA is a stream that MFR_EE_UNLOCK
+ * restarts at word 0, so a single block cannot be rewritten on its own.
+ */
+bool NVM::programChanged(LT_HexImage *image)
+{
+  uint8_t seen = 0;
+  uint8_t dirty = 0;
+  bool scanned;
+  bool result;
+  int i;
+
+  memset(session_.nvmSeen, 0, sizeof(session_.nvmSeen));
+  memset(session_.nvmDirty, 0, sizeof(session_.nvmDirty));
+  session_.nvmScan = true;
+  scanned = process(image, true);
+  session_.nvmScan = false;
+
+  for (i = 0; i < 128; i++)
+  {
+    if (session_.nvmSeen[i >> 3] & (1 << (i & 7)))
+      seen++;
+    if (session_.nvmDirty[i >> 3] & (1 << (i & 7)))
+      dirty++;
+  }
+  if (scanned)
+    printf("NVM differs on %d of %d devices\n", dirty, seen);
+  else
+    printf("NVM scan failed, programming all devices\n");
+  if (scanned && dirty == 0)
+    return 1;
+
+  session_.nvmDifferential = scanned;
+  result = process(image, false);
+  session_.nvmDifferential = false;
+  return result;
+}
+
+bool NVM::programChangedWithData(const char *data)
+{
+  LT_HexImage hexImage;
+
+  if (!hexImage.loadData(data, strlen(data)))
+    return 0;
+  return programChanged(&hexImage);
+}
+
+bool NVM::programChangedWithFileData(const char *path)
+{
+  LT_HexImage hexImage;
+
+  if (!hexImage.loadCached(path))
+  {
+    printf("Can't open: %s", path);
+    return 0;
+  }
+  return programChanged(&hexImage);
+}
+
+void NVM::printThroughput()
+{
+  nvmSessionPrintThroughput(&session_);
+}
+
+void NVM::printMismatches()
+{
+  nvmSessionPrintMismatches(&session_);
+}
@@ -37,9 +37,6 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "hex_file_parser.h"
 
 
-extern LT_PMBus *pmbus__;         //!< global accessor for IFU helper files
-extern LT_SMBusNoPec *smbusNoPec__;   //!< global accessor for IFU helper files
-extern LT_SMBusPec *smbusPec__;     //!< global accessor for IFU helper files
 
 
 // extern uint8_t get_hex_data(void);
@@ -50,12 +47,27 @@ extern uint8_t get_hex_data(void);
 extern uint8_t get_record_data(void);
 //! Data retrieving method.
 extern pRecordHeaderLengthAndType get_record(void);
+//! Record retrieving method for decoded hex images.
+extern pRecordHeaderLengthAndType get_image_record(void);
 
+class LT_HexImage;
+
+//! An NVM programming session. All state of the IFU helper files lives in the
+//! session, so sessions on different threads and buses can run at once.
 class NVM
 {
   private:
     uint8_t *addr;
     uint8_t numAddrs;
+    tNvmSession session_;
+    LT_PMBus *ownPmbus_;
+    LT_SMBusNoPec *ownSmbusNoPec_;
+    LT_SMBusPec *ownSmbusPec_;
+    bool optimize_;
+    bool schedule_;
+
+    bool process(LT_HexImage *image, bool verify);
+    bool programChanged(LT_HexImage *image);
 
   public:
     //! Constructor.
@@ -64,6 +76,12 @@ class NVM
         LT_SMBusPec *       //!< reference to pec smbus object
        );
 
+    //! Constructor for a session with its own transports.
+    NVM(char *dev           //!< i2c device of the bus to program, like /dev/i2c-1
+       );
+
+    ~NVM();
+
     //! Program with hex data.
     //! @return true if data loaded.
     bool programWithData(const char * //!< array of hex data
@@ -82,6 +100,38 @@ class NVM
     //! @return true if NVM configuration matches the hex data.
     bool verifyWithFileData(const char *);
 
+    //! Program only the devices whose NVM differs from the hex data.
+    //! A device is rewritten whole, since its NVM is erased as a whole with MFR_EE_ERASE.
+    //! @return true if data loaded.
+    bool programChangedWithData(const char * //!< array of hex data
+                               );
+
+    //! Program only the devices whose NVM differs from the hex file data.
+    //! @return true if data loaded.
+    bool programChangedWithFileData(const char * //!< path of the hex file
+                                   );
+
+    //! Run images through LT_IspOptimizer before programming or verifying.
+    void setOptimize(bool optimize  //!< true to optimize.
+                    )
+    {
+      optimize_ = optimize;
+    }
+
+    //! Program with LT_IspScheduler, which interleaves the records of
+    //! different devices. Verify still runs in record order.
+    void setSchedule(bool schedule  //!< true to schedule.
+                    )
+    {
+      schedule_ = schedule;
+    }
+
+    //! Print the NVM words per second of the last program or verify.
+    void printThroughput();
+
+    //! Print the NVM blocks that did not verify in the last program or verify.
+    void printMismatches();
+
 };
 
 #endif /* NVM_H_ */
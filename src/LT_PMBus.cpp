@@ -27,6 +27,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <stdint.h>
 #include "LT_PMBus.h"
+#include "LT_StoreCoordinator.h"
     
 #undef F
 #define F(s) s
@@ -59,6 +60,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 LT_PMBus::LT_PMBus (LT_SMBus *smbus)
 {
   smbus_ = new LT_SMBusGroup(smbus, smbus->getSpeed());
+  store_ = NULL;
 }
 
 LT_PMBus::~LT_PMBus ()
@@ -2612,6 +2614,9 @@ void LT_PMBus::setMfrWatchdog(uint8_t address, float delay)
  */
 void LT_PMBus::restoreFromNvm(uint8_t address)
 {
+  // A pending store would be lost to the restore, so it is made first.
+  if (store_ != NULL)
+    store_->flush(&address, 1, true);
   smbus_->sendByte(address, RESTORE_USER_ALL);
 }
 
@@ -2623,6 +2628,8 @@ void LT_PMBus::restoreFromNvm(uint8_t address)
 void LT_PMBus::restoreFromNvmAll(uint8_t *addresses, uint8_t no_addresses)
 {
   uint8_t index;
+  if (store_ != NULL)
+    store_->flush(addresses, no_addresses, true);
   for (index = 0; index < no_addresses; index++)
     smbus_->sendByte(addresses[index], RESTORE_USER_ALL);
 }
@@ -2632,19 +2639,24 @@ void LT_PMBus::restoreFromNvmAll(uint8_t *addresses, uint8_t no_addresses)
  */
 void LT_PMBus::restoreFromNvmGlobal()
 {
+  if (store_ != NULL)
+    store_->flush(true);
   smbus_->sendByte(0x5B, RESTORE_USER_ALL);
 }
 
 void LT_PMBus::storeToNvm(uint8_t address)
 {
-  smbus_->sendByte(address, STORE_USER_ALL);
+  if (store_ != NULL)
+    store_->markDirty(address);
+  else
+    smbus_->sendByte(address, STORE_USER_ALL);
 }
 
 void LT_PMBus::storeToNvmAll(uint8_t *addresses, uint8_t no_addresses)
 {
   uint8_t index;
   for (index = 0; index < no_addresses; index++)
-    smbus_->sendByte(addresses[index], STORE_USER_ALL);
+    storeToNvm(addresses[index]);
 }
 
 void LT_PMBus::storeToNvmGlobal()
@@ -3409,7 +3421,7 @@ uint16_t LT_PMBus::Float_to_L16_mode(uint8_t vout_mode, float input_val)
   if (exponent > 0x0F) exponent |= 0xE0;
 
   // Scale the value to a mantissa based on the exponent
-  uint16_t mantissa = (uint16_t)(input_val / pow(2.0, exponent));
+  uint16_t mantissa = (uint16_t) ldexp((double) input_val, -exponent);
 
   return mantissa;
 }
@@ -3424,7 +3436,7 @@ uint16_t LT_PMBus::Float_to_L16_mode(uint8_t vout_mode, float input_val)
 float LT_PMBus::L11_to_Float(uint16_t input_val)
 {
   // Extract exponent as MS 5 bits
-  int8_t exponent = (int8_t) input_val >> 11;
+  int8_t exponent = (int8_t)(input_val >> 11);
 
   // Extract mantissa as LS 11 bits
   int16_t mantissa = input_val & 0x7ff;
@@ -3443,29 +3455,37 @@ float LT_PMBus::L11_to_Float(uint16_t input_val)
  *
  * input_val: the value to convert
  * return: converted value
+ *
+ * Uses the smallest exponent from -16 up that gives an 11 bit mantissa, with
+ * the mantissa truncated toward zero. The exponent follows from the binary
+ * exponent of the value, so there is no search: a magnitude f * 2^k with f in
+ * [0.5, 1) needs exponent k - 10, or k - 11 for negative values that still
+ * truncate to -1024. Values too large saturate the exponent at 15 and keep the
+ * low mantissa bits, as the search did.
  */
 uint16_t LT_PMBus::Float_to_L11(float input_val)
 {
   uint16_t uExponent;
   uint16_t uMantissa;
+  int exponent;
+  float fraction;
 
-  // Set exponent to -16
-  int exponent = -16;
-
-  // Extract mantissa from input value
-  int mantissa = (int)(input_val / pow(2.0, exponent));
-  // Search for an exponent that produces
-  // a valid 11-bit mantissa
-  do
+  if (input_val == 0)
+    exponent = -16;
+  else if (!isfinite(input_val))
+    exponent = 15;
+  else
   {
-    if ((mantissa >= -1024) && (mantissa <= +1023))
-    {
-      break; // stop if mantissa valid
-    }
-    exponent++;
-    mantissa = (int)(input_val / pow(2.0, exponent));
+    fraction = frexpf(fabsf(input_val), &exponent);
+    exponent -= (input_val < 0 && fraction < 1025.0f / 2048.0f) ? 11 : 10;
+    if (exponent < -16)
+      exponent = -16;
+    else if (exponent > 15)
+      exponent = 15;
   }
-  while (exponent < +15);
+
+  // Scaling by a power of two is exact.
+  int mantissa = (int) ldexp((double) input_val, -exponent);
 
   // Format the exponent of the L11
   uExponent = exponent << 11; // Format the mantissa of the L11
@@ -3474,3 +3494,119 @@ uint16_t LT_PMBus::Float_to_L11(float input_val)
   // Compute value as exponent | mantissa
   return uExponent | uMantissa;
 }
+
+/*
+ * Transport and conversion for read<Cmd> and write<Cmd>
+ *
+ * One overload per format, so the template resolves to a single call with no
+ * branch on the format. L16 uses the VOUT_MODE of the device, read with the
+ * same polling as the value.
+ */
+uint8_t LT_PMBus::readAs(uint8_t address, uint8_t command, bool polling, LT_PMBusFormatByte)
+{
+  return polling ? pmbusReadByteWithPolling(address, command) : smbus_->readByte(address, command);
+}
+
+uint16_t LT_PMBus::readAs(uint8_t address, uint8_t command, bool polling, LT_PMBusFormatWord)
+{
+  return polling ? pmbusReadWordWithPolling(address, command) : smbus_->readWord(address, command);
+}
+
+float LT_PMBus::readAs(uint8_t address, uint8_t command, bool polling, LT_PMBusFormatL11)
+{
+  uint16_t l11 = readAs(address, command, polling, LT_PMBusFormatWord());
+
+#if USE_FAST_MATH
+  return math_.lin11_to_float(l11);
+#else
+  return L11_to_Float(l11);
+#endif
+}
+
+float LT_PMBus::readAs(uint8_t address, uint8_t command, bool polling, LT_PMBusFormatL16)
+{
+  uint16_t l16 = readAs(address, command, polling, LT_PMBusFormatWord());
+  uint8_t vout_mode = readAs(address, VOUT_MODE, polling, LT_PMBusFormatByte()) & 0x1F;
+
+#if USE_FAST_MATH
+  return math_.lin16_to_float(l16, vout_mode);
+#else
+  return L16_to_Float_mode(vout_mode, l16);
+#endif
+}
+
+void LT_PMBus::writeAs(uint8_t address, uint8_t command, uint8_t value, LT_PMBusFormatByte)
+{
+  smbus_->writeByte(address, command, value);
+}
+
+void LT_PMBus::writeAs(uint8_t address, uint8_t command, uint16_t value, LT_PMBusFormatWord)
+{
+  smbus_->writeWord(address, command, value);
+}
+
+void LT_PMBus::writeAs(uint8_t address, uint8_t command, float value, LT_PMBusFormatL11)
+{
+#if USE_FAST_MATH
+  smbus_->writeWord(address, command, math_.float_to_lin11(value));
+#else
+  smbus_->writeWord(address, command, Float_to_L11(value));
+#endif
+}
+
+void LT_PMBus::writeAs(uint8_t address, uint8_t command, float value, LT_PMBusFormatL16)
+{
+  uint8_t vout_mode = smbus_->readByte(address, VOUT_MODE) & 0x1F;
+
+#if USE_FAST_MATH
+  smbus_->writeWord(address, command, math_.float_to_lin16(value, vout_mode));
+#else
+  smbus_->writeWord(address, command, Float_to_L16_mode(vout_mode, value));
+#endif
+}
+
+/*
+ * Raw reads for readRaw<Cmd>, without conversion
+ */
+LT_PMBusRaw LT_PMBus::readRawAs(uint8_t address, uint8_t command, bool polling, LT_PMBusFormatByte)
+{
+  return LT_PMBusRaw(readAs(address, command, polling, LT_PMBusFormatByte()), LT_PMBusFormatByte::id, 0);
+}
+
+LT_PMBusRaw LT_PMBus::readRawAs(uint8_t address, uint8_t command, bool polling, LT_PMBusFormatWord)
+{
+  return LT_PMBusRaw(readAs(address, command, polling, LT_PMBusFormatWord()), LT_PMBusFormatWord::id, 0);
+}
+
+LT_PMBusRaw LT_PMBus::readRawAs(uint8_t address, uint8_t command, bool polling, LT_PMBusFormatL11)
+{
+  return LT_PMBusRaw(readAs(address, command, polling, LT_PMBusFormatWord()), LT_PMBusFormatL11::id, 0);
+}
+
+LT_PMBusRaw LT_PMBus::readRawAs(uint8_t address, uint8_t command, bool polling, LT_PMBusFormatL16)
+{
+  uint16_t l16 = readAs(address, command, polling, LT_PMBusFormatWord());
+  uint8_t vout_mode = readAs(address, VOUT_MODE, polling, LT_PMBusFormatByte());
+
+  return LT_PMBusRaw(l16, LT_PMBusFormatL16::id, vout_mode);
+}
+
+void LT_PMBus::encodeL11(const float *values, uint16_t *words, uint16_t count)
+{
+#if USE_FAST_MATH
+  math_.float_to_lin11_n(values, words, count);
+#else
+  for (uint16_t i = 0; i < count; i++)
+    words[i] = Float_to_L11(values[i]);
+#endif
+}
+
+void LT_PMBus::encodeL16(uint8_t vout_mode, const float *values, uint16_t *words, uint16_t count)
+{
+#if USE_FAST_MATH
+  math_.float_to_lin16_n(values, words, count, vout_mode & 0x1F);
+#else
+  for (uint16_t i = 0; i < count; i++)
+    words[i] = Float_to_L16_mode(vout_mode, values[i]);
+#endif
+}
@@ -106,6 +106,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define MFR_EE_DATA             0xBF
 #define MFR_CONFIG_LTC2974      0xD0
 #define MFR_CONFIG_ALL          0xD1
+#define MFR_REAL_TIME           0xD7
 #define MFR_WATCHDOG_T_FIRST    0xE2
 #define MFR_WATCHDOG_T          0xE3
 #define MFR_PADS                0xE5
@@ -349,6 +350,12 @@ enum PsmDeviceType
   LTCUnknown
 };
 
+// Uses the command codes above.
+#include "LT_PMBusCommands.h"
+#include "LT_PMBusRaw.h"
+
+class LT_StoreCoordinator;
+
 //! PMBus communication. Do not use polled commands with LTC2978 or LTC2977.
 //! Commands that end in WithPage use PAGE_PLUS. This is reserved for future
 //! products.
@@ -362,18 +369,29 @@ class LT_PMBus
         to the set they're sending in the group protocol.
     */
     LT_SMBusGroup *smbus_;
+    LT_StoreCoordinator *store_;
 
     void pmbusWriteByteWithPolling(uint8_t address, uint8_t command, uint8_t data);
     uint8_t pmbusReadByteWithPolling(uint8_t address, uint8_t command);
     uint16_t pmbusReadWordWithPolling(uint8_t address, uint8_t command);
 
-    float L11_to_Float(uint16_t input_val);
     float L16_to_Float_with_polling(uint8_t address, uint16_t input_val);
     float L16_to_Float(uint8_t address, uint16_t input_val);
-    float L16_to_Float_mode(uint8_t vout_mode, uint16_t input_val);
     uint16_t Float_to_L16(uint8_t address,  float input_val);
-    uint16_t Float_to_L16_mode(uint8_t vout_mode, float input_val);
-    uint16_t Float_to_L11(float input_val);
+
+    // Transport and conversion of each format, selected by overload at compile time.
+    uint8_t readAs(uint8_t address, uint8_t command, bool polling, LT_PMBusFormatByte);
+    uint16_t readAs(uint8_t address, uint8_t command, bool polling, LT_PMBusFormatWord);
+    float readAs(uint8_t address, uint8_t command, bool polling, LT_PMBusFormatL11);
+    float readAs(uint8_t address, uint8_t command, bool polling, LT_PMBusFormatL16);
+    void writeAs(uint8_t address, uint8_t command, uint8_t value, LT_PMBusFormatByte);
+    void writeAs(uint8_t address, uint8_t command, uint16_t value, LT_PMBusFormatWord);
+    void writeAs(uint8_t address, uint8_t command, float value, LT_PMBusFormatL11);
+    void writeAs(uint8_t address, uint8_t command, float value, LT_PMBusFormatL16);
+    LT_PMBusRaw readRawAs(uint8_t address, uint8_t command, bool polling, LT_PMBusFormatByte);
+    LT_PMBusRaw readRawAs(uint8_t address, uint8_t command, bool polling, LT_PMBusFormatWord);
+    LT_PMBusRaw readRawAs(uint8_t address, uint8_t command, bool polling, LT_PMBusFormatL11);
+    LT_PMBusRaw readRawAs(uint8_t address, uint8_t command, bool polling, LT_PMBusFormatL16);
 
   public:
 
@@ -388,6 +406,146 @@ class LT_PMBus
       return (LT_SMBus *) smbus_;
     }
 
+    //! Defer stores to a coordinator. With a coordinator, storeToNvm, storeToNvmAll
+    //! and fault log stores only mark the device dirty.
+    void setStoreCoordinator(LT_StoreCoordinator *store   //!< coordinator, or NULL to store immediately.
+                            )
+    {
+      store_ = store;
+    }
+
+    LT_StoreCoordinator *getStoreCoordinator()
+    {
+      return store_;
+    }
+
+    //! Convert L11 to float as the getters do with USE_FAST_MATH 0.
+    //! @return the value
+    static float L11_to_Float(uint16_t input_val      //!< L11 word.
+                             );
+
+    //! Convert L16 to float as the getters do with USE_FAST_MATH 0.
+    //! @return the value
+    static float L16_to_Float_mode(uint8_t vout_mode,     //!< VOUT_MODE of the device.
+                                   uint16_t input_val     //!< L16 word.
+                                  );
+
+    //! Convert float to L11 as the setters do with USE_FAST_MATH 0, truncating the mantissa.
+    //! @return L11 word
+    static uint16_t Float_to_L11(float input_val  //!< value to convert.
+                                );
+
+    //! Convert float to L16 as the setters do with USE_FAST_MATH 0, truncating the mantissa.
+    //! @return L16 word
+    static uint16_t Float_to_L16_mode(uint8_t vout_mode,  //!< VOUT_MODE of the device.
+                                      float input_val     //!< value to convert.
+                                     );
+
+    //! Convert values to L11 as the setters do, for example a configuration profile.
+    static void encodeL11(const float *values,   //!< values to convert.
+                          uint16_t *words,       //!< L11 words.
+                          uint16_t count         //!< number of values.
+                         );
+
+    //! Convert values to L16 with a given VOUT_MODE as the setters do, for example a configuration profile.
+    static void encodeL16(uint8_t vout_mode,     //!< VOUT_MODE of the device.
+                          const float *values,   //!< values to convert.
+                          uint16_t *words,       //!< L16 words.
+                          uint16_t count         //!< number of values.
+                         );
+
+    //! Read a command described in LT_PMBusCommands.h, for example read<LT_PMBusCmd::ReadVout>(address).
+    //! The transport and conversion are chosen at compile time from the format of the command.
+    //! @return the value, float for L11 and L16
+    template <class Cmd>
+    typename Cmd::format::value_type read(uint8_t address,        //!< Slave address
+                                          bool polling = false    //!< poll if true
+                                         )
+    {
+      static_assert((Cmd::access & PMBUS_READ) != 0, "command is not readable");
+      return readAs(address, Cmd::code, polling, typename Cmd::format());
+    }
+
+    //! Read a paged command after setting the page.
+    //! @return the value, float for L11 and L16
+    template <class Cmd>
+    typename Cmd::format::value_type readWithPage(uint8_t address,      //!< Slave address
+                                                  uint8_t page,         //!< page
+                                                  bool polling = false  //!< poll if true
+                                                 )
+    {
+      static_assert(Cmd::paged, "command is not paged");
+      setPage(address, page);
+      return read<Cmd>(address, polling);
+    }
+
+    //! Write a command described in LT_PMBusCommands.h, for example write<LT_PMBusCmd::VoutCommand>(address, 1.0).
+    template <class Cmd>
+    void write(uint8_t address,                               //!< Slave address
+               typename Cmd::format::value_type value         //!< value, float for L11 and L16
+              )
+    {
+      static_assert((Cmd::access & PMBUS_WRITE) != 0, "command is not writable");
+      writeAs(address, Cmd::code, value, typename Cmd::format());
+    }
+
+    //! Write a paged command after setting the page.
+    template <class Cmd>
+    void writeWithPage(uint8_t address,                       //!< Slave address
+                       typename Cmd::format::value_type value, //!< value, float for L11 and L16
+                       uint8_t page                           //!< page
+                      )
+    {
+      static_assert(Cmd::paged, "command is not paged");
+      setPage(address, page);
+      write<Cmd>(address, value);
+    }
+
+    //! Send a command without data, for example send<LT_PMBusCmd::ClearFaults>(address).
+    template <class Cmd>
+    void send(uint8_t address         //!< Slave address
+             )
+    {
+      static_assert(Cmd::access == PMBUS_SEND, "command has data");
+      smbus_->sendByte(address, Cmd::code);
+    }
+
+    //! Read a command without converting it, for example readRaw<LT_PMBusCmd::ReadIout>(address).
+    //! L16 commands also read VOUT_MODE; use readRawWithMode when it is known.
+    //! @return the undecoded value
+    template <class Cmd>
+    LT_PMBusRaw readRaw(uint8_t address,        //!< Slave address
+                        bool polling = false    //!< poll if true
+                       )
+    {
+      static_assert((Cmd::access & PMBUS_READ) != 0, "command is not readable");
+      return readRawAs(address, Cmd::code, polling, typename Cmd::format());
+    }
+
+    //! Read an L16 command without converting it, with a VOUT_MODE read before. This is one
+    //! transaction per value.
+    //! @return the undecoded value
+    template <class Cmd>
+    LT_PMBusRaw readRawWithMode(uint8_t address,        //!< Slave address
+                                uint8_t vout_mode,      //!< VOUT_MODE of the device
+                                bool polling = false    //!< poll if true
+                               )
+    {
+      static_assert((Cmd::access & PMBUS_READ) != 0, "command is not readable");
+      static_assert(Cmd::format::id == LT_PMBusFormatL16::id, "command is not L16");
+      return LT_PMBusRaw(readAs(address, Cmd::code, polling, LT_PMBusFormatWord()), LT_PMBusFormatL16::id, vout_mode);
+    }
+
+    //! Read a set of commands, for example readMany<LT_PMBusCmd::ReadVout, LT_PMBusCmd::ReadIout>(address, vout, iout).
+    template <class... Cmds>
+    void readMany(uint8_t address,                                      //!< Slave address
+                  typename Cmds::format::value_type &... values         //!< one value per command
+                 )
+    {
+      int order[] = {0, (values = read<Cmds>(address), 0)...};
+      (void) order;
+    }
+
     //! Get the type of PSM device
     //! @return the type
     PsmDeviceType deviceType(uint8_t address //!> Slave address
@@ -1220,27 +1378,27 @@ class LT_PMBus
                         float delay         //!< Normal delay
                        );
 
-    //! Restore device from NVM
+    //! Restore device from NVM. A pending store of the store coordinator is committed first.
     //! @return void
     void restoreFromNvm(uint8_t address     //!< Slave address
                        );
 
-    //! Restore list of devices from NVM
+    //! Restore list of devices from NVM. Pending stores of the store coordinator are committed first.
     //! @return void
     void restoreFromNvmAll(uint8_t *addresses,      //!< Slave addresses
                            uint8_t no_addresses //!< Number of slave addresses
                           );
 
-    //! Restore all devices from NVM
+    //! Restore all devices from NVM. Pending stores of the store coordinator are committed first.
     //! @return void
     void restoreFromNvmGlobal(void);
 
-    //! Store RAM to NVM
+    //! Store RAM to NVM, or mark the device dirty if there is a store coordinator.
     //! @return void
     void storeToNvm(uint8_t address     //!< Slave address
                    );
 
-    //! Store RAM to NVM for list of devices
+    //! Store RAM to NVM for list of devices, or mark them dirty if there is a store coordinator.
     //! @return void
     void storeToNvmAll(uint8_t *addresses,      //!< Slave addresses
                        uint8_t no_addresses //!< Number of slave addresses
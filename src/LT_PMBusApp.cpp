@@ -37,6 +37,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <stdlib.h>
 #endif
 #include <unistd.h>
+#include <string.h>
 #include <mcheck.h>
 
 #include <sys/resource.h>
@@ -50,6 +51,14 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <LT_PMBusRail.h>
 #include <LT_PMBusDetect.h>
 #include <LT_Nvm.h>
+#include <LT_FaultLogHarvester.h>
+#include <LT_FleetExecutor.h>
+#include <LT_FaultLogTimeline.h>
+#include <LT_StoreCoordinator.h>
+#include <LT_PMBusMathBenchmark.h>
+#include <LT_CodecBenchmark.h>
+#include <LT_SMBusAlert.h>
+#include <LT_AlertSource.h>
 #include "data.h"
 
 using namespace std;
@@ -65,6 +74,8 @@ static LT_PMBusDevice **devices;
 static LT_PMBusDevice **device;
 static LT_PMBusRail **rails;
 static LT_PMBusRail **rail;
+static bool optimize_isp = false;
+static bool schedule_isp = false;
 
 void print_title(void);
 void print_prompt(void);
@@ -82,12 +93,33 @@ void program_nvm (char *path)
   bool worked;
 
   NVM *nvm = new NVM(pmbusNoPec, smbusNoPec, smbusPec);
+  nvm->setOptimize(optimize_isp);
+  nvm->setSchedule(schedule_isp);
 
   printf("Please wait for programming EEPROM...\n");
   if (path == NULL)
   	worked = nvm->programWithData(isp_data);
   else
 	worked = nvm->programWithFileData(path);
+  nvm->printThroughput();
+
+  wait_for_nvm();
+  printf("Programming Complete (RAM and EEPROM may not match until reset)\n");
+
+  delete(nvm);
+}
+
+void program_changed_nvm (char *path)
+{
+  bool worked;
+
+  NVM *nvm = new NVM(pmbusNoPec, smbusNoPec, smbusPec);
+  nvm->setOptimize(optimize_isp);
+  nvm->setSchedule(schedule_isp);
+
+  printf("Please wait for programming changed EEPROM...\n");
+  worked = nvm->programChangedWithFileData(path);
+  nvm->printThroughput();
 
   wait_for_nvm();
   printf("Programming Complete (RAM and EEPROM may not match until reset)\n");
@@ -100,17 +132,23 @@ void verify_nvm (char *path)
   bool worked;
 
   NVM *nvm = new NVM(pmbusNoPec, smbusNoPec, smbusPec);
+  nvm->setOptimize(optimize_isp);
+  nvm->setSchedule(schedule_isp);
 
   printf("Please wait for verification of EEPROM...\n");
   if (path == NULL)
   	worked = nvm->verifyWithData(isp_data);
   else
   	worked = nvm->verifyWithFileData(path);
+  nvm->printThroughput();
 
   wait_for_nvm();
 
   if (worked == 0)
+  {
     printf("Verification complete: Invalid EEPROM data\n");
+    nvm->printMismatches();
+  }
   else
   {
     printf("Verification complete: Valid EEPROM data\n");
@@ -185,7 +223,7 @@ int loop()
 		while (*device != NULL)
 		{
 			printf("  Device: ");
-			((*device)->getType());
+			printf("%s", (*device)->getType());
 			printf(" Address: ");
 			printf("0x%x", (*device)->getAddress());
 
@@ -333,21 +371,26 @@ void print_all_currents()
 
 void print_all_status()
 {
-	uint16_t w;
+	LT_FleetExecutor fleet(1);
+	LT_FleetExecutor::Result *result;
 
 	device = devices;
 	while((*device) != NULL)
 	{
 		if((*device)->hasCapability(HAS_STATUS_WORD))
-		{
-			for (int page = 0; page < (*device)->getNumPages(); page++)
-			{
-				w = (*device)->readStatusWord();
-				printf("STATUS_WORD 0x%04x @ 0x%02x:%d\n", w, (*device)->getAddress(), page);
-			}
-		}
+			fleet.addDevice(*device);
 		device++;
 	}
+
+	fleet.run(LT_FleetExecutor::FLEET_READ_STATUS);
+	for (uint16_t i = 0; i < fleet.getResultCount(); i++)
+	{
+		result = fleet.getResult(i);
+		if (result->error != NULL)
+			printf("STATUS_WORD %s @ 0x%02x\n", result->error, result->address);
+		else
+			printf("STATUS_WORD 0x%04x @ 0x%02x\n", result->value, result->address);
+	}
 }
 
 void sequence_off_on()
@@ -452,8 +495,10 @@ void menu_2_basic_commands()
 		printf("  3-Clear Faults\n");
 		printf("  4-Enable Fault Logs\n");
 		printf("  5-Disable Fault Logs\n");
+		printf("  6-Fault Log Timeline\n");
 		printf("  7-Reset\n");
 		printf("  8-Store Fault Log\n");
+		printf("  9-Compare RAM with NVM\n");
 		printf("  m-Main Menu\n");
 		printf("\nEnter a command:");
 
@@ -496,12 +541,12 @@ void menu_2_basic_commands()
 			}
 	        break;
 	      case 3:
-	      	device = (devices = detector->getDevices());
-			while (*device != NULL)
-			{
-				(*device)->clearFaults();
-				device++;
-			}
+	      	{
+			LT_FleetExecutor fleet(1);
+			fleet.addDevices(devices = detector->getDevices());
+			if (fleet.run(LT_FleetExecutor::FLEET_CLEAR_FAULTS) > 0)
+				fleet.print();
+	      	}
 	        break;
 	      case 4:
 	      	device = (devices = detector->getDevices());
@@ -519,18 +564,43 @@ void menu_2_basic_commands()
 				device++;
 			}
 			break;
+	      case 6:
+	      	{
+			LT_FaultLogHarvester harvester(1);
+			harvester.addBus(pmbus, detector->getDevices());
+			uint16_t logs = harvester.harvest(false);
+			LT_FaultLogTimeline timeline(logs);
+			harvester.addToTimeline(&timeline);
+			timeline.build();
+			timeline.print();
+	      	}
+			break;
 	      case 7:
 	        pmbus->restoreFromNvmGlobal();
 	        usleep(2000 * 1000);
 	        pmbus->resetGlobal();
 	        break;
 	      case 8:
+	      	{
+			// Collect the stores and commit them together, so the parts write their EEPROM in parallel.
+			LT_StoreCoordinator store(pmbus, 0);
 	      	device = (devices = detector->getDevices());
 			while (*device != NULL)
 			{
 				(*device)->storeFaultLog();
 				device++;
 			}
+			store.flush(true);
+			store.print();
+	      	}
+	        break;
+	      case 9:
+	      	{
+			LT_FleetExecutor fleet(1);
+			fleet.addDevices(devices = detector->getDevices());
+			fleet.run(LT_FleetExecutor::FLEET_COMPARE_NVM);
+			fleet.print();
+	      	}
 	        break;
 	      default:
 	        printf("Incorrect Option");
@@ -557,6 +627,7 @@ void menu_3_basic_commands()
 		printf("  6-Program, Verify and Apply (File)\n");
 		printf("  7-Restore\n");
 		printf("  8-Clear Faults\n");
+		printf("  9-Program Changed, Verify and Apply (File)\n");
 		printf("  m-Main Menu\n");
 		printf("\nEnter a command:");
 
@@ -638,11 +709,66 @@ void menu_3_basic_commands()
 			case 8:
 				pmbus->clearFaultsGlobal();
 				break;
+			case 9:
+				printf("Enter File Path: ");
+				if (NULL == fgets(input, sizeof(input), stdin))
+					printf("No File Given\n");
+				else 
+				{
+					input[strlen(input)-1] = '\0';
+					if (-1 != access(input, R_OK))
+					{
+						program_changed_nvm(input);
+						verify_nvm(input);
+						pmbus->resetGlobal();
+					}
+					else
+						printf("Bad File Given: %s\n", input);	
+				}				
+				break;
 	    }
 	}
 	while (user_command != 'm');
 }
 
+#define ALERT_BACKGROUND_MS 10000
+
+static void alert_handler(uint8_t address, void *context)
+{
+	LT_PMBusRegistry *registry = (LT_PMBusRegistry *) context;
+	LT_PMBusDevice *d = registry->getDevice(address);
+
+	printf("Alert from 0x%02x\n", address);
+	if (d != NULL)
+	{
+		printf("STATUS_WORD 0x%04x @ 0x%02x\n", d->readStatusWord(), address);
+		if (d->hasFaultLog())
+			d->printFaultLog();
+	}
+}
+
+/*
+ * Wait on SMBALERT# wired to a GPIO line given as chip:offset, for example
+ * /dev/gpiochip0:17. Status is only polled at a slow background rate.
+ */
+void watch_alerts(char *line)
+{
+	char *sep = strrchr(line, ':');
+
+	if (sep == NULL)
+		throw LT_Exception("Alert line must be chip:offset");
+	*sep = 0;
+
+	LT_GpioAlertSource source(line, strtoul(sep + 1, NULL, 0));
+	LT_SMBusAlert alert(smbus, &source);
+	alert.addHandler(alert_handler, detector->getRegistry());
+	while (1)
+	{
+		if (alert.wait(ALERT_BACKGROUND_MS) == 0)
+			print_all_status();
+	}
+}
+
 static void sig_abort(int signo)
 {
   delete smbus;
@@ -657,6 +783,7 @@ int main(int argc, char * argv[]) {
     char *holder;
     char *dev = NULL;
     int opt_address;
+    LT_PMBusDevice *found;
     
 
     signal(SIGINT, sig_abort);
@@ -683,12 +810,37 @@ int main(int argc, char * argv[]) {
 
 
 
-        while ((opt = getopt(argc, argv, "d:s:e:c:p:v:x:i ")) != -1) {
+        while ((opt = getopt(argc, argv, "d:s:e:c:p:v:x:a:iomtb ")) != -1) {
 	        switch (opt) {
 	        case 'd':
 			printf("Operate with device %s\n", optarg);
 			dev = optarg;
 	        	break;
+	        case 'o':
+			printf("Optimize ISP records\n");
+			optimize_isp = true;
+	        	break;
+	        case 'm':
+			printf("Program devices in parallel lanes\n");
+			schedule_isp = true;
+	        	break;
+	        case 't':
+	        	{
+			LT_PMBusMathBenchmark benchmark;
+			uint32_t errors = benchmark.check();
+			printf("Math check: %u errors\n", errors);
+			exit(errors == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+	        	}
+	        	break;
+	        case 'b':
+	        	{
+			LT_PMBusMathBenchmark benchmark;
+			LT_CodecBenchmark codecs;
+			uint32_t failures = benchmark.run();
+			failures += codecs.run();
+			exit(failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+	        	}
+	        	break;
 	        case 'p':
 				printf("Program with file %s\n", optarg);
 	    		mtrace();
@@ -766,20 +918,19 @@ int main(int argc, char * argv[]) {
 				detector = new LT_PMBusDetect(pmbus);
 		   		detector->detect();
 		   		devices = detector->getDevices();
-                                device = devices;
-                              	holder = optarg;
-        			opt_address = strtol(holder, NULL, 16);
-                                while (*device != NULL){
-                                   if((*device)->getAddress() == opt_address){
-					if((*device)->hasFaultLog()){
-					   printf("Fault log for 0x%02x\n", (*device)->getAddress());					
-					   (*device)->printFaultLog();
-				        }
-				        else
-					   printf("No fault log for 0x%02x\n", (*device)->getAddress());
-				    }
-				   device++;
-                                }
+				holder = optarg;
+				opt_address = strtol(holder, NULL, 16);
+				found = detector->getDevice(opt_address);
+				if (found != NULL)
+				{
+					if (found->hasFaultLog())
+					{
+						printf("Fault log for 0x%02x\n", found->getAddress());
+						found->printFaultLog();
+					}
+					else
+						printf("No fault log for 0x%02x\n", found->getAddress());
+				}
 				delete(detector);
 				delete(pmbusPec);
 				delete(pmbusNoPec);
@@ -806,17 +957,14 @@ int main(int argc, char * argv[]) {
 				detector = new LT_PMBusDetect(pmbus);
 		   		detector->detect();
 		   		devices = detector->getDevices();
-                                device = devices;
 				holder = optarg;
-        			opt_address = strtol(holder, NULL, 16);
-        			opt_address = strtol(holder, NULL, 16);
-                                while (*device != NULL){
-                                   if((*device)->getAddress() == opt_address){
-					   (*device)->enableFaultLog();
-    					   printf("Fault log for 0x%02x Enabled\n", (*device)->getAddress());					
-				    }
-				   device++;
-                                }
+				opt_address = strtol(holder, NULL, 16);
+				found = detector->getDevice(opt_address);
+				if (found != NULL)
+				{
+					found->enableFaultLog();
+					printf("Fault log for 0x%02x Enabled\n", found->getAddress());
+				}
 				delete(detector);
 				delete(pmbusPec);
 				delete(pmbusNoPec);
@@ -843,17 +991,14 @@ int main(int argc, char * argv[]) {
 				detector = new LT_PMBusDetect(pmbus);
 		   		detector->detect();
 		   		devices = detector->getDevices();
-                                device = devices;
 				holder = optarg;
-        			opt_address = strtol(holder, NULL, 16);
-                                while (*device != NULL)
+				opt_address = strtol(holder, NULL, 16);
+				found = detector->getDevice(opt_address);
+				if (found != NULL)
 				{
-                                if((*device)->getAddress() == opt_address){
-					(*device)->clearFaultLog();
-    					printf("Clearing Fault log for 0x%02x \n", (*device)->getAddress());					
-				   }
-				device++;
-                                }
+					found->clearFaultLog();
+					printf("Clearing Fault log for 0x%02x \n", found->getAddress());
+				}
 				delete(detector);
 				delete(pmbusPec);
 				delete(pmbusNoPec);
@@ -880,17 +1025,14 @@ int main(int argc, char * argv[]) {
 				detector = new LT_PMBusDetect(pmbus);
 		   		detector->detect();
 		   		devices = detector->getDevices();
-                                device = devices;
 				holder = optarg;
-        			opt_address = strtol(holder, NULL, 16);
-                                while (*device != NULL)
+				opt_address = strtol(holder, NULL, 16);
+				found = detector->getDevice(opt_address);
+				if (found != NULL)
 				{
-                                if((*device)->getAddress() == opt_address){
-					(*device)->storeFaultLog();
-    					printf("Storing Fault log for 0x%02x \n", (*device)->getAddress());					
-				   }
-				device++;
-                                }
+					found->storeFaultLog();
+					printf("Storing Fault log for 0x%02x \n", found->getAddress());
+				}
 				delete(detector);
 				delete(pmbusPec);
 				delete(pmbusNoPec);
@@ -917,17 +1059,14 @@ int main(int argc, char * argv[]) {
 				detector = new LT_PMBusDetect(pmbus);
 		   		detector->detect();
 		   		devices = detector->getDevices();
-                                device = devices;
 				holder = optarg;
-        			opt_address = strtol(holder, NULL, 16);
-                                while (*device != NULL)
+				opt_address = strtol(holder, NULL, 16);
+				found = detector->getDevice(opt_address);
+				if (found != NULL)
 				{
-                                if((*device)->getAddress() == opt_address){
-					(*device)->disableFaultLog();
-    					printf("Disabling Fault log for 0x%02x \n", (*device)->getAddress());					
-				   }
-				device++;
-                                }
+					found->disableFaultLog();
+					printf("Disabling Fault log for 0x%02x \n", found->getAddress());
+				}
 				delete(detector);
 				delete(pmbusPec);
 				delete(pmbusNoPec);
@@ -935,13 +1074,33 @@ int main(int argc, char * argv[]) {
 				delete(smbusNoPec);
 				exit(EXIT_SUCCESS);
 	        	break;
+	        case 'a':
+	        	if (dev != NULL)
+		    	{
+					smbusNoPec = new LT_SMBusNoPec(dev);
+					smbusPec = new LT_SMBusPec(dev);
+				}
+				else
+				{
+					smbusNoPec = new LT_SMBusNoPec();
+					smbusPec = new LT_SMBusPec();
+				}
+				pmbusNoPec = new LT_PMBus(smbusNoPec);
+				pmbusPec = new LT_PMBus(smbusPec);
+				smbus = smbusNoPec;
+				pmbus = pmbusNoPec;
+				detector = new LT_PMBusDetect(pmbus);
+		   		detector->detect();
+		   		devices = detector->getDevices();
+				watch_alerts(optarg);
+				break;
 	        default: /* '?' */
 				delete(detector);
 				delete(pmbusPec);
 				delete(pmbusNoPec);
 				delete(smbusPec);
 				delete(smbusNoPec);
-	            fprintf(stderr, "Usage: %s [-d dev] ([-p file] | [-v address] | [-x address] |\n   [-e address] | [-s address] | [-c address] | [-i]\n", argv[0]);
+	            fprintf(stderr, "Usage: %s [-d dev] [-o] [-m] ([-p file] | [-v address] | [-x address] |\n   [-e address] | [-s address] | [-c address] | [-a chip:line] | [-i] | [-t] | [-b]\n", argv[0]);
 	            exit(EXIT_FAILURE);
 	        }
 	    }
@@ -957,7 +1116,7 @@ int main(int argc, char * argv[]) {
 	delete(pmbusNoPec);
 	delete(smbusPec);
 	delete(smbusNoPec);
-    fprintf(stderr, "Usage: %s [-d dev] ([-p file] | [-v address] | [-x address] |\n   [-e address] | [-s address] | [-c address] | [-i])\n", argv[0]);
+    fprintf(stderr, "Usage: %s [-d dev] [-o] [-m] ([-p file] | [-v address] | [-x address] |\n   [-e address] | [-s address] | [-c address] | [-a chip:line] | [-i] | [-t] | [-b])\n", argv[0]);
     exit(EXIT_FAILURE);
 }
 
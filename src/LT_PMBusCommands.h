@@ -0,0 +1,218 @@
+/*
+Copyright (c) 2020, Analog Devices Inc
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  * Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  * Neither the name of the Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived from this
+    software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Descriptors of the PMBus commands. Included by LT_PMBus.h after the command codes.
+
+#ifndef LT_PMBusCommands_H_
+#define LT_PMBusCommands_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Access of a command
+#define PMBUS_READ              0x01
+#define PMBUS_WRITE             0x02
+#define PMBUS_READ_WRITE        0x03
+#define PMBUS_SEND              0x04
+
+// Width of a block command, the length is in the data
+#define PMBUS_BLOCK_WIDTH       0xFF
+
+//! Data formats. The format of a command selects the transport and the conversion at
+//! compile time, and value_type is what read returns and write takes.
+struct LT_PMBusFormatSend
+{
+  typedef void value_type;
+  static const uint8_t id = 0;
+};
+struct LT_PMBusFormatByte
+{
+  typedef uint8_t value_type;
+  static const uint8_t id = 1;
+};
+struct LT_PMBusFormatWord
+{
+  typedef uint16_t value_type;
+  static const uint8_t id = 2;
+};
+struct LT_PMBusFormatL11
+{
+  typedef float value_type;
+  static const uint8_t id = 3;
+};
+struct LT_PMBusFormatL16
+{
+  typedef float value_type;
+  static const uint8_t id = 4;
+};
+struct LT_PMBusFormatBlock
+{
+  typedef uint8_t *value_type;
+  static const uint8_t id = 5;
+};
+
+//! Descriptor of a command, as stored in LT_PMBusCommandTable.
+struct LT_PMBusCommand
+{
+  const char *name;       //!< name of the command code define.
+  uint8_t code;           //!< command code.
+  uint8_t width;          //!< data bytes, 0 for send byte, PMBUS_BLOCK_WIDTH for a block of variable length.
+  uint8_t format;         //!< LT_PMBusFormat*::id.
+  uint8_t access;         //!< PMBUS_READ, PMBUS_WRITE, PMBUS_READ_WRITE or PMBUS_SEND.
+  bool paged;             //!< the command applies to the selected PAGE.
+};
+
+//! Every command code defined in LT_PMBus.h:
+//! X(type, code, width, format, access, paged)
+//! Codes shared by different parts, for example 0xED, have one entry per name.
+#define LT_PMBUS_COMMAND_LIST(X) \
+  X(Page,                 PAGE,                   1, Byte,  PMBUS_READ_WRITE, false) \
+  X(Operation,            OPERATION,              1, Byte,  PMBUS_READ_WRITE, true) \
+  X(OnOffConfig,          ON_OFF_CONFIG,          1, Byte,  PMBUS_READ_WRITE, true) \
+  X(ClearFaults,          CLEAR_FAULTS,           0, Send,  PMBUS_SEND,       false) \
+  X(PagePlusWrite,        PAGE_PLUS_WRITE,        PMBUS_BLOCK_WIDTH, Block, PMBUS_WRITE, false) \
+  X(PagePlusRead,         PAGE_PLUS_READ,         PMBUS_BLOCK_WIDTH, Block, PMBUS_READ, false) \
+  X(WriteProtect,         WRITE_PROTECT,          1, Byte,  PMBUS_READ_WRITE, false) \
+  X(StoreUserAll,         STORE_USER_ALL,         0, Send,  PMBUS_SEND,       false) \
+  X(RestoreUserAll,       RESTORE_USER_ALL,       0, Send,  PMBUS_SEND,       false) \
+  X(MfrCompareUserAll,    MFR_COMPARE_USER_ALL,   0, Send,  PMBUS_SEND,       false) \
+  X(SmbalertMask,         SMBALERT_MASK,          2, Word,  PMBUS_WRITE,      true) \
+  X(VoutMode,             VOUT_MODE,              1, Byte,  PMBUS_READ,       true) \
+  X(VoutCommand,          VOUT_COMMAND,           2, L16,   PMBUS_READ_WRITE, true) \
+  X(VoutMax,              VOUT_MAX,               2, L16,   PMBUS_READ_WRITE, true) \
+  X(VoutMarginHigh,       VOUT_MARGIN_HIGH,       2, L16,   PMBUS_READ_WRITE, true) \
+  X(VoutMarginLow,        VOUT_MARGIN_LOW,        2, L16,   PMBUS_READ_WRITE, true) \
+  X(VoutOvFaultLimit,     VOUT_OV_FAULT_LIMIT,    2, L16,   PMBUS_READ_WRITE, true) \
+  X(VoutOvFaultResponse,  VOUT_OV_FAULT_RESPONSE, 1, Byte,  PMBUS_READ_WRITE, true) \
+  X(VoutOvWarnLimit,      VOUT_OV_WARN_LIMIT,     2, L16,   PMBUS_READ_WRITE, true) \
+  X(VoutUvWarnLimit,      VOUT_UV_WARN_LIMIT,     2, L16,   PMBUS_READ_WRITE, true) \
+  X(VoutUvFaultLimit,     VOUT_UV_FAULT_LIMIT,    2, L16,   PMBUS_READ_WRITE, true) \
+  X(VoutUvFaultResponse,  VOUT_UV_FAULT_RESPONSE, 1, Byte,  PMBUS_READ_WRITE, true) \
+  X(IoutOcFaultLimit,     IOUT_OC_FAULT_LIMIT,    2, L11,   PMBUS_READ_WRITE, true) \
+  X(IoutOcWarnLimit,      IOUT_OC_WARN_LIMIT,     2, L11,   PMBUS_READ_WRITE, true) \
+  X(OtFaultLimit,         OT_FAULT_LIMIT,         2, L11,   PMBUS_READ_WRITE, true) \
+  X(OtWarnLimit,          OT_WARN_LIMIT,          2, L11,   PMBUS_READ_WRITE, true) \
+  X(UtWarnLimit,          UT_WARN_LIMIT,          2, L11,   PMBUS_READ_WRITE, true) \
+  X(UtFaultLimit,         UT_FAULT_LIMIT,         2, L11,   PMBUS_READ_WRITE, true) \
+  X(VinOvFaultLimit,      VIN_OV_FAULT_LIMIT,     2, L11,   PMBUS_READ_WRITE, false) \
+  X(VinOvWarnLimit,       VIN_OV_WARN_LIMIT,      2, L11,   PMBUS_READ_WRITE, false) \
+  X(VinUvWarnLimit,       VIN_UV_WARN_LIMIT,      2, L11,   PMBUS_READ_WRITE, false) \
+  X(VinUvFaultLimit,      VIN_UV_FAULT_LIMIT,     2, L11,   PMBUS_READ_WRITE, false) \
+  X(IinOcWarnLimit,       IIN_OC_WARN_LIMIT,      2, L11,   PMBUS_READ_WRITE, false) \
+  X(TonDelay,             TON_DELAY,              2, L11,   PMBUS_READ_WRITE, true) \
+  X(TonRise,              TON_RISE,               2, L11,   PMBUS_READ_WRITE, true) \
+  X(TonMaxFaultLimit,     TON_MAX_FAULT_LIMIT,    2, L11,   PMBUS_READ_WRITE, true) \
+  X(TonMaxFaultResponse,  TON_MAX_FAULT_RESPONSE, 1, Byte,  PMBUS_READ_WRITE, true) \
+  X(ToffDelay,            TOFF_DELAY,             2, L11,   PMBUS_READ_WRITE, true) \
+  X(ToffFall,             TOFF_FALL,              2, L11,   PMBUS_READ_WRITE, true) \
+  X(ToffMaxWarnLimit,     TOFF_MAX_WARN_LIMIT,    2, L11,   PMBUS_READ_WRITE, true) \
+  X(StatusByte,           STATUS_BYTE,            1, Byte,  PMBUS_READ_WRITE, true) \
+  X(StatusWord,           STATUS_WORD,            2, Word,  PMBUS_READ_WRITE, true) \
+  X(StatusVout,           STATUS_VOUT,            1, Byte,  PMBUS_READ_WRITE, true) \
+  X(StatusIout,           STATUS_IOUT,            1, Byte,  PMBUS_READ_WRITE, true) \
+  X(StatusInput,          STATUS_INPUT,           1, Byte,  PMBUS_READ_WRITE, false) \
+  X(StatusTemp,           STATUS_TEMP,            1, Byte,  PMBUS_READ_WRITE, true) \
+  X(StatusCml,            STATUS_CML,             1, Byte,  PMBUS_READ_WRITE, false) \
+  X(StatusMfrSpecific,    STATUS_MFR_SPECIFIC,    1, Byte,  PMBUS_READ_WRITE, true) \
+  X(ReadVin,              READ_VIN,               2, L11,   PMBUS_READ,       false) \
+  X(ReadIin,              READ_IIN,               2, L11,   PMBUS_READ,       false) \
+  X(ReadVout,             READ_VOUT,              2, L16,   PMBUS_READ,       true) \
+  X(ReadIout,             READ_IOUT,              2, L11,   PMBUS_READ,       true) \
+  X(ReadOtemp,            READ_OTEMP,             2, L11,   PMBUS_READ,       true) \
+  X(ReadItemp,            READ_ITEMP,             2, L11,   PMBUS_READ,       false) \
+  X(ReadDutyCycle,        READ_DUTY_CYCLE,        2, L11,   PMBUS_READ,       true) \
+  X(ReadPout,             READ_POUT,              2, L11,   PMBUS_READ,       true) \
+  X(ReadPin,              READ_PIN,               2, L11,   PMBUS_READ,       false) \
+  X(MfrModel,             MFR_MODEL,              PMBUS_BLOCK_WIDTH, Block, PMBUS_READ, false) \
+  X(MfrRevision,          MFR_REVISION,           PMBUS_BLOCK_WIDTH, Block, PMBUS_READ, false) \
+  X(PmbusRevision,        PMBUS_REVISION,         1, Byte,  PMBUS_READ,       false) \
+  X(UserData03,           USER_DATA_03,           2, Word,  PMBUS_READ_WRITE, false) \
+  X(UserData04,           USER_DATA_04,           2, Word,  PMBUS_READ_WRITE, false) \
+  X(MfrEeUnlock,          MFR_EE_UNLOCK,          1, Byte,  PMBUS_READ_WRITE, false) \
+  X(MfrEeErase,           MFR_EE_ERASE,           1, Byte,  PMBUS_READ_WRITE, false) \
+  X(MfrEeData,            MFR_EE_DATA,            2, Word,  PMBUS_READ_WRITE, false) \
+  X(MfrConfigLtc2974,     MFR_CONFIG_LTC2974,     2, Word,  PMBUS_READ_WRITE, true) \
+  X(MfrConfigAll,         MFR_CONFIG_ALL,         2, Word,  PMBUS_READ_WRITE, false) \
+  X(MfrRealTime,          MFR_REAL_TIME,          6, Block, PMBUS_READ,       false) \
+  X(MfrWatchdogTFirst,    MFR_WATCHDOG_T_FIRST,   2, L11,   PMBUS_READ_WRITE, false) \
+  X(MfrWatchdogT,         MFR_WATCHDOG_T,         2, L11,   PMBUS_READ_WRITE, false) \
+  X(MfrPads,              MFR_PADS,               2, Word,  PMBUS_READ,       false) \
+  X(MfrSpecialId,         MFR_SPECIAL_ID,         2, Word,  PMBUS_READ,       false) \
+  X(MfrFaultLogStore,     MFR_FAULT_LOG_STORE,    0, Send,  PMBUS_SEND,       false) \
+  X(MfrFaultLogRestore,   MFR_FAULT_LOG_RESTORE,  0, Send,  PMBUS_SEND,       false) \
+  X(MfrFaultLogClear,     MFR_FAULT_LOG_CLEAR,    0, Send,  PMBUS_SEND,       false) \
+  X(MfrReadIin,           MFR_READ_IIN,           2, L11,   PMBUS_READ,       true) \
+  X(MfrFaultLogStatus,    MFR_FAULT_LOG_STATUS,   1, Byte,  PMBUS_READ_WRITE, false) \
+  X(MfrFaultLog,          MFR_FAULT_LOG,          PMBUS_BLOCK_WIDTH, Block, PMBUS_READ, false) \
+  X(MfrCommon,            MFR_COMMON,             1, Byte,  PMBUS_READ,       false) \
+  X(MfrSpare0,            MFR_SPARE_0,            2, Word,  PMBUS_READ_WRITE, false) \
+  X(MfrSpare1,            MFR_SPARE_1,            2, Word,  PMBUS_READ_WRITE, false) \
+  X(MfrSpare2,            MFR_SPARE_2,            2, Word,  PMBUS_READ_WRITE, false) \
+  X(MfrSpare3,            MFR_SPARE_3,            2, Word,  PMBUS_READ_WRITE, false) \
+  X(MfrTemp1Gain,         MFR_TEMP_1_GAIN,        2, Word,  PMBUS_READ_WRITE, true) \
+  X(MfrEepromStatus,      MFR_EEPROM_STATUS,      1, Byte,  PMBUS_READ,       false) \
+  X(MfrRailAddress,       MFR_RAIL_ADDRESS,       1, Byte,  PMBUS_READ_WRITE, true) \
+  X(MfrReset,             MFR_RESET,              0, Send,  PMBUS_SEND,       false)
+
+//! One type per command, used as the template argument of LT_PMBus::read and write,
+//! for example pmbus->read<LT_PMBusCmd::ReadVout>(address).
+namespace LT_PMBusCmd
+{
+#define LT_PMBUS_COMMAND_TYPE(type, code_, width_, format_, access_, paged_) \
+  struct type \
+  { \
+    typedef LT_PMBusFormat##format_ format; \
+    static const uint8_t code = code_; \
+    static const uint8_t width = width_; \
+    static const uint8_t access = access_; \
+    static const bool paged = paged_; \
+  };
+  LT_PMBUS_COMMAND_LIST(LT_PMBUS_COMMAND_TYPE)
+#undef LT_PMBUS_COMMAND_TYPE
+}
+
+//! All commands, in the order of LT_PMBUS_COMMAND_LIST.
+#define LT_PMBUS_COMMAND_ENTRY(type, code_, width_, format_, access_, paged_) \
+  { #code_, code_, width_, LT_PMBusFormat##format_::id, access_, paged_ },
+static constexpr LT_PMBusCommand LT_PMBusCommandTable[] =
+{
+  LT_PMBUS_COMMAND_LIST(LT_PMBUS_COMMAND_ENTRY)
+};
+#undef LT_PMBUS_COMMAND_ENTRY
+
+static constexpr uint16_t LT_PMBusCommandCount = sizeof(LT_PMBusCommandTable) / sizeof(LT_PMBusCommand);
+
+//! Find the first descriptor of a command code, at compile time if the code is a constant.
+//! @return the descriptor, or NULL if the code is not in the table.
+constexpr const LT_PMBusCommand *findPMBusCommand(uint8_t code, uint16_t index = 0)
+{
+  return index >= LT_PMBusCommandCount ? NULL :
+         LT_PMBusCommandTable[index].code == code ? &LT_PMBusCommandTable[index] :
+         findPMBusCommand(code, index + 1);
+}
+
+#endif /* LT_PMBusCommands_H_ */
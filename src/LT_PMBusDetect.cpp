@@ -58,11 +58,22 @@ LT_PMBusDetect::LT_PMBusDetect(LT_PMBus *pmbus):pmbus_(pmbus)
 {
   devices_ = NULL;
   rails_ = NULL;
+  phases_ = NULL;
   deviceCnt_ = 0;
   railCnt_ = 0;
+  railCapacity_ = 0;
+  phaseCnt_ = 0;
 }
 
 LT_PMBusDetect::~LT_PMBusDetect()
+{
+  release();
+}
+
+/*
+ * Delete the devices and rails, then the phase table the rails point into.
+ */
+void LT_PMBusDetect::release()
 {
   if (deviceCnt_ > 0)
   {
@@ -72,8 +83,9 @@ LT_PMBusDetect::~LT_PMBusDetect()
       if (devices_[deviceCnt_] != NULL)
         delete (devices_[deviceCnt_]);
     }
-    free(devices_);
   }
+  free(devices_);
+  devices_ = NULL;
 
   if (railCnt_ > 0)
   {
@@ -85,8 +97,57 @@ LT_PMBusDetect::~LT_PMBusDetect()
         delete (rails_[railCnt_]);
       }
     }
-    free(rails_);
   }
+  free(rails_);
+  rails_ = NULL;
+  railCapacity_ = 0;
+
+  free(phases_);
+  phases_ = NULL;
+  phaseCnt_ = 0;
+}
+
+/*
+ * Add a rail, growing the list by doubling. One entry is kept free for the
+ * terminating NULL.
+ */
+bool LT_PMBusDetect::addRail(LT_PMBusRail *rail)
+{
+  LT_PMBusRail **rails;
+  unsigned int capacity;
+
+  if (railCnt_ + 1 >= railCapacity_)
+  {
+    capacity = railCapacity_ == 0 ? 8 : 2 * railCapacity_;
+    if ((rails = (LT_PMBusRail **) realloc(rails_, capacity * sizeof(LT_PMBusRail *))) == NULL)
+      return false;
+    rails_ = rails;
+    railCapacity_ = capacity;
+  }
+  rails_[railCnt_++] = rail;
+  rails_[railCnt_] = NULL;
+  return true;
+}
+
+/*
+ * Move the phases of all rails into one table, so aggregate reads walk
+ * contiguous memory and the per rail arrays built while merging are freed.
+ */
+void LT_PMBusDetect::packRails()
+{
+  unsigned int i;
+
+  phaseCnt_ = 0;
+  for (i = 0; i < railCnt_; i++)
+    phaseCnt_ += rails_[i]->getNoPages();
+  if (phaseCnt_ == 0 || (phases_ = (tRailPhase *) malloc(phaseCnt_ * sizeof(tRailPhase))) == NULL)
+  {
+    phaseCnt_ = 0;
+    return;
+  }
+  phaseCnt_ = 0;
+  for (i = 0; i < railCnt_; i++)
+    phaseCnt_ += rails_[i]->pack(phases_ + phaseCnt_);
 }
 
 LT_PMBusDevice **LT_PMBusDetect::getDevices(
@@ -101,36 +162,27 @@ LT_PMBusRail **LT_PMBusDetect::getRails(
   return rails_;
 }
 
+LT_PMBusRegistry *LT_PMBusDetect::getRegistry(
+)
+{
+  return &registry_;
+}
+
+LT_PMBusDevice *LT_PMBusDetect::getDevice(uint8_t address
+                                         )
+{
+  return registry_.getDevice(address);
+}
+
 
 void LT_PMBusDetect::detect ()
 {
   uint8_t *addresses;
   LT_PMBusDevice *device;
-  unsigned int i, j;
-
-  if (deviceCnt_ > 0)
-  {
-    while (deviceCnt_ > 0)
-    {
-      deviceCnt_--;
-      if (devices_[deviceCnt_] != NULL)
-        delete (devices_[deviceCnt_]);
-    }
-    free(devices_);
-  }
+  unsigned int i;
 
-  if (railCnt_ > 0)
-  {
-    while (railCnt_ > 0)
-    {
-      railCnt_--;
-      if (rails_[railCnt_] != NULL)
-      {
-        delete (rails_[railCnt_]);
-      }
-    }
-    free(rails_);
-  }
+  release();
+  registry_.clear();
 
   addresses = pmbus_->smbus()->probeUnique(0x00);
 
@@ -197,13 +249,15 @@ void LT_PMBusDetect::detect ()
 
   }
 
+  for (i = 0; i < deviceCnt_; i++)
+    registry_.addDevice(devices_[i]);
+
   // Get all the rails, while merging duplicates.
   for (i = 0; i < deviceCnt_; i++)
   {
     LT_PMBusRail **rails;
     LT_PMBusRail **new_rail;
-    void *m;
-    bool merged;
+    LT_PMBusRail *known;
 
     new_rail = rails = devices_[i]->getRails();
 
@@ -212,39 +266,32 @@ void LT_PMBusDetect::detect ()
     {
 
       // See if we are already in the list.
-      merged = false;
-      for (j = 0; j < railCnt_; j++)
+      known = registry_.getRail((*new_rail)->getAddress());
+      if (known != NULL)
       {
-        if (rails_[j]->isMultiphase() && rails_[j]->getAddress() == (*new_rail)->getAddress())
-        {
-          rails_[j]->merge(*new_rail);
-          delete (*new_rail);
-          merged = true;
-          break;
-        }
+        known->merge(*new_rail);
+        delete (*new_rail);
+        registry_.addMember(devices_[i]->getAddress(), known);
       }
-      if (!merged)
+      else
       {
-        if (rails_ == NULL)
-          rails_ = (LT_PMBusRail **) malloc(sizeof(LT_PMBusRail *));
-        else
+        if (addRail(*new_rail))
         {
-          m = realloc(rails_, (railCnt_ + 1) * sizeof(LT_PMBusRail *));
-          if (m != NULL)
-//            free(m);
-//          else
-            rails_ = (LT_PMBusRail **) m;
+          if ((*new_rail)->isMultiphase())
+            registry_.addRail(*new_rail);
+          registry_.addMember(devices_[i]->getAddress(), *new_rail);
         }
-        if (rails_ != NULL)
-          rails_[railCnt_++] = *new_rail;
+        else
+          delete (*new_rail);
       }
 
       new_rail++;
     }
-    delete rails;
+    free(rails);
   }
 
-  rails_ = (LT_PMBusRail **) realloc(rails_, (railCnt_ + 1) * sizeof(LT_PMBusRail *));
-
-  rails_[railCnt_] = NULL;
+  if (rails_ == NULL)
+    rails_ = (LT_PMBusRail **) calloc(1, sizeof(LT_PMBusRail *));
+  else
+    packRails();
 }
\ No newline at end of file
@@ -30,6 +30,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "LT_PMBusDevice.h"
 #include "LT_PMBusRail.h"
+#include "LT_PMBusRegistry.h"
 
 class LT_PMBusDetect
 {
@@ -37,8 +38,16 @@ class LT_PMBusDetect
     LT_PMBus *pmbus_;
     LT_PMBusDevice **devices_;
     LT_PMBusRail **rails_;
+    tRailPhase *phases_;      //!< phases of all rails, each rail a contiguous range.
     unsigned int deviceCnt_;
     unsigned int railCnt_;
+    unsigned int railCapacity_;
+    unsigned int phaseCnt_;
+
+    void release();
+    bool addRail(LT_PMBusRail *rail);
+    void packRails();
+    LT_PMBusRegistry registry_;
 
   public:
     LT_PMBusDetect(LT_PMBus *pmbus);
@@ -51,6 +60,26 @@ class LT_PMBusDetect
 
     LT_PMBusRail **getRails();
 
+    //! Get the phases of all rails, in rail order.
+    const tRailPhase *getPhases()
+    {
+      return phases_;
+    }
+
+    //! Get the number of phases of all rails.
+    unsigned int getPhaseCount()
+    {
+      return phaseCnt_;
+    }
+
+    //! Get the address registry of the detected devices and rails
+    LT_PMBusRegistry *getRegistry();
+
+    //! Get a detected device by address
+    //! @return device or NULL
+    LT_PMBusDevice *getDevice(uint8_t address //!< 7 bit address
+                             );
+
 };
 
 #endif /* LT_PMBusDetect_H_ */
@@ -26,6 +26,12 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "LT_PMBusDevice.h"
+#include "LT_FaultLog.h"
+
+LT_PMBusDevice::~LT_PMBusDevice()
+{
+  delete faultLog_;
+}
     
 void LT_PMBusDevice::probeSpeed()
 {
@@ -54,6 +60,8 @@ LT_SMBus *LT_PMBusDevice::smbus()
 void LT_PMBusDevice::changePMBus(LT_PMBus *pmbus)
 {
   pmbus_ = pmbus;
+  if (faultLog_ != NULL)
+    faultLog_->changePMBus(pmbus);
 }
 
 
@@ -122,16 +130,65 @@ void LT_PMBusDevice::disablePec()
   pmbus_->disablePec(address_);
 }
 
+LT_FaultLog *LT_PMBusDevice::faultLog()
+{
+  return faultLog_;
+}
+
+void LT_PMBusDevice::enableFaultLog()
+{
+  if (faultLog_ != NULL)
+    faultLog_->enableFaultLog(address_);
+}
+
+void LT_PMBusDevice::disableFaultLog()
+{
+  if (faultLog_ != NULL)
+    faultLog_->disableFaultLog(address_);
+}
+
 bool LT_PMBusDevice::hasFaultLog()
 {
-  return false;
+  if (faultLog_ == NULL)
+    return false;
+  return faultLog_->hasFaultLog(address_);
 }
 
 char *LT_PMBusDevice::getFaultLog()
 {
+  if (hasFaultLog())
+  {
+    faultLog_->read(address_);
+//    faultLog_->print();
+//    faultLog_->dumpBinary();
+    faultLog_->release();
+  }
   return NULL;
 }
 
+void LT_PMBusDevice::printFaultLog()
+{
+  if (hasFaultLog())
+  {
+    faultLog_->read(address_);
+    faultLog_->print();
+//    faultLog_->dumpBinary();
+    faultLog_->release();
+  }
+}
+
+void LT_PMBusDevice::clearFaultLog()
+{
+  if (hasFaultLog())
+    faultLog_->clearFaultLog(address_);
+}
+
+void LT_PMBusDevice::storeFaultLog()
+{
+  if (faultLog_ != NULL && !faultLog_->hasFaultLog(address_))
+    faultLog_->storeFaultLog(address_);
+}
+
 void LT_PMBusDevice::setVout(float voltage)
 {
   if (hasCapability(HAS_VOUT))
@@ -45,6 +45,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "LT_PMBusRail.h"
 #include "LT_PMBusSpeedTest.h"
 
+class LT_FaultLog;
+
 class LT_PMBusDevice
 {
   protected:
@@ -52,8 +54,9 @@ class LT_PMBusDevice
     uint8_t address_;
     uint32_t maxSpeed_;
     uint8_t model_[9];
+    LT_FaultLog *faultLog_;     //!< Fault log handler owned by this device, NULL if the part has no fault log
 
-    LT_PMBusDevice(LT_PMBus *pmbus, uint8_t address):pmbus_(pmbus), address_(address)
+    LT_PMBusDevice(LT_PMBus *pmbus, uint8_t address):pmbus_(pmbus), address_(address), faultLog_(NULL)
     {
     }
 
@@ -63,7 +66,7 @@ class LT_PMBusDevice
 
 
   public:
-    virtual ~LT_PMBusDevice(){}
+    virtual ~LT_PMBusDevice();
 
     LT_PMBus *pmbus();
 
@@ -76,6 +79,7 @@ class LT_PMBusDevice
     //! @return address
     uint8_t getAddress ();
 
+    //! Get the part name (not to be freed)
     virtual char *getType(void);
 
     virtual uint8_t getNumPages(void) = 0;
@@ -116,11 +120,15 @@ class LT_PMBusDevice
     // Wait for the device to be available and not busy
     virtual void waitForAckNotBusy();
 
+    //! Get the fault log handler owned by this device. Its log buffer is reused by every read.
+    //! @return handler or NULL if the device has no fault log
+    LT_FaultLog *faultLog();
+
     //! Enable the Fault Log
-    virtual void enableFaultLog() {}
+    virtual void enableFaultLog();
 
     //! Disable the Fault Log
-    virtual void disableFaultLog() {}
+    virtual void disableFaultLog();
 
     //! Is there a fault log?
     //! @return true/false
@@ -131,12 +139,13 @@ class LT_PMBusDevice
     virtual char *getFaultLog();
 
     //! Print the fault log text
-    virtual void printFaultLog() {};
+    virtual void printFaultLog();
 
     //! Clear the Fault Log
-    virtual void clearFaultLog() {}
+    virtual void clearFaultLog();
 
-    virtual void storeFaultLog() {}
+    //! Store the Fault Log
+    virtual void storeFaultLog();
 
     /*
      * Set the output voltage of a polyphase rail
@@ -48,51 +48,20 @@ class LT_PMBusDeviceController : public LT_PMBusDevice
     LT_PMBusRail **getRails()
     {
       LT_PMBusRail **rails = NULL;
-      tRailDef **railDef0 = NULL;
-      tRailDef **railDef1 = NULL;
-      void *m;
+      uint8_t pages0[2] = {0, 1};
+      uint8_t page1 = 1;
+      uint8_t no_pages0 = 1;
+      bool multiphase0, multiphase1 = false;
       uint8_t rail_address, last_rail_address;
       uint8_t no_rails = 0;
 //    Serial.println("controller get rails ");
 
-      no_rails = 0;
+      no_rails = 1;
       pmbus_->setPage(address_, 0);
       last_rail_address = (rail_address = pmbus_->getRailAddress(address_));
-      if (rail_address == 0x80)
-      {
-        railDef0 = (tRailDef **)malloc(2*sizeof(tRailDef *));
-        railDef0[1] = NULL;
-        railDef0[0] = new tRailDef;
-        railDef0[0]->address = address_;
-        railDef0[0]->pages = (uint8_t *) malloc(1);
-        railDef0[0]->pages[0] = 0;
-        railDef0[0]->noOfPages = 1;
-        railDef0[0]->controller = true;
-        railDef0[0]->multiphase = false;
-        railDef0[0]->capabilities = getCapabilities();
+      multiphase0 = rail_address != 0x80;
+      if (!multiphase0)
         last_rail_address = address_;
-        no_rails++;
-      }
-      else
-      {
-        m = malloc(2*sizeof(tRailDef *));
-        if (m == NULL)
-          free(m);
-        else
-        {
-          railDef0 = (tRailDef **)m;
-          railDef0[1] = NULL;
-          railDef0[0] = new tRailDef;
-          railDef0[0]->address = address_;
-          railDef0[0]->pages = (uint8_t *) malloc(1);
-          railDef0[0]->pages[0] = 0;
-          railDef0[0]->noOfPages = 1;
-          railDef0[0]->controller = true;
-          railDef0[0]->multiphase = true;
-          railDef0[0]->capabilities = getCapabilities();
-        }
-        no_rails++;
-      }
 
       if (no_pages_ > 0) // Only handles 1/2 channel controllers
       {
@@ -100,67 +69,24 @@ class LT_PMBusDeviceController : public LT_PMBusDevice
         rail_address = pmbus_->getRailAddress(address_);
         if (rail_address == 0x80)
         {
-          m = malloc(2*sizeof(tRailDef *));
-          if (m == NULL)
-            free(m);
-          else
-          {
-            railDef1 = (tRailDef **)m;
-            railDef1[1] = NULL;
-            railDef1[0] = new tRailDef;
-            railDef1[0]->address = address_;
-            railDef1[0]->pages = (uint8_t *) malloc(1);
-            railDef1[0]->pages[0] = 1;
-            railDef1[0]->noOfPages = 1;
-            railDef1[0]->controller = true;
-            railDef1[0]->multiphase = false;
-            railDef1[0]->capabilities = getCapabilities();
-            rail_address = address_;
-          }
+          rail_address = address_;
           no_rails++;
         }
+        else if (last_rail_address == rail_address) // Both pages in same rail.
+          no_pages0 = 2;
         else
         {
-          if (last_rail_address == rail_address) // Both pages in same rail.
-          {
-            railDef0[0]->pages = (uint8_t *) realloc(railDef0[0]->pages, 2);
-            railDef0[0]->pages[1] = 1;
-            railDef0[0]->noOfPages = 2;
-          }
-          else
-          {
-            m = malloc(2 *sizeof(tRailDef *));
-            if (m == NULL)
-              free(m);
-            else
-            {
-              railDef1 = (tRailDef **)m;
-              railDef1[1] = NULL;
-              railDef1[0] = new tRailDef;
-              railDef1[0]->address = address_;
-              railDef1[0]->pages = (uint8_t *) malloc(1);
-              railDef1[0]->pages[0] = 1;
-              railDef1[0]->noOfPages = 1;
-              railDef1[0]->controller = true;
-              railDef1[0]->multiphase = true;
-              railDef1[0]->capabilities = getCapabilities();
-            }
-            no_rails++;
-          }
-        }
-      }
-
-      if (no_rails > 0)
-      {
-        rails = (LT_PMBusRail **) malloc((no_rails + 1) * sizeof(LT_PMBusRail *));
-        rails[0] = new LT_PMBusRail(pmbus_, last_rail_address, railDef0);
-
-        if (no_rails > 1)
-        {
-          rails[1] = new LT_PMBusRail(pmbus_, rail_address, railDef1); // Will cause problems when freeing.
+          multiphase1 = true;
+          no_rails++;
         }
       }
 
+      rails = (LT_PMBusRail **) malloc((no_rails + 1) * sizeof(LT_PMBusRail *));
+      if (rails == NULL)
+        return NULL;
+      rails[0] = new LT_PMBusRail(pmbus_, last_rail_address, address_, pages0, no_pages0, true, multiphase0, getCapabilities());
+      if (no_rails > 1)
+        rails[1] = new LT_PMBusRail(pmbus_, rail_address, address_, &page1, 1, true, multiphase1, getCapabilities());
       rails[no_rails] = NULL;
       return rails;
     }
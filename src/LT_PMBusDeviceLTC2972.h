@@ -39,6 +39,7 @@ class LT_PMBusDeviceLTC2972 : public LT_PMBusDeviceManager
 
     LT_PMBusDeviceLTC2972(LT_PMBus *pmbus, uint8_t address) : LT_PMBusDeviceManager(pmbus, address, 2)
     {
+      faultLog_ = new LT_2972FaultLog(pmbus);
     }
 
     void reset()
@@ -65,9 +66,7 @@ class LT_PMBusDeviceLTC2972 : public LT_PMBusDeviceManager
 
     char *getType(void)
     {
-      uint8_t *model = (uint8_t *) calloc(8,1);
-      memcpy(model, "LTC2972", 7);
-      return (char *) model;
+      return (char *) "LTC2972";
     }
 
     uint8_t getNumPages(void)
@@ -90,96 +89,6 @@ class LT_PMBusDeviceLTC2972 : public LT_PMBusDeviceManager
       else
         return NULL;
     }
-
-   void enableFaultLog()
-    {
-      LT_2972FaultLog *faultLog = new LT_2972FaultLog(pmbus_);
-      faultLog->enableFaultLog(address_);
-      delete faultLog;
-    }
-
-    void disableFaultLog()
-    {
-      LT_2972FaultLog *faultLog = new LT_2972FaultLog(pmbus_);
-      faultLog->disableFaultLog(address_);
-      delete faultLog;
-    }
-
-    bool hasFaultLog()
-    {
-      LT_2972FaultLog *faultLog = new LT_2972FaultLog(pmbus_);
-      if (faultLog->hasFaultLog(address_))
-      {
-        delete faultLog;
-        return true;
-      }
-      else
-      {
-        delete faultLog;
-        return false;
-      }
-    }
-
-    char *getFaultLog()
-    {
-      LT_2972FaultLog *faultLog = new LT_2972FaultLog(pmbus_);
-      if (faultLog->hasFaultLog(address_))
-      {
-        faultLog->read(address_);
-        faultLog->print();
-//        faultLog->dumpBinary();
-//        faultLog->release();
-        delete faultLog;
-        return NULL;
-      }
-      else
-      {
-        delete faultLog;
-        return NULL;
-      }
-    }
-
-    void printFaultLog()
-    {
-      LT_2972FaultLog *faultLog = new LT_2972FaultLog(pmbus_);
-      if (faultLog->hasFaultLog(address_))
-      {
-        faultLog->read(address_);
-        faultLog->print();
-//        faultLog->dumpBinary();
-        faultLog->release();
-        delete faultLog;
-      }
-    }
-
-    void clearFaultLog()
-    {
-      LT_2972FaultLog *faultLog = new LT_2972FaultLog(pmbus_);
-      if (faultLog->hasFaultLog(address_))
-      {
-        faultLog->clearFaultLog(address_);
-        delete faultLog;
-      }
-      else
-      {
-        delete faultLog;
-      }
-    }
-
-    void storeFaultLog()
-    {
-      LT_2972FaultLog *faultLog = new LT_2972FaultLog(pmbus_);
-      if (!faultLog->hasFaultLog(address_))
-      {
-        faultLog->storeFaultLog(address_);
-        delete faultLog;
-      }
-      else
-      {
-        delete faultLog;
-      }
-    }
-
 };
 
 #endif /* LT_PMBusDeviceLTC2972_H_ */
@@ -42,6 +42,7 @@ class LT_PMBusDeviceLTC2978 : public LT_PMBusDeviceManager
 
     LT_PMBusDeviceLTC2978(LT_PMBus *pmbus, uint8_t address) : LT_PMBusDeviceManager(pmbus, address, 8)
     {
+      faultLog_ = new LT_2978FaultLog(pmbus);
     }
 
     void reset()
@@ -68,9 +69,7 @@ class LT_PMBusDeviceLTC2978 : public LT_PMBusDeviceManager
 
     char *getType(void)
     {
-      uint8_t *model = (uint8_t *) calloc(8,1);
-      memcpy(model, "LTC2978", 7);
-      return (char *) model;
+      return (char *) "LTC2978";
     }
 
     uint8_t getNumPages(void)
@@ -94,95 +93,6 @@ class LT_PMBusDeviceLTC2978 : public LT_PMBusDeviceManager
       else
         return NULL;
     }
-
-    void enableFaultLog()
-    {
-      LT_2978FaultLog *faultLog = new LT_2978FaultLog(pmbus_);
-      faultLog->enableFaultLog(address_);
-      delete faultLog;
-    }
-
-    void disableFaultLog()
-    {
-      LT_2978FaultLog *faultLog = new LT_2978FaultLog(pmbus_);
-      faultLog->disableFaultLog(address_);
-      delete faultLog;
-    }
-
-    bool hasFaultLog()
-    {
-      LT_2978FaultLog *faultLog = new LT_2978FaultLog(pmbus_);
-      if (faultLog->hasFaultLog(address_))
-      {
-        delete faultLog;
-        return true;
-      }
-      else
-      {
-        delete faultLog;
-        return false;
-      }
-    }
-
-    char *getFaultLog()
-    {
-      LT_2978FaultLog *faultLog = new LT_2978FaultLog(pmbus_);
-      if (faultLog->hasFaultLog(address_))
-      {
-        faultLog->read(address_);
-//      faultLog->print();
-//        faultLog->dumpBinary();
-        faultLog->release();
-        delete faultLog;
-        return NULL;
-      }
-      else
-      {
-        delete faultLog;
-        return NULL;
-      }
-    }
-
-    void printFaultLog()
-    {
-      LT_2978FaultLog *faultLog = new LT_2978FaultLog(pmbus_);
-      if (faultLog->hasFaultLog(address_))
-      {
-        faultLog->read(address_);
-        faultLog->print();
-//        faultLog->dumpBinary();
-        faultLog->release();
-        delete faultLog;
-      }
-    }
-
-    void clearFaultLog()
-    {
-      LT_2978FaultLog *faultLog = new LT_2978FaultLog(pmbus_);
-      if (faultLog->hasFaultLog(address_))
-      {
-        faultLog->clearFaultLog(address_);
-        delete faultLog;
-      }
-      else
-      {
-        delete faultLog;
-      }
-    }
-
-    void storeFaultLog()
-    {
-      LT_2978FaultLog *faultLog = new LT_2978FaultLog(pmbus_);
-      if (!faultLog->hasFaultLog(address_))
-      {
-        faultLog->storeFaultLog(address_);
-        delete faultLog;
-      }
-      else
-      {
-        delete faultLog;
-      }
-    }
 };
 
 #endif /* LT_PMBusDeviceLTC2978_H_ */
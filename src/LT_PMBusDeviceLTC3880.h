@@ -43,6 +43,7 @@ class LT_PMBusDeviceLTC3880 : public LT_PMBusDeviceController
 
     LT_PMBusDeviceLTC3880(LT_PMBus *pmbus, uint8_t address) : LT_PMBusDeviceController(pmbus, address, 2)
     {
+      faultLog_ = new LT_3880FaultLog(pmbus);
     }
 
     static LT_PMBusDevice *detect(LT_PMBus *pmbus, uint8_t address)
@@ -95,95 +96,6 @@ class LT_PMBusDeviceLTC3880 : public LT_PMBusDeviceController
     {
       return 2;
     }
-
-    void enableFaultLog()
-    {
-      LT_3880FaultLog *faultLog = new LT_3880FaultLog(pmbus_);
-      faultLog->enableFaultLog(address_);
-      delete faultLog;
-    }
-
-    void disableFaultLog()
-    {
-      LT_3880FaultLog *faultLog = new LT_3880FaultLog(pmbus_);
-      faultLog->disableFaultLog(address_);
-      delete faultLog;
-    }
-
-    bool hasFaultLog()
-    {
-      LT_3880FaultLog *faultLog = new LT_3880FaultLog(pmbus_);
-      if (faultLog->hasFaultLog(address_))
-      {
-        delete faultLog;
-        return true;
-      }
-      else
-      {
-        delete faultLog;
-        return false;
-      }
-    }
-
-    char *getFaultLog()
-    {
-      LT_3880FaultLog *faultLog = new LT_3880FaultLog(pmbus_);
-      if (faultLog->hasFaultLog(address_))
-      {
-        faultLog->read(address_);
-//        faultLog->print();
-//        faultLog->dumpBinary();
-        faultLog->release();
-        delete faultLog;
-        return NULL;
-      }
-      else
-      {
-        delete faultLog;
-        return NULL;
-      }
-    }
-
-    void printFaultLog()
-    {
-      LT_3880FaultLog *faultLog = new LT_3880FaultLog(pmbus_);
-      if (faultLog->hasFaultLog(address_))
-      {
-        faultLog->read(address_);
-        faultLog->print();
-//        faultLog->dumpBinary();
-        faultLog->release();
-        delete faultLog;
-      }
-    }
-
-    void clearFaultLog()
-    {
-      LT_3880FaultLog *faultLog = new LT_3880FaultLog(pmbus_);
-      if (faultLog->hasFaultLog(address_))
-      {
-        faultLog->clearFaultLog(address_);
-        delete faultLog;
-      }
-      else
-      {
-        delete faultLog;
-      }
-    }
-
-    void storeFaultLog()
-    {
-      LT_3880FaultLog *faultLog = new LT_3880FaultLog(pmbus_);
-      if (!faultLog->hasFaultLog(address_))
-      {
-        faultLog->storeFaultLog(address_);
-        delete faultLog;
-      }
-      else
-      {
-        delete faultLog;
-      }
-    }
 };
 
 #endif /* LT_PMBusDeviceLTC3880_H_ */
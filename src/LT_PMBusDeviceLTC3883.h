@@ -42,6 +42,7 @@ class LT_PMBusDeviceLTC3883 : public LT_PMBusDeviceController
 
     LT_PMBusDeviceLTC3883(LT_PMBus *pmbus, uint8_t address) : LT_PMBusDeviceController(pmbus, address, 1)
     {
+      faultLog_ = new LT_3883FaultLog(pmbus);
     }
 
     void reset()
@@ -91,95 +92,6 @@ class LT_PMBusDeviceLTC3883 : public LT_PMBusDeviceController
     {
       return 1;
     }
-
-    void enableFaultLog()
-    {
-      LT_3883FaultLog *faultLog = new LT_3883FaultLog(pmbus_);
-      faultLog->enableFaultLog(address_);
-      delete faultLog;
-    }
-
-    void disableFaultLog()
-    {
-      LT_3883FaultLog *faultLog = new LT_3883FaultLog(pmbus_);
-      faultLog->disableFaultLog(address_);
-      delete faultLog;
-    }
-
-    bool hasFaultLog()
-    {
-      LT_3883FaultLog *faultLog = new LT_3883FaultLog(pmbus_);
-      if (faultLog->hasFaultLog(address_))
-      {
-        delete faultLog;
-        return true;
-      }
-      else
-      {
-        delete faultLog;
-        return false;
-      }
-    }
-
-    char *getFaultLog()
-    {
-      LT_3883FaultLog *faultLog = new LT_3883FaultLog(pmbus_);
-      if (faultLog->hasFaultLog(address_))
-      {
-        faultLog->read(address_);
-//        faultLog->print();
-//        faultLog->dumpBinary();
-        faultLog->release();
-        delete faultLog;
-        return NULL;
-      }
-      else
-      {
-        delete faultLog;
-        return NULL;
-      }
-    }
-
-    void printFaultLog()
-    {
-      LT_3883FaultLog *faultLog = new LT_3883FaultLog(pmbus_);
-      if (faultLog->hasFaultLog(address_))
-      {
-        faultLog->read(address_);
-        faultLog->print();
-//        faultLog->dumpBinary();
-        faultLog->release();
-        delete faultLog;
-      }
-    }
-
-    void clearFaultLog()
-    {
-      LT_3883FaultLog *faultLog = new LT_3883FaultLog(pmbus_);
-      if (faultLog->hasFaultLog(address_))
-      {
-        faultLog->clearFaultLog(address_);
-        delete faultLog;
-      }
-      else
-      {
-        delete faultLog;
-      }
-    }
-
-    void storeFaultLog()
-    {
-      LT_3883FaultLog *faultLog = new LT_3883FaultLog(pmbus_);
-      if (!faultLog->hasFaultLog(address_))
-      {
-        faultLog->storeFaultLog(address_);
-        delete faultLog;
-      }
-      else
-      {
-        delete faultLog;
-      }
-    }
 };
 
 #endif /* LT_PMBusDeviceLTC3883_H_ */
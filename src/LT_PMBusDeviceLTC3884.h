@@ -40,6 +40,7 @@ class LT_PMBusDeviceLTC3884 : public LT_PMBusDeviceController
 
     LT_PMBusDeviceLTC3884(LT_PMBus *pmbus, uint8_t address) : LT_PMBusDeviceController(pmbus, address, 2)
     {
+      faultLog_ = new LT_3884FaultLog(pmbus);
     }
 
     static LT_PMBusDevice *detect(LT_PMBus *pmbus, uint8_t address)
@@ -90,95 +91,6 @@ class LT_PMBusDeviceLTC3884 : public LT_PMBusDeviceController
     {
       return 2;
     }
-
-    void enableFaultLog()
-    {
-      LT_3884FaultLog *faultLog = new LT_3884FaultLog(pmbus_);
-      faultLog->enableFaultLog(address_);
-      delete faultLog;
-    }
-
-    void disableFaultLog()
-    {
-      LT_3884FaultLog *faultLog = new LT_3884FaultLog(pmbus_);
-      faultLog->disableFaultLog(address_);
-      delete faultLog;
-    }
-
-    bool hasFaultLog()
-    {
-      LT_3884FaultLog *faultLog = new LT_3884FaultLog(pmbus_);
-      if (faultLog->hasFaultLog(address_))
-      {
-        delete faultLog;
-        return true;
-      }
-      else
-      {
-        delete faultLog;
-        return false;
-      }
-    }
-
-    char *getFaultLog()
-    {
-      LT_3884FaultLog *faultLog = new LT_3884FaultLog(pmbus_);
-      if (faultLog->hasFaultLog(address_))
-      {
-        faultLog->read(address_);
-//        faultLog->print();
-//        faultLog->dumpBinary();
-        faultLog->release();
-        delete faultLog;
-        return NULL;
-      }
-      else
-      {
-        delete faultLog;
-        return NULL;
-      }
-    }
-
-    void printFaultLog()
-    {
-      LT_3884FaultLog *faultLog = new LT_3884FaultLog(pmbus_);
-      if (faultLog->hasFaultLog(address_))
-      {
-        faultLog->read(address_);
-        faultLog->print();
-//        faultLog->dumpBinary();
-        faultLog->release();
-        delete faultLog;
-      }
-    }
-
-    void clearFaultLog()
-    {
-      LT_3884FaultLog *faultLog = new LT_3884FaultLog(pmbus_);
-      if (faultLog->hasFaultLog(address_))
-      {
-        faultLog->clearFaultLog(address_);
-        delete faultLog;
-      }
-      else
-      {
-        delete faultLog;
-      }
-    }
-
-    void storeFaultLog()
-    {
-      LT_3884FaultLog *faultLog = new LT_3884FaultLog(pmbus_);
-      if (!faultLog->hasFaultLog(address_))
-      {
-        faultLog->storeFaultLog(address_);
-        delete faultLog;
-      }
-      else
-      {
-        delete faultLog;
-      }
-    }
 };
 
 #endif /* LT_PMBusDeviceLTC3884_H_ */
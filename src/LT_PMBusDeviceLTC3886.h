@@ -40,6 +40,7 @@ class LT_PMBusDeviceLTC3886 : public LT_PMBusDeviceController
 
     LT_PMBusDeviceLTC3886(LT_PMBus *pmbus, uint8_t address) : LT_PMBusDeviceController(pmbus, address, 2)
     {
+      faultLog_ = new LT_3886FaultLog(pmbus);
     }
 
     static LT_PMBusDevice *detect(LT_PMBus *pmbus, uint8_t address)
@@ -89,97 +90,6 @@ class LT_PMBusDeviceLTC3886 : public LT_PMBusDeviceController
     {
       return 2;
     }
-
-    void enableFaultLog()
-    {
-      LT_3886FaultLog *faultLog = new LT_3886FaultLog(pmbus_);
-      faultLog->enableFaultLog(address_);
-      delete faultLog;
-    }
-
-    void disableFaultLog()
-    {
-      LT_3886FaultLog *faultLog = new LT_3886FaultLog(pmbus_);
-      faultLog->disableFaultLog(address_);
-      delete faultLog;
-    }
-
-    bool hasFaultLog()
-    {
-      LT_3886FaultLog *faultLog = new LT_3886FaultLog(pmbus_);
-      if (faultLog->hasFaultLog(address_))
-      {
-        delete faultLog;
-        return true;
-      }
-      else
-      {
-        delete faultLog;
-        return false;
-      }
-    }
-
-    char *getFaultLog()
-    {
-      LT_3886FaultLog *faultLog = new LT_3886FaultLog(pmbus_);
-      if (faultLog->hasFaultLog(address_))
-      {
-        printf("fetch LTC3886 FL\n");
-        faultLog->read(address_);
-//        faultLog->print();
-//        faultLog->dumpBinary();
-        faultLog->release();
-        delete faultLog;
-        return NULL;
-      }
-      else
-      {
-        delete faultLog;
-        return NULL;
-      }
-    }
-
-    void printFaultLog()
-    {
-      LT_3886FaultLog *faultLog = new LT_3886FaultLog(pmbus_);
-      if (faultLog->hasFaultLog(address_))
-      {
-        faultLog->read(address_);
-        faultLog->print();
-//        faultLog->dumpBinary();
-        faultLog->release();
-        delete faultLog;
-      }
-    }
-
-    void clearFaultLog()
-    {
-      LT_3886FaultLog *faultLog = new LT_3886FaultLog(pmbus_);
-      if (faultLog->hasFaultLog(address_))
-      {
-        faultLog->clearFaultLog(address_);
-        delete faultLog;
-      }
-      else
-      {
-        delete faultLog;
-      }
-    }
-
-    void storeFaultLog()
-    {
-      LT_3886FaultLog *faultLog = new LT_3886FaultLog(pmbus_);
-      if (!faultLog->hasFaultLog(address_))
-      {
-        faultLog->storeFaultLog(address_);
-        delete faultLog;
-      }
-      else
-      {
-        delete faultLog;
-      }
-    }
-
 };
 
 #endif /* LT_PMBusDeviceLTC3886_H_ */
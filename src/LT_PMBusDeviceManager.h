@@ -53,24 +53,11 @@ class LT_PMBusDeviceManager : public LT_PMBusDevice
     LT_PMBusRail **getRails()
     {
       LT_PMBusRail **rails = NULL;
-      tRailDef **railDef = NULL;
       uint8_t i;
       rails = (LT_PMBusRail **) malloc((no_pages_ + 1) * sizeof(LT_PMBusRail *));
 
       for (i = 0; i < no_pages_; i++)
-      {
-        railDef = (tRailDef **)malloc((no_pages_ + 1) * sizeof(tRailDef *));
-        railDef[0] = new tRailDef;
-        railDef[0]->address = address_;
-        railDef[0]->pages = (uint8_t *) malloc(sizeof(uint8_t));
-        railDef[0]->pages[0] = i;
-        railDef[0]->noOfPages = 1;
-        railDef[0]->controller = false;
-        railDef[0]->multiphase = false;
-        railDef[0]->capabilities = getCapabilities();
-        railDef[1] = NULL;
-        rails[i] = new LT_PMBusRail(pmbus_, railDef[0]->address, railDef);
-      }
+        rails[i] = new LT_PMBusRail(pmbus_, address_, address_, &i, 1, false, false, getCapabilities());
 
       rails[no_pages_] = NULL;
       return rails;
@@ -26,7 +26,15 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include <stdint.h>
+#include <string.h>
 #include "LT_PMBusMath.h"
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
     
 // +---------------------------------------------------------------------------+
 // |               Define the Bit Widths and Exponent Properties               |
@@ -392,6 +400,9 @@ LT_PMBusMath::lin11_t LT_PMBusMath::fl32_to_lin11 (LT_PMBusMath::fl32_t xin)
 // |      Versions of the fl32_t Conversion Functions Interpreted as Float     |
 // +---------------------------------------------------------------------------+
 // |                                                                           |
+// |  The float is copied as 32 bits; fl32_t is wider than float on 64 bit     |
+// |  hosts.                                                                   |
+// |                                                                           |
 // |  NOTE: The functions below are for convenience only and are not as fast   |
 // |  as calling the binary functions directly with the appropriate pointer    |
 // |  assignments.                                                             |
@@ -401,35 +412,176 @@ LT_PMBusMath::lin11_t LT_PMBusMath::fl32_to_lin11 (LT_PMBusMath::fl32_t xin)
 // PMBus Linear11 to Single Precision Float
 float LT_PMBusMath::lin11_to_float (LT_PMBusMath::lin11_t xin)
 {
-  LT_PMBusMath::fl32_t  xout;
-  xout = lin11_to_fl32(xin);
-  return *((float *) &xout);
+  uint32_t  xout;
+  float     result;
+  xout = (uint32_t) lin11_to_fl32(xin);
+  memcpy(&result, &xout, sizeof(result));
+  return result;
 }
 
 // PMBus Linear16 to Single Precision Float
 float LT_PMBusMath::lin16_to_float (LT_PMBusMath::lin16_t lin16_mant, LT_PMBusMath::lin16m_t vout_mode)
 {
-  LT_PMBusMath::fl32_t  xout;
-  xout = lin16_to_fl32(lin16_mant, vout_mode);
-  return *((float *) &xout);
+  uint32_t  xout;
+  float     result;
+  xout = (uint32_t) lin16_to_fl32(lin16_mant, vout_mode);
+  memcpy(&result, &xout, sizeof(result));
+  return result;
 }
 
 // Single Precision Float to PMBus Linear11
 LT_PMBusMath::lin11_t LT_PMBusMath::float_to_lin11 (float xin)
 {
-  LT_PMBusMath::fl32_t  xin_fl32;
-  xin_fl32 = *((fl32_t *) &xin);
+  uint32_t  xin_fl32;
+  memcpy(&xin_fl32, &xin, sizeof(xin_fl32));
   return fl32_to_lin11(xin_fl32);
 }
 
 // Single Precision Float to PMBus Linear16
 LT_PMBusMath::lin16_t LT_PMBusMath::float_to_lin16 (float xin, LT_PMBusMath::lin16m_t vout_mode)
 {
-  LT_PMBusMath::fl32_t  xin_fl32;
-  xin_fl32 = *((fl32_t *) &xin);
+  uint32_t  xin_fl32;
+  memcpy(&xin_fl32, &xin, sizeof(xin_fl32));
   return fl32_to_lin16 (xin_fl32, vout_mode);
 }
 
 
+// +---------------------------------------------------------------------------+
+// |                  Batch Linear11/Linear16 --> Float Conversion             |
+// +---------------------------------------------------------------------------+
+// |                                                                           |
+// |  Every Linear11 and Linear16 value is a mantissa of at most 16 bits times |
+// |  a power of two within the normal Float32 range, so mantissa * 2^exp is   |
+// |  exact and equals the result of the bit by bit conversion above. The     |
+// |  mantissa and exponent are sign extended with shifts, the power of two   |
+// |  is built in the exponent field, and there are no branches per value.    |
+// |  Vector paths are chosen at compile time, remaining values use the       |
+// |  scalar path.                                                             |
+// |                                                                           |
+// +---------------------------------------------------------------------------+
+
+// Float with the value 2^exp, for exp within the normal Float32 range
+static inline float pow2_to_float (int32_t exp)
+{
+  uint32_t  bits;
+  float     xout;
+  bits = ((uint32_t) (exp + fl32_exp_bias)) << fl32_mant_width;
+  memcpy(&xout, &bits, sizeof(xout));
+  return xout;
+}
+
+// Signed exponent of a VOUT_MODE
+static inline int32_t lin16_mode_to_exp (LT_PMBusMath::lin16m_t vout_mode)
+{
+  return ((int32_t) ((uint32_t) vout_mode << (32 - lin16_exp_width))) >> (32 - lin16_exp_width);
+}
+
+static inline float lin11_to_float_scalar (uint16_t xin)
+{
+  int32_t   mant, exp;
+  mant = ((int32_t) ((uint32_t) xin << (32 - lin11_mant_width))) >> (32 - lin11_mant_width);
+  exp  = ((int32_t) ((uint32_t) xin << (32 - lin11_width))) >> (32 - lin11_exp_width);
+  return (float) mant * pow2_to_float(exp);
+}
+
+void LT_PMBusMath::lin11_to_float_n (const uint16_t *xin, float *xout, size_t n)
+{
+  size_t    i = 0;
+
+#if defined(__AVX2__)
+  const __m256i bias = _mm256_set1_epi32(fl32_exp_bias);
+  for (; i + 8 <= n; i += 8)
+  {
+    __m256i x = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *) (xin + i)));
+    __m256i mant = _mm256_srai_epi32(_mm256_slli_epi32(x, 32 - lin11_mant_width), 32 - lin11_mant_width);
+    __m256i exp = _mm256_srai_epi32(_mm256_slli_epi32(x, 32 - lin11_width), 32 - lin11_exp_width);
+    __m256 scale = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(exp, bias), fl32_mant_width));
+    _mm256_storeu_ps(xout + i, _mm256_mul_ps(_mm256_cvtepi32_ps(mant), scale));
+  }
+#elif defined(__SSE2__)
+  const __m128i bias = _mm_set1_epi32(fl32_exp_bias);
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 8 <= n; i += 8)
+  {
+    __m128i x16 = _mm_loadu_si128((const __m128i *) (xin + i));
+    __m128i x[2] = {_mm_unpacklo_epi16(x16, zero), _mm_unpackhi_epi16(x16, zero)};
+    for (int h = 0; h < 2; h++)
+    {
+      __m128i mant = _mm_srai_epi32(_mm_slli_epi32(x[h], 32 - lin11_mant_width), 32 - lin11_mant_width);
+      __m128i exp = _mm_srai_epi32(_mm_slli_epi32(x[h], 32 - lin11_width), 32 - lin11_exp_width);
+      __m128 scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(exp, bias), fl32_mant_width));
+      _mm_storeu_ps(xout + i + 4 * h, _mm_mul_ps(_mm_cvtepi32_ps(mant), scale));
+    }
+  }
+#elif defined(__ARM_NEON)
+  const int32x4_t bias = vdupq_n_s32(fl32_exp_bias);
+  for (; i + 8 <= n; i += 8)
+  {
+    uint16x8_t x16 = vld1q_u16(xin + i);
+    int32x4_t x[2] = {vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(x16))),
+                      vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(x16)))
+                     };
+    for (int h = 0; h < 2; h++)
+    {
+      int32x4_t mant = vshrq_n_s32(vshlq_n_s32(x[h], 32 - lin11_mant_width), 32 - lin11_mant_width);
+      int32x4_t exp = vshrq_n_s32(vshlq_n_s32(x[h], 32 - lin11_width), 32 - lin11_exp_width);
+      float32x4_t scale = vreinterpretq_f32_s32(vshlq_n_s32(vaddq_s32(exp, bias), fl32_mant_width));
+      vst1q_f32(xout + i + 4 * h, vmulq_f32(vcvtq_f32_s32(mant), scale));
+    }
+  }
+#endif
+
+  for (; i < n; i++)
+    xout[i] = lin11_to_float_scalar(xin[i]);
+}
+
+void LT_PMBusMath::lin16_to_float_n (const uint16_t *lin16_mant, float *xout, size_t n, LT_PMBusMath::lin16m_t vout_mode)
+{
+  const float scale = pow2_to_float(lin16_mode_to_exp(vout_mode));
+  size_t    i = 0;
+
+#if defined(__AVX2__)
+  const __m256 vscale = _mm256_set1_ps(scale);
+  for (; i + 8 <= n; i += 8)
+  {
+    __m256i x = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *) (lin16_mant + i)));
+    _mm256_storeu_ps(xout + i, _mm256_mul_ps(_mm256_cvtepi32_ps(x), vscale));
+  }
+#elif defined(__SSE2__)
+  const __m128 vscale = _mm_set1_ps(scale);
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 8 <= n; i += 8)
+  {
+    __m128i x16 = _mm_loadu_si128((const __m128i *) (lin16_mant + i));
+    _mm_storeu_ps(xout + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(x16, zero)), vscale));
+    _mm_storeu_ps(xout + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(x16, zero)), vscale));
+  }
+#elif defined(__ARM_NEON)
+  const float32x4_t vscale = vdupq_n_f32(scale);
+  for (; i + 8 <= n; i += 8)
+  {
+    uint16x8_t x16 = vld1q_u16(lin16_mant + i);
+    vst1q_f32(xout + i, vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(x16))), vscale));
+    vst1q_f32(xout + i + 4, vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(x16))), vscale));
+  }
+#endif
+
+  for (; i < n; i++)
+    xout[i] = (float) lin16_mant[i] * scale;
+}
+
+// The single value encoders are constant time bit manipulation already
+void LT_PMBusMath::float_to_lin11_n (const float *xin, uint16_t *xout, size_t n)
+{
+  for (size_t i = 0; i < n; i++)
+    xout[i] = (uint16_t) float_to_lin11(xin[i]);
+}
+
+void LT_PMBusMath::float_to_lin16_n (const float *xin, uint16_t *xout, size_t n, LT_PMBusMath::lin16m_t vout_mode)
+{
+  for (size_t i = 0; i < n; i++)
+    xout[i] = (uint16_t) float_to_lin16(xin[i], vout_mode);
+}
+
 
 LT_PMBusMath math_ = LT_PMBusMath();
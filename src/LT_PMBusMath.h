@@ -28,6 +28,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef LT_PMBusMath_H_
 #define LT_PMBusMath_H_
 
+#include <stdint.h>
+#include <stddef.h>
+
 class LT_PMBusMath
 {
 
@@ -50,6 +53,12 @@ class LT_PMBusMath
     lin11_t float_to_lin11 (float xin);
     lin16_t float_to_lin16 (float xin, lin16m_t vout_mode);
 
+    // Batch versions, bit exact with the single value conversions
+    void lin11_to_float_n (const uint16_t *xin, float *xout, size_t n);
+    void lin16_to_float_n (const uint16_t *lin16_mant, float *xout, size_t n, lin16m_t vout_mode);
+    void float_to_lin11_n (const float *xin, uint16_t *xout, size_t n);
+    void float_to_lin16_n (const float *xin, uint16_t *xout, size_t n, lin16m_t vout_mode);
+
 };
 
 extern LT_PMBusMath math_;
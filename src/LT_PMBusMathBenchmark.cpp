@@ -0,0 +1,435 @@
+/*
+Copyright (c) 2020, Analog Devices Inc
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  * Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  * Neither the name of the Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived from this
+    software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "LT_PMBusMathBenchmark.h"
+#include "LT_Clock.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#ifdef DMALLOC
+#include <dmalloc.h>
+#else
+#include <stdlib.h>
+#endif
+
+// Encoder inputs per range
+#define BENCH_RANGE_VALUES  262144
+// VOUT_MODE used for L16, 2^-12
+#define BENCH_VOUT_MODE     0x14
+
+/*
+ * The float to L11/L16 conversions as they were, searching for the exponent,
+ * to check the constant time ones against.
+ */
+static uint16_t float_to_l11_search(float input_val)
+{
+  int exponent = -16;
+  int mantissa = (int)(input_val / pow(2.0, exponent));
+
+  do
+  {
+    if ((mantissa >= -1024) && (mantissa <= +1023))
+      break;
+    exponent++;
+    mantissa = (int)(input_val / pow(2.0, exponent));
+  }
+  while (exponent < +15);
+
+  return (exponent << 11) | (mantissa & 0x07FF);
+}
+
+static uint16_t float_to_l16_pow(uint8_t vout_mode, float input_val)
+{
+  int8_t exponent = vout_mode & 0x1F;
+
+  if (exponent > 0x0F) exponent |= 0xE0;
+  return (uint16_t)(input_val / pow(2.0, exponent));
+}
+
+LT_PMBusMathBenchmark::LT_PMBusMathBenchmark()
+{
+  valueCnt_ = 4 * BENCH_RANGE_VALUES;
+  values_ = (float *) malloc(valueCnt_ * sizeof(float));
+  encoded_ = (uint16_t *) malloc(valueCnt_ * sizeof(uint16_t));
+  decoded_ = (float *) malloc(valueCnt_ * sizeof(float));
+  words_ = (uint16_t *) malloc(65536 * sizeof(uint16_t));
+  failures_ = 0;
+}
+
+LT_PMBusMathBenchmark::~LT_PMBusMathBenchmark()
+{
+  free(values_);
+  free(encoded_);
+  free(decoded_);
+  free(words_);
+}
+
+void LT_PMBusMathBenchmark::report(const char *name, uint64_t ns, size_t count, double maxError, const char *unit)
+{
+  printf("%-36s %8lu values %8.2f ns/value  max error %.3g%s\n", name, (unsigned long) count,
+         (double) ns / count, maxError, unit);
+}
+
+/*
+ * Make the encoder inputs
+ *
+ * Voltages in [0.3, 15] V, log distributed, fit L16 with VOUT_MODE 2^-12.
+ * Currents in [-100, 100] A, temperatures in [-40, 150] C, and times in
+ * [0.001, 1000] ms, log distributed. A fixed LCG makes runs comparable.
+ */
+void LT_PMBusMathBenchmark::makeValues()
+{
+  uint32_t seed = 12345;
+  double r;
+
+  for (size_t i = 0; i < BENCH_RANGE_VALUES; i++)
+  {
+    seed = seed * 1664525 + 1013904223;
+    r = (double) seed / 4294967296.0;
+    values_[i] = 0.3 * pow(50.0, r);
+    values_[i + BENCH_RANGE_VALUES] = -100.0 + 200.0 * r;
+    values_[i + 2 * BENCH_RANGE_VALUES] = -40.0 + 190.0 * r;
+    values_[i + 3 * BENCH_RANGE_VALUES] = 0.001 * pow(1e6, r);
+  }
+}
+
+/*
+ * Decoders over all 16 bit words
+ *
+ * Every L11 and L16 value is exact in float, so any difference to the exact
+ * value is a failure. Each exact value must also survive a round trip through
+ * the encoders.
+ */
+void LT_PMBusMathBenchmark::benchDecoders()
+{
+  uint64_t start, ns;
+  double error, maxError;
+  uint32_t i, mode;
+  int32_t mantissa, exponent;
+  float value;
+
+  for (i = 0; i < 65536; i++)
+    words_[i] = i;
+
+  // L11, compared to the exact value.
+  start = LT_Clock::nowNs();
+  for (i = 0; i < 65536; i++)
+    decoded_[i] = math_.lin11_to_float(words_[i]);
+  ns = LT_Clock::nowNs() - start;
+  maxError = 0;
+  for (i = 0; i < 65536; i++)
+  {
+    mantissa = ((int32_t) (i << 21)) >> 21;
+    exponent = ((int32_t) (i << 16)) >> 27;
+    error = fabs(decoded_[i] - ldexp((double) mantissa, exponent));
+    if (error > 0)
+      failures_++;
+    if (error > maxError)
+      maxError = error;
+  }
+  report("LT_PMBusMath::lin11_to_float", ns, 65536, maxError, "");
+
+  start = LT_Clock::nowNs();
+  math_.lin11_to_float_n(words_, decoded_, 65536);
+  ns = LT_Clock::nowNs() - start;
+  maxError = 0;
+  for (i = 0; i < 65536; i++)
+  {
+    value = math_.lin11_to_float(words_[i]);
+    if (decoded_[i] != value)
+      failures_++;
+  }
+  report("LT_PMBusMath::lin11_to_float_n", ns, 65536, maxError, "");
+
+  start = LT_Clock::nowNs();
+  for (i = 0; i < 65536; i++)
+    decoded_[i] = LT_PMBus::L11_to_Float(words_[i]);
+  ns = LT_Clock::nowNs() - start;
+  maxError = 0;
+  for (i = 0; i < 65536; i++)
+  {
+    error = fabs(decoded_[i] - math_.lin11_to_float(words_[i]));
+    if (error > 0)
+      failures_++;
+    if (error > maxError)
+      maxError = error;
+  }
+  report("LT_PMBus::L11_to_Float", ns, 65536, maxError, "");
+
+  // L16, every VOUT_MODE.
+  start = LT_Clock::nowNs();
+  for (mode = 0; mode < 32; mode++)
+    for (i = 0; i < 65536; i++)
+      decoded_[i] = math_.lin16_to_float(words_[i], mode);
+  ns = LT_Clock::nowNs() - start;
+  report("LT_PMBusMath::lin16_to_float", ns, 32 * 65536, 0, "");
+
+  start = LT_Clock::nowNs();
+  for (mode = 0; mode < 32; mode++)
+    math_.lin16_to_float_n(words_, decoded_, 65536, mode);
+  ns = LT_Clock::nowNs() - start;
+  report("LT_PMBusMath::lin16_to_float_n", ns, 32 * 65536, 0, "");
+
+  start = LT_Clock::nowNs();
+  for (mode = 0; mode < 32; mode++)
+    for (i = 0; i < 65536; i++)
+      decoded_[i] = LT_PMBus::L16_to_Float_mode(mode, words_[i]);
+  ns = LT_Clock::nowNs() - start;
+  report("LT_PMBus::L16_to_Float_mode", ns, 32 * 65536, 0, "");
+
+  maxError = 0;
+  for (mode = 0; mode < 32; mode++)
+  {
+    exponent = ((int32_t) (mode << 27)) >> 27;
+    math_.lin16_to_float_n(words_, decoded_, 65536, mode);
+    for (i = 0; i < 65536; i++)
+    {
+      error = fabs(decoded_[i] - ldexp((double) i, exponent));
+      if (error > 0 || LT_PMBus::L16_to_Float_mode(mode, i) != decoded_[i])
+        failures_++;
+      if (error > maxError)
+        maxError = error;
+
+      // Round trips, L16 has one word per value.
+      if (math_.float_to_lin16(decoded_[i], mode) != i)
+        failures_++;
+      if (LT_PMBus::Float_to_L16_mode(mode, decoded_[i]) != i)
+        failures_++;
+    }
+  }
+  printf("%-36s %8lu values  max error %.3g\n", "L16 exact values and round trips", (unsigned long) 32 * 65536, maxError);
+
+  // L11 round trips. The word may differ, as a value has several L11 forms.
+  for (i = 0; i < 65536; i++)
+  {
+    value = math_.lin11_to_float(i);
+    if (math_.lin11_to_float(math_.float_to_lin11(value)) != value)
+      failures_++;
+    if (math_.lin11_to_float(LT_PMBus::Float_to_L11(value)) != value)
+      failures_++;
+  }
+}
+
+/*
+ * Check L11 words against the encoder inputs
+ *
+ * bound: relative error allowed. Below 2^-6 the exponent is fixed at -16 and
+ * the error allowed is absolute, bound * 2^-7.
+ * return: the largest relative error for values of 2^-6 and up
+ */
+double LT_PMBusMathBenchmark::checkL11(const uint16_t *encoded, double bound)
+{
+  double error, allowed, maxError = 0;
+
+  for (size_t i = 0; i < valueCnt_; i++)
+  {
+    error = fabs((double) math_.lin11_to_float(encoded[i]) - values_[i]);
+    allowed = fabs(values_[i]) * bound;
+    if (allowed < bound / 128)
+      allowed = bound / 128;
+    if (error > allowed)
+      failures_++;
+    if (fabs(values_[i]) >= 1.0 / 64 && error / fabs(values_[i]) > maxError)
+      maxError = error / fabs(values_[i]);
+  }
+  return maxError;
+}
+
+/*
+ * Check L16 words against the voltages
+ *
+ * bound: absolute error allowed
+ * return: the largest absolute error
+ */
+double LT_PMBusMathBenchmark::checkL16(const uint16_t *encoded, uint8_t vout_mode, double bound)
+{
+  double error, maxError = 0;
+
+  for (size_t i = 0; i < BENCH_RANGE_VALUES; i++)
+  {
+    error = fabs((double) math_.lin16_to_float(encoded[i], vout_mode) - values_[i]);
+    if (error > bound)
+      failures_++;
+    if (error > maxError)
+      maxError = error;
+  }
+  return maxError;
+}
+
+/*
+ * Encoders over the realistic ranges
+ *
+ * LT_PMBusMath rounds to nearest: half a step, 2^-10 relative for L11 and
+ * 2^-13 V for L16. LT_PMBus truncates: a whole step.
+ */
+void LT_PMBusMathBenchmark::benchEncoders()
+{
+  uint64_t start, ns;
+  size_t i;
+
+  start = LT_Clock::nowNs();
+  for (i = 0; i < valueCnt_; i++)
+    encoded_[i] = math_.float_to_lin11(values_[i]);
+  ns = LT_Clock::nowNs() - start;
+  report("LT_PMBusMath::float_to_lin11", ns, valueCnt_, checkL11(encoded_, 1.0 / 1024), " relative");
+
+  start = LT_Clock::nowNs();
+  math_.float_to_lin11_n(values_, encoded_, valueCnt_);
+  ns = LT_Clock::nowNs() - start;
+  report("LT_PMBusMath::float_to_lin11_n", ns, valueCnt_, checkL11(encoded_, 1.0 / 1024), " relative");
+
+  start = LT_Clock::nowNs();
+  for (i = 0; i < valueCnt_; i++)
+    encoded_[i] = LT_PMBus::Float_to_L11(values_[i]);
+  ns = LT_Clock::nowNs() - start;
+  report("LT_PMBus::Float_to_L11", ns, valueCnt_, checkL11(encoded_, 1.0 / 512), " relative");
+
+  start = LT_Clock::nowNs();
+  for (i = 0; i < BENCH_RANGE_VALUES; i++)
+    encoded_[i] = math_.float_to_lin16(values_[i], BENCH_VOUT_MODE);
+  ns = LT_Clock::nowNs() - start;
+  report("LT_PMBusMath::float_to_lin16", ns, BENCH_RANGE_VALUES,
+         checkL16(encoded_, BENCH_VOUT_MODE, 1.0 / 8192), " V");
+
+  start = LT_Clock::nowNs();
+  math_.float_to_lin16_n(values_, encoded_, BENCH_RANGE_VALUES, BENCH_VOUT_MODE);
+  ns = LT_Clock::nowNs() - start;
+  report("LT_PMBusMath::float_to_lin16_n", ns, BENCH_RANGE_VALUES,
+         checkL16(encoded_, BENCH_VOUT_MODE, 1.0 / 8192), " V");
+
+  start = LT_Clock::nowNs();
+  for (i = 0; i < BENCH_RANGE_VALUES; i++)
+    encoded_[i] = LT_PMBus::Float_to_L16_mode(BENCH_VOUT_MODE, values_[i]);
+  ns = LT_Clock::nowNs() - start;
+  report("LT_PMBus::Float_to_L16_mode", ns, BENCH_RANGE_VALUES,
+         checkL16(encoded_, BENCH_VOUT_MODE, 1.0 / 4096), " V");
+}
+
+uint32_t LT_PMBusMathBenchmark::run()
+{
+  failures_ = 0;
+  makeValues();
+  benchDecoders();
+  benchEncoders();
+  printf("%u conversions outside their error bound\n", failures_);
+  return failures_;
+}
+
+/*
+ * Compare the batch L11/L16 decoders with the scalar ones for every input
+ * and every VOUT_MODE exponent. Returns the number of values that differ.
+ */
+uint32_t LT_PMBusMathBenchmark::checkDecoders()
+{
+  uint32_t errors = 0;
+  uint32_t i, mode;
+  float expected;
+
+  for (i = 0; i < 65536; i++)
+    words_[i] = i;
+
+  math_.lin11_to_float_n(words_, decoded_, 65536);
+  for (i = 0; i < 65536; i++)
+  {
+    expected = math_.lin11_to_float(i);
+    if (memcmp(&expected, &decoded_[i], sizeof(float)) != 0)
+    {
+      printf("L11 0x%04x: %g, batch %g\n", i, expected, decoded_[i]);
+      errors++;
+    }
+  }
+
+  for (mode = 0; mode < 32; mode++)
+  {
+    math_.lin16_to_float_n(words_, decoded_, 65536, mode);
+    for (i = 0; i < 65536; i++)
+    {
+      expected = math_.lin16_to_float(i, mode);
+      if (memcmp(&expected, &decoded_[i], sizeof(float)) != 0)
+      {
+        printf("L16 0x%04x mode 0x%02x: %g, batch %g\n", i, mode, expected, decoded_[i]);
+        errors++;
+      }
+    }
+  }
+
+  return errors;
+}
+
+/*
+ * Compare the USE_FAST_MATH 0 encoders with the search for every float bit pattern. This takes
+ * several minutes. L16 is checked on every 65536th pattern for each VOUT_MODE.
+ * Returns the number of values that differ.
+ */
+uint32_t LT_PMBusMathBenchmark::checkEncoders()
+{
+  uint32_t errors = 0;
+  uint64_t bits;
+  uint32_t mode, pattern;
+  uint16_t word, expected;
+  float value;
+
+  for (bits = 0; bits <= 0xFFFFFFFF; bits++)
+  {
+    pattern = (uint32_t) bits;
+    memcpy(&value, &pattern, sizeof(float));
+    word = LT_PMBus::Float_to_L11(value);
+    expected = float_to_l11_search(value);
+    if (word != expected)
+    {
+      if (errors < 16)
+        printf("L11 %g: 0x%04x, search 0x%04x\n", value, word, expected);
+      errors++;
+    }
+    if ((pattern & 0x0FFFFFFF) == 0x0FFFFFFF)
+      printf("L11 encoder %u/16\n", (pattern >> 28) + 1);
+  }
+
+  for (mode = 0; mode < 32; mode++)
+  {
+    for (bits = 0; bits <= 0xFFFFFFFF; bits += 0x10000)
+    {
+      pattern = (uint32_t) bits;
+      memcpy(&value, &pattern, sizeof(float));
+      word = LT_PMBus::Float_to_L16_mode(mode, value);
+      expected = float_to_l16_pow(mode, value);
+      if (word != expected)
+      {
+        if (errors < 16)
+          printf("L16 %g mode 0x%02x: 0x%04x, pow 0x%04x\n", value, mode, word, expected);
+        errors++;
+      }
+    }
+  }
+
+  return errors;
+}
+
+uint32_t LT_PMBusMathBenchmark::check()
+{
+  return checkDecoders() + checkEncoders();
+}
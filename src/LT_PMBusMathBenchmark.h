@@ -0,0 +1,73 @@
+/*
+Copyright (c) 2020, Analog Devices Inc
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  * Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  * Neither the name of the Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived from this
+    software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LT_PMBusMathBenchmark_H_
+#define LT_PMBusMathBenchmark_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "LT_PMBus.h"
+
+//! Measures every L11/L16 encode and decode path, LT_PMBusMath and the USE_FAST_MATH 0
+//! versions in LT_PMBus, and checks their accuracy. Decoders run over all 16 bit inputs,
+//! encoders over realistic voltages, currents, temperatures and times. A conversion
+//! outside its error bound counts as a failure, so the result can gate changes to the math.
+class LT_PMBusMathBenchmark
+{
+  protected:
+    float *values_;         //!< encoder inputs.
+    size_t valueCnt_;
+    uint16_t *words_;       //!< all 16 bit words.
+    uint16_t *encoded_;
+    float *decoded_;
+    uint32_t failures_;
+
+    void report(const char *name, uint64_t ns, size_t count, double maxError, const char *unit);
+    void makeValues();
+    void benchDecoders();
+    void benchEncoders();
+    double checkL11(const uint16_t *encoded, double bound);
+    double checkL16(const uint16_t *encoded, uint8_t vout_mode, double bound);
+    uint32_t checkDecoders();
+    uint32_t checkEncoders();
+
+  public:
+    LT_PMBusMathBenchmark();
+    ~LT_PMBusMathBenchmark();
+
+    //! Run all benchmarks and checks and print a line per path.
+    //! @return number of conversions outside their error bound.
+    uint32_t run();
+
+    //! Check the batch decoders against the scalar ones on every input, and the
+    //! USE_FAST_MATH 0 encoders against the exponent search on every float. This takes
+    //! several minutes.
+    //! @return number of values that differ.
+    uint32_t check();
+};
+
+#endif /* LT_PMBusMathBenchmark_H_ */
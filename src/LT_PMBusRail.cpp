@@ -30,37 +30,173 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <unistd.h>
 #include "LT_PMBusRail.h"
 #include "LT_PMBusDevice.h"
-    
-LT_PMBusRail::LT_PMBusRail (LT_PMBus *pmbus, uint8_t railAddress, tRailDef **railDef)
+#include "LT_Clock.h"
+
+LT_PMBusRailSnapshot::LT_PMBusRailSnapshot()
+{
+  startUs = 0;
+  endUs = 0;
+  measured = 0;
+  vin = vout = iin = pin = 0.0;
+  iout = NULL;
+  pout = NULL;
+  phases = 0;
+  capacity = 0;
+}
+
+LT_PMBusRailSnapshot::~LT_PMBusRailSnapshot()
+{
+  free(iout);
+  free(pout);
+}
+
+bool LT_PMBusRailSnapshot::reserve(uint16_t count)
+{
+  float *i, *p;
+
+  if (count <= capacity)
+    return true;
+  if ((i = (float *) realloc(iout, count * sizeof(float))) != NULL)
+    iout = i;
+  if ((p = (float *) realloc(pout, count * sizeof(float))) != NULL)
+    pout = p;
+  if (i == NULL || p == NULL)
+    return false;
+  capacity = count;
+  return true;
+}
+
+float LT_PMBusRailSnapshot::totalIout()
+{
+  float total = 0.0;
+
+  for (uint16_t j = 0; j < phases; j++)
+    total += iout[j];
+  return total;
+}
+
+float LT_PMBusRailSnapshot::powerOut()
+{
+  float total = 0.0;
+
+  if (measured & HAS_POUT)
+  {
+    for (uint16_t j = 0; j < phases; j++)
+      total += pout[j];
+    return total;
+  }
+  if ((measured & (HAS_VOUT | HAS_IOUT)) == (HAS_VOUT | HAS_IOUT))
+    return vout * totalIout();
+  return 0.0;
+}
+
+float LT_PMBusRailSnapshot::powerIn()
+{
+  if (measured & HAS_PIN)
+    return pin;
+  if ((measured & (HAS_VIN | HAS_IIN)) == (HAS_VIN | HAS_IIN))
+    return vin * iin;
+  return 0.0;
+}
+
+float LT_PMBusRailSnapshot::efficiency()
+{
+  float in = powerIn();
+  float out = powerOut();
+
+  if (in == 0.0 || out == 0.0)
+    return 0.0;
+  return 100.0 * out/in;
+}
+
+float LT_PMBusRailSnapshot::powerLoss()
+{
+  float in = powerIn();
+  float out = powerOut();
+
+  if (in == 0.0 || out == 0.0)
+    return 0.0;
+  return in - out;
+}
+
+float LT_PMBusRailSnapshot::phaseBalance()
+{
+  float min = 10000.0;
+  float max = -10000.0;
+
+  if (!(measured & HAS_IOUT) || phases == 0)
+    return 0.0;
+  for (uint16_t j = 0; j < phases; j++)
+  {
+    if (iout[j] > max) max = iout[j];
+    if (iout[j] < min) min = iout[j];
+  }
+  return 100.0 * (max - min)/totalIout();
+}
+
+LT_PMBusRail::LT_PMBusRail (LT_PMBus *pmbus, uint8_t railAddress, uint8_t address, const uint8_t *pages,
+                            uint8_t noOfPages, bool controller, bool multiphase, uint32_t capabilities)
 {
   pmbus_ = pmbus;
   railAddress_ = railAddress;
-  railDef_ = railDef;
+  controller_ = controller;
+  multiphase_ = multiphase;
+  capabilities_ = capabilities;
+  ownsPhases_ = true;
+  phaseCnt_ = 0;
+  if ((phases_ = (tRailPhase *) malloc(noOfPages * sizeof(tRailPhase))) == NULL)
+    return;
+  for (phaseCnt_ = 0; phaseCnt_ < noOfPages; phaseCnt_++)
+  {
+    phases_[phaseCnt_].address = address;
+    phases_[phaseCnt_].page = pages[phaseCnt_];
+    phases_[phaseCnt_].firstOfDevice = phaseCnt_ == 0;
+  }
 }
 
+/*
+ * Append the phases of another rail. A phase is the first of its device if
+ * no earlier phase has the same address.
+ */
 void LT_PMBusRail::merge(LT_PMBusRail *rail)
 {
-  uint8_t i;
+  tRailPhase *phases;
+  uint16_t i, j;
+
+  if (ownsPhases_)
+    phases = (tRailPhase *) realloc(phases_, (phaseCnt_ + rail->phaseCnt_) * sizeof(tRailPhase));
+  else if ((phases = (tRailPhase *) malloc((phaseCnt_ + rail->phaseCnt_) * sizeof(tRailPhase))) != NULL)
+    memcpy(phases, phases_, phaseCnt_ * sizeof(tRailPhase));
+  if (phases == NULL)
+    return;
+  phases_ = phases;
+  ownsPhases_ = true;
+
+  for (i = 0; i < rail->phaseCnt_; i++)
+  {
+    phases_[phaseCnt_] = rail->phases_[i];
+    phases_[phaseCnt_].firstOfDevice = true;
+    for (j = 0; j < phaseCnt_; j++)
+      if (phases_[j].address == phases_[phaseCnt_].address)
+        phases_[phaseCnt_].firstOfDevice = false;
+    phaseCnt_++;
+  }
+}
 
-  (*railDef_)->pages = (uint8_t *)realloc((*railDef_)->pages, (*railDef_)->noOfPages + (*(rail->railDef_))->noOfPages);
-  for (i = (*railDef_)->noOfPages; i < (*railDef_)->noOfPages + (*(rail->railDef_))->noOfPages; i++)
-    (*railDef_)->pages[i] = (*(rail->railDef_))->pages[i - (*railDef_)->noOfPages];
-  (*railDef_)->noOfPages += (*(rail->railDef_))->noOfPages;
+uint16_t LT_PMBusRail::pack(tRailPhase *table)
+{
+  memcpy(table, phases_, phaseCnt_ * sizeof(tRailPhase));
+  if (ownsPhases_)
+    free(phases_);
+  phases_ = table;
+  ownsPhases_ = false;
+  return phaseCnt_;
 }
 
 LT_PMBusRail::~LT_PMBusRail()
 {
-  if (railDef_ != NULL)
-  {
-    tRailDef **rail = railDef_;
-    while (*rail != NULL)
-    {
-      free ((*rail)->pages);
-      delete *rail;
-      rail++;
-    }
-    free (railDef_);
-  }
+  if (ownsPhases_)
+    free(phases_);
 }
 
 void LT_PMBusRail::changePMBus(LT_PMBus *pmbus)
@@ -75,36 +211,27 @@ uint8_t LT_PMBusRail::getAddress()
 
 bool LT_PMBusRail::isController ()
 {
-  tRailDef **rail = railDef_;
-  return (*rail)->controller;
+  return controller_;
 }
 
-uint8_t LT_PMBusRail::getNoPages()
+uint16_t LT_PMBusRail::getNoPages()
 {
-  tRailDef **rail = railDef_;
-  uint8_t noPages = 0;
-
-  while (*rail != NULL)
-  {
-    noPages += (*rail)->noOfPages;
-    rail++;
-  }
-  return noPages;
+  return phaseCnt_;
 }
 
 bool LT_PMBusRail::isMultiphase()
 {
-  return (*railDef_)->multiphase;
+  return multiphase_;
 }
 
 uint32_t LT_PMBusRail::getCapabilities()
 {
-  return (*railDef_)->capabilities;
+  return capabilities_;
 }
 
 uint32_t LT_PMBusRail::hasCapability(uint32_t capability)
 {
-  return ((*railDef_)->capabilities & capability) == capability;
+  return (capabilities_ & capability) == capability;
 }
 
 /*
@@ -128,7 +255,7 @@ float LT_PMBusRail::readVin(bool polling)
 {
   // This assumes that the VIN of all physical devices share
   // the same VIN.
-  return pmbus_->readVin((*railDef_)->address, polling);
+  return pmbus_->readVin(phases_[0].address, polling);
 }
 
 /*
@@ -141,8 +268,8 @@ float LT_PMBusRail::readVout(bool polling)
 {
   // All VOUTs are connected, so any physical address and
   // page will do.
-  pmbus_->setPage((*railDef_)->address, (*railDef_)->pages[0]);
-  return pmbus_->readVout((*railDef_)->address, polling);
+  pmbus_->setPage(phases_[0].address, phases_[0].page);
+  return pmbus_->readVout(phases_[0].address, polling);
 }
 
 /*
@@ -154,18 +281,14 @@ float LT_PMBusRail::readVout(bool polling)
 float LT_PMBusRail::readIin(bool polling)
 {
   float current = 0.0;
-  tRailDef **rail = railDef_;
+  tRailPhase *phase = phases_;
 
   // Add up inputs from all physical devices. This
   // may include rail/phases that are not part of the rail.
-  while (*rail != NULL)
+  for (uint16_t j = 0; j < phaseCnt_; j++, phase++)
   {
-    for (int j = 0; j < (*rail)->noOfPages; j++)
-    {
-      pmbus_->setPage((*rail)->address, (*rail)->pages[j]);
-      current += pmbus_->readIin((*rail)->address, polling);
-    }
-    rail++;
+    pmbus_->setPage(phase->address, phase->page);
+    current += pmbus_->readIin(phase->address, polling);
   }
 
   return current;
@@ -180,17 +303,13 @@ float LT_PMBusRail::readIin(bool polling)
 float LT_PMBusRail::readIout(bool polling)
 {
   float current = 0.0;
-  tRailDef **rail = railDef_;
+  tRailPhase *phase = phases_;
 
   // Add up all phases. There will not be any unwanted phases.
-  while (*rail != NULL)
+  for (uint16_t j = 0; j < phaseCnt_; j++, phase++)
   {
-    for (int j = 0; j < (*rail)->noOfPages; j++)
-    {
-      pmbus_->setPage((*rail)->address, (*rail)->pages[j]);
-      current += pmbus_->readIout((*rail)->address, polling);
-    }
-    rail++;
+    pmbus_->setPage(phase->address, phase->page);
+    current += pmbus_->readIout(phase->address, polling);
   }
 
   return current;
@@ -205,15 +324,13 @@ float LT_PMBusRail::readIout(bool polling)
 float LT_PMBusRail::readPin(bool polling)
 {
   float power = 0.0;
-  tRailDef **rail = railDef_;
+  tRailPhase *phase = phases_;
 
   // Add up inputs from all physical devices. This
   // may include rail/phases that are not part of the rail.
-  while (*rail != NULL)
-  {
-    power += pmbus_->readPin((*rail)->address, polling);
-    rail++;
-  }
+  for (uint16_t j = 0; j < phaseCnt_; j++, phase++)
+    if (phase->firstOfDevice)
+      power += pmbus_->readPin(phase->address, polling);
 
   return power;
 }
@@ -227,17 +344,13 @@ float LT_PMBusRail::readPin(bool polling)
 float LT_PMBusRail::readPout(bool polling)
 {
   float power = 0.0;
-  tRailDef **rail = railDef_;
+  tRailPhase *phase = phases_;
 
   // Add up all phases. There will not be any unwanted phases.
-  while (*rail != NULL)
+  for (uint16_t j = 0; j < phaseCnt_; j++, phase++)
   {
-    for (int j = 0; j < (*rail)->noOfPages; j++)
-    {
-      pmbus_->setPage((*rail)->address, (*rail)->pages[j]);
-      power += pmbus_->readPout((*rail)->address, polling);
-    }
-    rail++;
+    pmbus_->setPage(phase->address, phase->page);
+    power += pmbus_->readPout(phase->address, polling);
   }
 
   return power;
@@ -252,22 +365,16 @@ float LT_PMBusRail::readPout(bool polling)
 float LT_PMBusRail::readExternalTemperature(bool polling)
 {
   float temp = 0.0;
-  float pages = 0;
-  tRailDef **rail = railDef_;
+  tRailPhase *phase = phases_;
 
   // Add up all phases. There will not be any unwanted phases.
-  while (*rail != NULL)
+  for (uint16_t j = 0; j < phaseCnt_; j++, phase++)
   {
-    pages += (float) ((*rail)->noOfPages);
-    for (int j = 0; j < (*rail)->noOfPages; j++)
-    {
-      pmbus_->setPage((*rail)->address, (*rail)->pages[j]);
-      temp += pmbus_->readExternalTemperature((*rail)->address, polling);
-    }
-    rail++;
+    pmbus_->setPage(phase->address, phase->page);
+    temp += pmbus_->readExternalTemperature(phase->address, polling);
   }
 
-  return temp/pages;
+  return temp/phaseCnt_;
 }
 
 /*
@@ -279,28 +386,80 @@ float LT_PMBusRail::readExternalTemperature(bool polling)
 float LT_PMBusRail::readInternalTemperature(bool polling)
 {
   float temp = 0.0;
-  float pages = 0;
-  tRailDef **rail = railDef_;
+  tRailPhase *phase = phases_;
 
   // Add up all phases. There will not be any unwanted phases.
-  while (*rail != NULL)
+  for (uint16_t j = 0; j < phaseCnt_; j++, phase++)
   {
-    pages += (float) ((*rail)->noOfPages);
-    for (int j = 0; j < (*rail)->noOfPages; j++)
-    {
-      pmbus_->setPage((*rail)->address, (*rail)->pages[j]);
-      PsmDeviceType t = pmbus_->deviceType((*rail)->address);
-      if (t == LTC2977 || t == LTC2978)
-        temp += pmbus_->readExternalTemperature((*rail)->address, polling); // Really internal.
-      else
-        temp += pmbus_->readInternalTemperature((*rail)->address, polling);
-    }
-    rail++;
+    pmbus_->setPage(phase->address, phase->page);
+    PsmDeviceType t = pmbus_->deviceType(phase->address);
+    if (t == LTC2977 || t == LTC2978)
+      temp += pmbus_->readExternalTemperature(phase->address, polling); // Really internal.
+    else
+      temp += pmbus_->readInternalTemperature(phase->address, polling);
+  }
+
+  return temp/phaseCnt_; // Account for multiple devices
+}
+
+
+/*
+ * Measure a polyphase rail in one burst
+ *
+ * snap:         receives the measurements
+ * measurements: HAS_ bits to measure
+ * polling:      poll if true
+ * return:       false if there is no room for the phases
+ *
+ * The same reads as the single measurement functions, but each page is
+ * selected once and nothing is computed until the burst is over.
+ */
+bool LT_PMBusRail::snapshot(LT_PMBusRailSnapshot *snap, uint32_t measurements, bool polling)
+{
+  tRailPhase *phase = phases_;
+  uint16_t j;
+
+  if (!snap->reserve(getNoPages()))
+    return false;
+  measurements &= getCapabilities();
+  snap->measured = measurements;
+  snap->vin = snap->vout = snap->iin = snap->pin = 0.0;
+
+  snap->startUs = LT_Clock::nowUs();
+  if (measurements & HAS_VIN)
+    snap->vin = pmbus_->readVin(phases_[0].address, polling);
+  for (j = 0; j < phaseCnt_; j++, phase++)
+  {
+    pmbus_->setPage(phase->address, phase->page);
+    if (j == 0 && (measurements & HAS_VOUT))
+      snap->vout = pmbus_->readVout(phase->address, polling);
+    if (measurements & HAS_IOUT)
+      snap->iout[j] = pmbus_->readIout(phase->address, polling);
+    if (measurements & HAS_POUT)
+      snap->pout[j] = pmbus_->readPout(phase->address, polling);
+    if (measurements & HAS_IIN)
+      snap->iin += pmbus_->readIin(phase->address, polling);
+    if (phase->firstOfDevice && (measurements & HAS_PIN))
+      snap->pin += pmbus_->readPin(phase->address, polling);
   }
+  snap->endUs = LT_Clock::nowUs();
+  snap->phases = phaseCnt_;
 
-  return temp/pages; // Account for multiple devices
+  return true;
 }
 
+uint32_t LT_PMBusRail::efficiencyInputs()
+{
+  if (hasCapability(HAS_POUT | HAS_PIN))
+    return HAS_POUT | HAS_PIN;
+  if (hasCapability(HAS_POUT | HAS_IIN | HAS_VIN))
+    return HAS_POUT | HAS_IIN | HAS_VIN;
+  if (hasCapability(HAS_VOUT | HAS_IOUT | HAS_PIN))
+    return HAS_VOUT | HAS_IOUT | HAS_PIN;
+  if (hasCapability(HAS_VOUT | HAS_IOUT | HAS_VIN | HAS_IIN))
+    return HAS_VOUT | HAS_IOUT | HAS_VIN | HAS_IIN;
+  return 0;
+}
 
 /*
  * Read the efficiency of a polyphase rail
@@ -310,43 +469,12 @@ float LT_PMBusRail::readInternalTemperature(bool polling)
  */
 float LT_PMBusRail::readEfficiency(bool polling)
 {
-  float val1, val2 = 0.0;
-  float efficiency = 0.0;
+  LT_PMBusRailSnapshot snap;
+  uint32_t inputs = efficiencyInputs();
 
-//  Serial.print("eff "); Serial.println(getCapabilities(), HEX);
-  if (hasCapability(HAS_POUT | HAS_PIN))
-  {
-//    Serial.println("1");
-    val1 = readPin(polling);
-    val2 += readPout(polling);
-    efficiency = 100.0 * val2/val1;
-  }
-  else if (hasCapability(HAS_POUT | HAS_IIN | HAS_VIN))
-  {
-//    Serial.println("2");
-    val1 = readVin(polling);
-    val1 *= readIin(polling);
-    val2 = readPout(polling);
-    efficiency = 100.0 * val2/val1;
-  }
-  else if (hasCapability(HAS_VOUT | HAS_IOUT | HAS_PIN))
-  {
-//    Serial.println("3");
-    val1 = readPin(polling);
-    val2 = readVout(polling);
-    val2 *= readIout(polling);
-    efficiency = 100.0 * val2/val1;
-  }
-  else if (hasCapability(HAS_VOUT | HAS_IOUT | HAS_VIN | HAS_IIN))
-  {
-//    Serial.println("4");
-    val1 = readVin(polling);
-    val1 *= readIin(polling);
-    val2 = readVout(polling);
-    val2 *= readIout(polling);
-    efficiency = 100.0 * val2/val1;
-  }
-  return efficiency;
+  if (inputs == 0 || !snapshot(&snap, inputs, polling))
+    return 0.0;
+  return snap.efficiency();
 }
 
 /*
@@ -358,23 +486,19 @@ float LT_PMBusRail::readEfficiency(bool polling)
 float LT_PMBusRail::readDutyCycle(bool polling)
 {
   float total = 0.0;
-  tRailDef **rail = railDef_;
+  tRailPhase *phase = phases_;
 
   if (hasCapability(HAS_DC))
   {
 
-    while (*rail != NULL)
+    for (uint16_t j = 0; j < phaseCnt_; j++, phase++)
     {
-      for (int j = 0; j < (*rail)->noOfPages; j++)
-      {
-        pmbus_->setPage((*rail)->address, (*rail)->pages[j]);
-        total += pmbus_->readDutyCycle((*rail)->address, polling);
-//        Serial.println(dc,DEC);
-      }
-      rail++;
+      pmbus_->setPage(phase->address, phase->page);
+      total += pmbus_->readDutyCycle(phase->address, polling);
+//      Serial.println(dc,DEC);
     }
 
-    return total/(*rail)->noOfPages;
+    return total/phaseCnt_;
   }
   else
     return 0.0;
@@ -382,32 +506,11 @@ float LT_PMBusRail::readDutyCycle(bool polling)
 
 float LT_PMBusRail::readPhaseBalance(bool polling)
 {
-  float current = 0.0;
-  float min = 10000.0;
-  float max = -10000.0;
-  float total = 0.0;
-  tRailDef **rail = railDef_;
-
-  if (hasCapability(HAS_IOUT))
-  {
+  LT_PMBusRailSnapshot snap;
 
-    while (*rail != NULL)
-    {
-      for (int j = 0; j < (*rail)->noOfPages; j++)
-      {
-        pmbus_->setPage((*rail)->address, (*rail)->pages[j]);
-        total += (current = pmbus_->readIout((*rail)->address, polling));
-//        Serial.println(current,DEC);
-        if (current > max) max = current;
-        if (current < min) min = current;
-      }
-      rail++;
-    }
-
-    return 100.0 * (max - min)/total;
-  }
-  else
+  if (!hasCapability(HAS_IOUT) || !snapshot(&snap, HAS_IOUT, polling))
     return 0.0;
+  return snap.phaseBalance();
 }
 
 float LT_PMBusRail::readTransient(bool polling)
@@ -417,99 +520,94 @@ float LT_PMBusRail::readTransient(bool polling)
   float vout_uv;
   uint8_t vout_response;
   uint8_t status;
-  tRailDef **rail = railDef_;
+  tRailPhase *phase = phases_;
   float v;
   bool is_controller;
   uint16_t pads;
   PsmDeviceType t;
 
-  while (*rail != NULL)
+  is_controller = isController();
+  for (uint16_t j = 0; j < phaseCnt_; j++, phase++)
   {
-    is_controller = isController();
-    max = 0.0;
-    for (int j = 0; j < (*rail)->noOfPages; j++)
+    // Skip LTC3882 Slave phases
+    t = pmbus_->deviceType(phase->address);
+    if (is_controller && (t == LTC3882 || t == LTC3882_1))
     {
-      // Skip LTC3882 Slave phases
-      t = pmbus_->deviceType((*rail)->address);
-      if (is_controller && (t == LTC3882 || t == LTC3882_1))
-      {
 //        Serial.println(j, DEC);
-        pads = pmbus_->smbus()->readWord((*rail)->address, MFR_PADS);
+      pads = pmbus_->smbus()->readWord(phase->address, MFR_PADS);
 //        Serial.println(pads, HEX);
-        if (pads & (1 << (14 + j)))
-          continue;
-      }
+      if (pads & (1 << (14 + phase->page)))
+        continue;
+    }
 
-      if (polling) pmbus_->smbus()->waitForAck((*rail)->address, 0x00);
-      if (polling) pmbus_->waitForNotBusy((*rail)->address);
-      pmbus_->setPage((*rail)->address, (*rail)->pages[j]);
-      if (polling) pmbus_->smbus()->waitForAck((*rail)->address, 0x00);
-      if (polling) pmbus_->waitForNotBusy((*rail)->address);
-      vout = pmbus_->getVout((*rail)->address, polling);
-      if (polling) pmbus_->smbus()->waitForAck((*rail)->address, 0x00);
-      if (polling) pmbus_->waitForNotBusy((*rail)->address);
-      vout_uv = pmbus_->getVoutUv((*rail)->address, polling);
-      if (polling) pmbus_->smbus()->waitForAck((*rail)->address, 0x00);
-      if (polling) pmbus_->waitForNotBusy((*rail)->address);
-      vout_response = pmbus_->smbus()->readByte((*rail)->address, VOUT_UV_FAULT_RESPONSE);
-      if (polling) pmbus_->smbus()->waitForAck((*rail)->address, 0x00);
-      if (polling) pmbus_->waitForNotBusy((*rail)->address);
-      pmbus_->smbus()->writeByte((*rail)->address, VOUT_UV_FAULT_RESPONSE, 0);
-      if (polling) pmbus_->smbus()->waitForAck((*rail)->address, 0x00);
-      if (polling) pmbus_->waitForNotBusy((*rail)->address);
-
-      status = pmbus_->readVoutStatusByte((*rail)->address);
-      if (polling) pmbus_->smbus()->waitForAck((*rail)->address, 0x00);
-      if (polling) pmbus_->waitForNotBusy((*rail)->address);
-      if (is_controller)
-        pmbus_->smbus()->writeByte((*rail)->address, STATUS_VOUT, status | (1 << 4));
-      else
-        pmbus_->clearFaults((*rail)->address);
-      if (polling) pmbus_->smbus()->waitForAck((*rail)->address, 0x00);
-      if (polling) pmbus_->waitForNotBusy((*rail)->address);
+    if (polling) pmbus_->smbus()->waitForAck(phase->address, 0x00);
+    if (polling) pmbus_->waitForNotBusy(phase->address);
+    pmbus_->setPage(phase->address, phase->page);
+    if (polling) pmbus_->smbus()->waitForAck(phase->address, 0x00);
+    if (polling) pmbus_->waitForNotBusy(phase->address);
+    vout = pmbus_->getVout(phase->address, polling);
+    if (polling) pmbus_->smbus()->waitForAck(phase->address, 0x00);
+    if (polling) pmbus_->waitForNotBusy(phase->address);
+    vout_uv = pmbus_->getVoutUv(phase->address, polling);
+    if (polling) pmbus_->smbus()->waitForAck(phase->address, 0x00);
+    if (polling) pmbus_->waitForNotBusy(phase->address);
+    vout_response = pmbus_->smbus()->readByte(phase->address, VOUT_UV_FAULT_RESPONSE);
+    if (polling) pmbus_->smbus()->waitForAck(phase->address, 0x00);
+    if (polling) pmbus_->waitForNotBusy(phase->address);
+    pmbus_->smbus()->writeByte(phase->address, VOUT_UV_FAULT_RESPONSE, 0);
+    if (polling) pmbus_->smbus()->waitForAck(phase->address, 0x00);
+    if (polling) pmbus_->waitForNotBusy(phase->address);
+
+    status = pmbus_->readVoutStatusByte(phase->address);
+    if (polling) pmbus_->smbus()->waitForAck(phase->address, 0x00);
+    if (polling) pmbus_->waitForNotBusy(phase->address);
+    if (is_controller)
+      pmbus_->smbus()->writeByte(phase->address, STATUS_VOUT, status | (1 << 4));
+    else
+      pmbus_->clearFaults(phase->address);
+    if (polling) pmbus_->smbus()->waitForAck(phase->address, 0x00);
+    if (polling) pmbus_->waitForNotBusy(phase->address);
 
 //      Serial.print("N "); Serial.println(vout, DEC);
 
-      // Generating a fault, even if ignored, can make things busy, so poll.
-      for (v = 0.95 * vout; v < 1.05 * vout; v = v + 0.001)
+    // Generating a fault, even if ignored, can make things busy, so poll.
+    for (v = 0.95 * vout; v < 1.05 * vout; v = v + 0.001)
+    {
+      pmbus_->setVoutUvFaultLimit(phase->address, v);
+      if (polling) pmbus_->smbus()->waitForAck(phase->address, 0x00);
+      if (polling) pmbus_->waitForNotBusy(phase->address);
+      status = pmbus_->readVoutStatusByte(phase->address);
+      if (polling) pmbus_->smbus()->waitForAck(phase->address, 0x00);
+      if (polling) pmbus_->waitForNotBusy(phase->address);
+      if (status & (1 << 4))
       {
-        pmbus_->setVoutUvFaultLimit((*rail)->address, v);
-        if (polling) pmbus_->smbus()->waitForAck((*rail)->address, 0x00);
-        if (polling) pmbus_->waitForNotBusy((*rail)->address);
-        status = pmbus_->readVoutStatusByte((*rail)->address);
-        if (polling) pmbus_->smbus()->waitForAck((*rail)->address, 0x00);
-        if (polling) pmbus_->waitForNotBusy((*rail)->address);
-        if (status & (1 << 4))
-        {
 //          Serial.print("V "); Serial.print(v,DEC); Serial.print(" S "); Serial.println(status, HEX);
-          break;
-        }
-        usleep(50 * 1000);
+        break;
       }
+      usleep(50 * 1000);
+    }
 
-      pmbus_->setVoutUvFaultLimit((*rail)->address, vout_uv);
-      if (polling) pmbus_->smbus()->waitForAck((*rail)->address, 0x00);
-      if (polling) pmbus_->waitForNotBusy((*rail)->address);
-      pmbus_->smbus()->writeByte((*rail)->address, VOUT_UV_FAULT_RESPONSE, vout_response);
-      if (polling) pmbus_->smbus()->waitForAck((*rail)->address, 0x00);
-      if (polling) pmbus_->waitForNotBusy((*rail)->address);
+    pmbus_->setVoutUvFaultLimit(phase->address, vout_uv);
+    if (polling) pmbus_->smbus()->waitForAck(phase->address, 0x00);
+    if (polling) pmbus_->waitForNotBusy(phase->address);
+    pmbus_->smbus()->writeByte(phase->address, VOUT_UV_FAULT_RESPONSE, vout_response);
+    if (polling) pmbus_->smbus()->waitForAck(phase->address, 0x00);
+    if (polling) pmbus_->waitForNotBusy(phase->address);
 
-      if (is_controller)
-        pmbus_->smbus()->writeByte((*rail)->address, STATUS_VOUT, status | (1 << 4));
-      else
-        pmbus_->clearFaults((*rail)->address);
+    if (is_controller)
+      pmbus_->smbus()->writeByte(phase->address, STATUS_VOUT, status | (1 << 4));
+    else
+      pmbus_->clearFaults(phase->address);
 
 //      Serial.println(vout, DEC);
 //      Serial.println(v, DEC);
 //      Serial.println();
 
-        if(max < vout-v) max = vout-v;
+      if(max < vout-v) max = vout-v;
 //      Serial.print("transient "); Serial.println(vout-v, DEC);
 //      Serial.print("uv "); Serial.println(vout_uv, DEC);
 //      Serial.print("resp "); Serial.println(vout_response, HEX);
 
-    }
-    rail++;
   }
 
   return max;
@@ -523,18 +621,14 @@ float LT_PMBusRail::readTransient(bool polling)
 uint16_t LT_PMBusRail::readStatusWord()
 {
   uint16_t sw = 0;
-  tRailDef **rail = railDef_;
+  tRailPhase *phase = phases_;
 
   // Combine all words. Assumes 1 = notification, so that anything
   // with a 1 is interesting.
-  while (*rail != NULL)
+  for (uint16_t j = 0; j < phaseCnt_; j++, phase++)
   {
-    for (int j = 0; j < (*rail)->noOfPages; j++)
-    {
-      pmbus_->setPage((*rail)->address, (*rail)->pages[j]);
-      sw |= pmbus_->readStatusWord((*rail)->address);
-    }
-    rail++;
+    pmbus_->setPage(phase->address, phase->page);
+    sw |= pmbus_->readStatusWord(phase->address);
   }
 
   return sw;
@@ -548,18 +642,12 @@ uint16_t LT_PMBusRail::readStatusWord()
 uint16_t LT_PMBusRail::getMfrSpecialId()
 {
   uint16_t id = 0;
-  tRailDef **rail = railDef_;
 
-  while (*rail != NULL)
+  // Exit at first opportunity.
+  if (phaseCnt_ > 0)
   {
-    for (int j = 0; j < (*rail)->noOfPages; j++)
-    {
-      pmbus_->setPage((*rail)->address, (*rail)->pages[j]);
-      id = pmbus_->getMfrSpecialId((*rail)->address);
-      // Exist at first opportunity.
-      break;
-    }
-    rail++;
+    pmbus_->setPage(phases_[0].address, phases_[0].page);
+    id = pmbus_->getMfrSpecialId(phases_[0].address);
   }
 
   return id;
@@ -570,15 +658,13 @@ uint16_t LT_PMBusRail::getMfrSpecialId()
  */
 void LT_PMBusRail::clearFaults()
 {
-  tRailDef **rail = railDef_;
+  tRailPhase *phase = phases_;
 
   pmbus_->startGroupProtocol();
 
-  while (*rail != NULL)
-  {
-    pmbus_->clearAllFaults((*rail)->address);
-    rail++;
-  }
+  for (uint16_t j = 0; j < phaseCnt_; j++, phase++)
+    if (phase->firstOfDevice)
+      pmbus_->clearAllFaults(phase->address);
 
   pmbus_->executeGroupProtocol();
 }
@@ -39,15 +39,58 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <math.h>
 #include "LT_PMBus.h"
 
+//! One phase of a rail, a page of a device.
 typedef struct
 {
-  uint8_t address; // or char strVal[20];
-  uint8_t *pages;
-  uint8_t noOfPages;
-  bool controller;
-  bool multiphase;
-  uint32_t capabilities;
-} tRailDef;
+  uint8_t address;      //!< device address.
+  uint8_t page;         //!< page of the phase.
+  bool firstOfDevice;   //!< true for the first phase of its device in the rail.
+} tRailPhase;
+
+//! Measurements of every phase of a rail taken in one burst, and the values
+//! derived from them. Each measurement is read once per phase, so efficiency,
+//! loss and balance all come from the same moment.
+class LT_PMBusRailSnapshot
+{
+  public:
+    uint64_t startUs;     //!< monotonic time the burst started.
+    uint64_t endUs;       //!< monotonic time the burst ended.
+    uint32_t measured;    //!< HAS_ bits of the measurements taken.
+    float vin;            //!< input voltage of the first device.
+    float vout;           //!< output voltage of the first phase.
+    float iin;            //!< input current of all pages of the devices.
+    float pin;            //!< input power of the devices.
+    float *iout;          //!< output current of each phase.
+    float *pout;          //!< output power of each phase.
+    uint16_t phases;      //!< phases measured.
+    uint16_t capacity;    //!< phases iout and pout can hold.
+
+    LT_PMBusRailSnapshot();
+    ~LT_PMBusRailSnapshot();
+
+    //! Make room for a number of phases.
+    //! @return true if there is room.
+    bool reserve(uint16_t phases //!< number of phases.
+                );
+
+    //! @return the sum of the phase output currents.
+    float totalIout();
+
+    //! @return output power, from POUT or VOUT * IOUT.
+    float powerOut();
+
+    //! @return input power, from PIN or VIN * IIN.
+    float powerIn();
+
+    //! @return 100 * output/input power, or zero if not measured.
+    float efficiency();
+
+    //! @return input minus output power, or zero if not measured.
+    float powerLoss();
+
+    //! @return 100 * (max-min)/total phase current, or zero if not measured.
+    float phaseBalance();
+};
 
 //! PMBusRail communication. For Multiphase Rails.
 class LT_PMBusRail
@@ -59,20 +102,36 @@ class LT_PMBusRail
     uint8_t model_[9];
 
   protected:
-    tRailDef **railDef_;
+    tRailPhase *phases_;      //!< phases, in device order.
+    uint16_t phaseCnt_;
+    bool ownsPhases_;         //!< false once packed into a shared table.
+    bool controller_;
+    bool multiphase_;
+    uint32_t capabilities_;
 
   public:
 
     //! Construct a LT_PMBus.
-    LT_PMBusRail(LT_PMBus *pmbus,     //!< SMBus for communication. Use the PEC or non-PEC version.
-                 uint8_t railAddress, //!< The rail address.
-                 tRailDef **railDef);  //!< A list of addresses with pages that make up the rail. NULL terminated.
+    LT_PMBusRail(LT_PMBus *pmbus,         //!< SMBus for communication. Use the PEC or non-PEC version.
+                 uint8_t railAddress,     //!< The rail address.
+                 uint8_t address,         //!< Address of the device with the first pages.
+                 const uint8_t *pages,    //!< Pages of the device that are in the rail.
+                 uint8_t noOfPages,       //!< Number of pages.
+                 bool controller,         //!< true for a PSM controller.
+                 bool multiphase,         //!< true if the rail is multiphase.
+                 uint32_t capabilities);  //!< HAS_ bits of the device.
 
     ~LT_PMBusRail();
 
     //! Change the pmbus
     void changePMBus(LT_PMBus *pmbus);
 
+    //! Get the pmbus
+    LT_PMBus *pmbus()
+    {
+      return pmbus_;
+    }
+
     //! Get ther rail address
     uint8_t getAddress();
 
@@ -80,7 +139,7 @@ class LT_PMBusRail
     bool isController ();
 
     //! Get the number of pages in the rail
-    uint8_t getNoPages();
+    uint16_t getNoPages();
 
     //! Ask if the rail is multiphase
     bool isMultiphase();
@@ -95,6 +154,19 @@ class LT_PMBusRail
     void merge(LT_PMBusRail *rail //!< Rail to merge
               );
 
+    //! Get a phase of the rail.
+    const tRailPhase *getPhase(uint16_t index //!< phase index, less than getNoPages().
+                              )
+    {
+      return &phases_[index];
+    }
+
+    //! Move the phases into a table shared by all rails, which must hold
+    //! getNoPages() phases and outlive the rail. Done once after detection.
+    //! @return the number of phases moved.
+    uint16_t pack(tRailPhase *table //!< where the phases go.
+                 );
+
     //! Set the output voltage of a polyphase rail
     //! @return void
     void setVout(float voltage //!< Rail voltage
@@ -140,6 +212,20 @@ class LT_PMBusRail
     float readInternalTemperature(bool polling //!< true for polling
                                  );
 
+    //! Measure the rail in one burst: each page is selected once and all of
+    //! its measurements are read back to back, VIN and VOUT once per rail and
+    //! PIN once per device.
+    //! @return false if the snapshot has no room for the phases.
+    bool snapshot(LT_PMBusRailSnapshot *snap,  //!< receives the measurements.
+                  uint32_t measurements,       //!< HAS_ bits to measure, limited to the rail capabilities.
+                  bool polling                 //!< true for polling
+                 );
+
+    //! HAS_ bits needed for the efficiency, the first of PIN and POUT, VIN*IIN and POUT,
+    //! PIN and VOUT*IOUT, or VIN*IIN and VOUT*IOUT the rail supports.
+    //! @return the bits, or 0 if not supported.
+    uint32_t efficiencyInputs();
+
     //! Read the efficiency (calculated)
     //! @return efficiency or zero if not supported
     float readEfficiency(bool polling //!< true for polling
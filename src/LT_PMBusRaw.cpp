@@ -0,0 +1,86 @@
+/*
+Copyright (c) 2020, Analog Devices Inc
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  * Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  * Neither the name of the Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived from this
+    software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "LT_PMBus.h"
+
+LT_PMBusRaw LT_PMBusRaw::fromFloat(float value, uint8_t format, uint8_t voutMode)
+{
+  if (format == LT_PMBusFormatL16::id)
+    return LT_PMBusRaw(math_.float_to_lin16(value, voutMode & 0x1F), format, voutMode);
+  else
+    return LT_PMBusRaw(math_.float_to_lin11(value), LT_PMBusFormatL11::id, 0);
+}
+
+float LT_PMBusRaw::toFloat() const
+{
+  if (format == LT_PMBusFormatL11::id)
+    return math_.lin11_to_float(word);
+  else if (format == LT_PMBusFormatL16::id)
+    return math_.lin16_to_float(word, voutMode);
+  else
+    return (float) word;
+}
+
+/*
+ * Split into a signed mantissa and a power of two exponent
+ */
+void LT_PMBusRaw::split(int32_t *mantissa, int8_t *exponent) const
+{
+  if (format == LT_PMBusFormatL11::id)
+  {
+    *mantissa = ((int32_t) ((uint32_t) word << 21)) >> 21;
+    *exponent = ((int32_t) ((uint32_t) word << 16)) >> 27;
+  }
+  else if (format == LT_PMBusFormatL16::id)
+  {
+    *mantissa = word;
+    *exponent = ((int32_t) ((uint32_t) voutMode << 27)) >> 27;
+  }
+  else
+  {
+    *mantissa = word;
+    *exponent = 0;
+  }
+}
+
+int LT_PMBusRaw::compare(const LT_PMBusRaw &other) const
+{
+  int32_t m1, m2;
+  int8_t e1, e2;
+  int64_t a, b;
+
+  // Same L16 exponent, or the same byte/word format, compares the words.
+  if (format == other.format && voutMode == other.voutMode && format != LT_PMBusFormatL11::id)
+    return (int) word - (int) other.word;
+
+  // Exponents are within -16..15, so the shifted mantissas fit in 48 bits.
+  split(&m1, &e1);
+  other.split(&m2, &e2);
+  a = e1 > e2 ? (int64_t) m1 << (e1 - e2) : m1;
+  b = e2 > e1 ? (int64_t) m2 << (e2 - e1) : m2;
+  return a < b ? -1 : (a > b ? 1 : 0);
+}
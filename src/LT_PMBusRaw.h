@@ -0,0 +1,93 @@
+/*
+Copyright (c) 2020, Analog Devices Inc
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  * Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  * Neither the name of the Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived from this
+    software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Undecoded PMBus values. Included by LT_PMBus.h after LT_PMBusCommands.h.
+
+#ifndef LT_PMBusRaw_H_
+#define LT_PMBusRaw_H_
+
+#include <stdint.h>
+#include "LT_PMBusMath.h"
+
+//! An undecoded PMBus value: the word as read, its format and, for L16, the VOUT_MODE.
+//! Reading raw values skips the float conversion, which is only done when a consumer
+//! calls toFloat. Limits are encoded once with fromFloat and compared raw.
+class LT_PMBusRaw
+{
+  public:
+    uint16_t word;      //!< the data as read.
+    uint8_t format;     //!< LT_PMBusFormat*::id.
+    uint8_t voutMode;   //!< VOUT_MODE & 0x1F for L16, else 0.
+
+    LT_PMBusRaw()
+    {
+      word = 0;
+      format = LT_PMBusFormatWord::id;
+      voutMode = 0;
+    }
+
+    LT_PMBusRaw(uint16_t w, uint8_t f, uint8_t mode)
+    {
+      word = w;
+      format = f;
+      voutMode = mode & 0x1F;
+    }
+
+    //! Encode a value, for example a threshold, in the format of the values it is compared to.
+    //! @return the raw value
+    static LT_PMBusRaw fromFloat(float value,         //!< value to encode.
+                                 uint8_t format,      //!< LT_PMBusFormatL11::id or LT_PMBusFormatL16::id.
+                                 uint8_t voutMode     //!< VOUT_MODE for L16.
+                                );
+
+    //! Convert to float. Byte and word values are returned as they are.
+    //! @return the value
+    float toFloat() const;
+
+    //! Compare without converting to float. Values of different formats or exponents are
+    //! compared exactly by shifting the mantissas to the smaller exponent.
+    //! @return negative, 0 or positive like strcmp
+    int compare(const LT_PMBusRaw &other    //!< value to compare to.
+               ) const;
+
+    //! @return true if above the limit.
+    bool above(const LT_PMBusRaw &limit) const
+    {
+      return compare(limit) > 0;
+    }
+
+    //! @return true if below the limit.
+    bool below(const LT_PMBusRaw &limit) const
+    {
+      return compare(limit) < 0;
+    }
+
+  protected:
+    void split(int32_t *mantissa, int8_t *exponent) const;
+};
+
+#endif /* LT_PMBusRaw_H_ */
@@ -0,0 +1,59 @@
+/*
+Copyright (c) 2020, Analog Devices Inc
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  * Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  * Neither the name of the Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived from this
+    software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <string.h>
+#include "LT_PMBusRegistry.h"
+#include "LT_PMBusDevice.h"
+#include "LT_PMBusRail.h"
+
+LT_PMBusRegistry::LT_PMBusRegistry()
+{
+  clear();
+}
+
+void LT_PMBusRegistry::clear()
+{
+  memset(devices_, 0, sizeof(devices_));
+  memset(rails_, 0, sizeof(rails_));
+  memset(membership_, 0, sizeof(membership_));
+}
+
+void LT_PMBusRegistry::addDevice(LT_PMBusDevice *device)
+{
+  devices_[device->getAddress() & 0x7F] = device;
+}
+
+void LT_PMBusRegistry::addRail(LT_PMBusRail *rail)
+{
+  rails_[rail->getAddress() & 0x7F] = rail;
+}
+
+void LT_PMBusRegistry::addMember(uint8_t address, LT_PMBusRail *rail)
+{
+  if (membership_[address & 0x7F] == NULL)
+    membership_[address & 0x7F] = rail;
+}
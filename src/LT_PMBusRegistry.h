@@ -0,0 +1,92 @@
+/*
+Copyright (c) 2020, Analog Devices Inc
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  * Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  * Neither the name of the Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived from this
+    software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LT_PMBusRegistry_H_
+#define LT_PMBusRegistry_H_
+
+#include <stdint.h>
+
+class LT_PMBusDevice;
+class LT_PMBusRail;
+
+//! Number of 7 bit SMBus addresses.
+#define REGISTRY_SIZE 128
+
+//! Direct indexed map of the 7 bit addresses on one bus to devices and rails.
+//! Entries are not owned by the registry.
+class LT_PMBusRegistry
+{
+  protected:
+    LT_PMBusDevice *devices_[REGISTRY_SIZE];
+    LT_PMBusRail *rails_[REGISTRY_SIZE];
+    LT_PMBusRail *membership_[REGISTRY_SIZE];
+
+  public:
+    LT_PMBusRegistry();
+
+    //! Forget all devices and rails.
+    void clear();
+
+    //! Register a device at its address.
+    void addDevice(LT_PMBusDevice *device //!< device to register
+                  );
+
+    //! Register a multiphase rail at its rail address.
+    void addRail(LT_PMBusRail *rail //!< rail to register
+                );
+
+    //! Record that a device contributes pages to a rail. The first rail wins.
+    void addMember(uint8_t address, //!< device address
+                   LT_PMBusRail *rail //!< rail the device belongs to
+                  );
+
+    //! Get the device at an address.
+    //! @return device or NULL
+    LT_PMBusDevice *getDevice(uint8_t address //!< 7 bit address
+                             )
+    {
+      return devices_[address & 0x7F];
+    }
+
+    //! Get the multiphase rail at a rail address.
+    //! @return rail or NULL
+    LT_PMBusRail *getRail(uint8_t address //!< 7 bit rail address
+                         )
+    {
+      return rails_[address & 0x7F];
+    }
+
+    //! Get the rail a device belongs to.
+    //! @return rail or NULL
+    LT_PMBusRail *getMembership(uint8_t address //!< 7 bit device address
+                               )
+    {
+      return membership_[address & 0x7F];
+    }
+};
+
+#endif /* LT_PMBusRegistry_H_ */
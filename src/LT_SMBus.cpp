@@ -26,6 +26,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "LT_SMBus.h"
+#include "LT_Crc8.h"
     
 const uint8_t table_[256]          = { 0, 7, 14, 9, 28, 27, 18, 21,
                                        56, 63, 54, 49, 36, 35, 42, 45,
@@ -118,15 +119,7 @@ uint8_t LT_SMBus::doCalculate(uint8_t data, uint8_t begining_value)
  */
 uint8_t LT_SMBus::calculate(uint8_t *data, uint8_t begining_value, uint8_t start_index, uint8_t length)
 {
-  uint8_t i;
-  uint8_t ret_value = begining_value;
-
-  for (i = start_index; i < (start_index + length); i++)
-  {
-    ret_value = doCalculate(data[i], ret_value);
-  }
-
-  return ret_value;
+  return LT_Crc8::update(begining_value, data + start_index, length);
 }
 
 /*
@@ -142,21 +135,7 @@ void LT_SMBus::pecClear(void)
  */
 void LT_SMBus::pecAdd(uint8_t byte_value)
 {
-  uint8_t i;
-  running_pec_ = running_pec_ ^ byte_value;
-
-  for (i=0; i<8; i++)
-  {
-    if ((running_pec_ & 0x80) > 0x00)
-    {
-      running_pec_ = (running_pec_ << 1) ^ poly_;
-    }
-    else
-    {
-      running_pec_ = running_pec_ << 1;
-    }
-
-  }
+  running_pec_ = doCalculate(byte_value, running_pec_);
 }
 
 /*
@@ -172,17 +151,5 @@ uint8_t LT_SMBus::pecGet(void)
 */
 bool LT_SMBus::checkCRC (uint8_t *data)
 {
-  uint8_t pos;
-  bool nok;
-
-  pecClear();
-
-  for (pos = 0; pos < 31; pos++)
-    pecAdd(data[pos]);
-
-  nok = pecGet() != data[pos];
-
-  pecClear();
-
-  return nok;
+  return LT_Crc8::update(0, data, 31) != data[31];
 }
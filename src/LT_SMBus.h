@@ -63,6 +63,13 @@ class LT_SMBus
     //! Get the speed of the bus.
     virtual uint32_t getSpeed() = 0;
 
+    //! Identify the adapter, so objects that drive the same one can be grouped.
+    //! @return a key shared by all objects on the adapter.
+    virtual long adapterKey()
+    {
+      return (long) this;
+    }
+
     //! Check if PEC is enabled
     //! @return true if enabled
     bool pecEnabled(void)
@@ -83,7 +90,7 @@ class LT_SMBus
     uint8_t pecGet(void);
 
     //! Check CRC of block data organized as 31 data bytes plus CRC.
-    //! Do not mix with PEC calculations.
+    //! Does not touch the running PEC.
     //! Return true if CRC does not match.
     bool checkCRC (uint8_t *data);
 
@@ -30,8 +30,11 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 
 #include <stdint.h>
+#include <string.h>
 #include <LT_PMBus.h>
 #include <LT_PMBusDevice.h>
+#include <LT_PMBusRegistry.h>
+#include "LT_Exception.h"
 
 class LT_SMBusARA
 {
@@ -45,70 +48,80 @@ class LT_SMBusARA
     }
     virtual ~LT_SMBusARA(){}
 
+    //! Read the ARA until nobody answers, into a buffer supplied by the caller.
+    //! @return number of addresses
+    uint8_t readAddresses(uint8_t *addresses,   //!< 7 bit addresses of the devices that answered
+                          uint8_t size          //!< size of addresses
+                         )
+    {
+      uint8_t count = 0;
+      int value;
+
+      while (count < size)
+      {
+        try
+        {
+          value = smbus_->readAlert();
+        }
+        catch (LT_Exception &ex)
+        {
+          // Nobody answered the ARA, so there are no more alerts.
+          value = 0;
+        }
+        if (value <= 0)
+          break;
+        // The responder puts its address in the upper 7 bits.
+        addresses[count++] = (value >> 1) & 0x7F;
+      }
+      return count;
+    }
+
     //! Get the ARA addresses (user must free)
     //! @return addresses
     uint8_t *getAddresses (
     )
     {
+      uint8_t buffer[128];
       uint8_t *addresses;
-      uint16_t count = 0;
-      uint8_t address = 0xFF;
-
-      addresses = (uint8_t *) malloc (sizeof(uint8_t));
-      do
-      {
-        address = smbus_->readAlert();
-        addresses[count++] = address;
-        delay(1);
-        addresses = (uint8_t *) realloc(addresses, (count + 1) * sizeof(uint8_t));
-      }
-      while (address != 0);
+      uint8_t count;
 
+      count = readAddresses(buffer, sizeof(buffer));
+      addresses = (uint8_t *) malloc ((count + 1) * sizeof(uint8_t));
+      memcpy(addresses, buffer, count);
       addresses[count] = 0;
 
       return addresses;
     }
 
-    //! Get all the ARA devices.
+    //! Get all the ARA devices, each listed once even if its alert was re-asserted.
     //! @return a list of devices (call must free list, but not devices in list)
-    LT_PMBusDevice **getDevices(LT_PMBusDevice **devices //!< A list of known devices                                   //!< The number of devices in the list
+    LT_PMBusDevice **getDevices(LT_PMBusRegistry *registry //!< Registry of the known devices
                                )
     {
-      uint8_t *addresses;
-      uint8_t *address;
-      LT_PMBusDevice **device;
+      uint8_t addresses[128];
+      uint8_t seen[128 / 8];
+      uint8_t count;
+      uint8_t i;
+      LT_PMBusDevice *device;
       LT_PMBusDevice **matchingDevices;
       LT_PMBusDevice **matchingDevice;
-      int devCount;
-
-      devCount = 0;
-      device = devices;
-      while ((*device) != 0)
-      {
-        device++;
-        devCount++;
-      }
 
-      addresses = getAddresses();
-      matchingDevice = (matchingDevices = (LT_PMBusDevice **) calloc(devCount + 1, sizeof(LT_PMBusDevice *)));
+      count = readAddresses(addresses, sizeof(addresses));
+      matchingDevice = (matchingDevices = (LT_PMBusDevice **) calloc(count + 1, sizeof(LT_PMBusDevice *)));
 
-      // Bad algorithm lies here and needs replacing
-      address = addresses;
-      while (*address != 0)
+      memset(seen, 0, sizeof(seen));
+      for (i = 0; i < count; i++)
       {
-        device = devices;
-        while ((*device) != 0)
+        // A device that still alerts answers the ARA again, so keep the first answer only.
+        if (seen[addresses[i] >> 3] & (1 << (addresses[i] & 7)))
+          continue;
+        seen[addresses[i] >> 3] |= 1 << (addresses[i] & 7);
+        if ((device = registry->getDevice(addresses[i])) != NULL)
         {
-          if ((*address) == (*device)->getAddress())
-          {
-            *matchingDevice = *device;
-            matchingDevice++;
-          }
-          device++;
+          *matchingDevice = device;
+          matchingDevice++;
         }
-        address++;
       }
-      free (addresses);
       return matchingDevices;
     }
 
@@ -0,0 +1,94 @@
+/*
+Copyright (c) 2020, Analog Devices Inc
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  * Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  * Neither the name of the Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived from this
+    software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "LT_SMBusAlert.h"
+#include <poll.h>
+#include <errno.h>
+
+LT_SMBusAlert::LT_SMBusAlert(LT_SMBus *smbus, LT_AlertSource *source):ara_(smbus), source_(source)
+{
+  handlerCnt_ = 0;
+  addressCnt_ = 0;
+}
+
+bool LT_SMBusAlert::addHandler(LT_AlertHandler handler, void *context)
+{
+  if (handlerCnt_ >= ALERT_MAX_HANDLERS)
+    return false;
+
+  handlers_[handlerCnt_].handler = handler;
+  handlers_[handlerCnt_].context = context;
+  handlerCnt_++;
+  return true;
+}
+
+uint8_t LT_SMBusAlert::service()
+{
+  addressCnt_ = ara_.readAddresses(addresses_, ALERT_MAX_ADDRESSES);
+
+  for (uint8_t i = 0; i < addressCnt_; i++)
+    for (uint8_t j = 0; j < handlerCnt_; j++)
+      handlers_[j].handler(addresses_[i], handlers_[j].context);
+
+  return addressCnt_;
+}
+
+/*
+ * Wait for an alert
+ *
+ * SMBALERT# is wired OR, so it stays low while any device still has an
+ * alert. After the first round the line is checked and the ARA repeated
+ * until it is released, in case a device asserted it during the round.
+ */
+int LT_SMBusAlert::wait(int timeoutMs)
+{
+  struct pollfd pfd;
+  int result;
+
+  if (source_ == NULL || source_->getFd() < 0)
+    return -1;
+
+  pfd.fd = source_->getFd();
+  pfd.events = POLLIN | POLLPRI;
+  pfd.revents = 0;
+
+  do
+    result = poll(&pfd, 1, timeoutMs);
+  while (result < 0 && errno == EINTR);
+  if (result <= 0)
+    return result;
+
+  source_->acknowledge();
+
+  int total = 0;
+  uint8_t rounds = 0;
+  do
+    total += service();
+  while (++rounds < ALERT_MAX_ROUNDS && source_->isAsserted());
+
+  return total;
+}
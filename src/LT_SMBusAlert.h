@@ -0,0 +1,97 @@
+/*
+Copyright (c) 2020, Analog Devices Inc
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  * Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  * Neither the name of the Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived from this
+    software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LT_SMBusAlert_H_
+#define LT_SMBusAlert_H_
+
+#include <stdint.h>
+#include "LT_SMBus.h"
+#include "LT_SMBusARA.h"
+#include "LT_AlertSource.h"
+
+#define ALERT_MAX_ADDRESSES 128
+#define ALERT_MAX_HANDLERS 8
+#define ALERT_MAX_ROUNDS 8
+
+//! Called once for each device that answered the ARA.
+typedef void (*LT_AlertHandler)(uint8_t address, void *context);
+
+//! Waits for SMBALERT# on an alert source, then finds the alerting devices with the
+//! alert response address and passes each one to the registered handlers.
+//! Nothing is allocated while waiting or dispatching.
+class LT_SMBusAlert
+{
+  protected:
+    struct Handler
+    {
+      public:
+        LT_AlertHandler handler;
+        void *context;
+    };
+
+    LT_SMBusARA ara_;
+    LT_AlertSource *source_;
+    Handler handlers_[ALERT_MAX_HANDLERS];
+    uint8_t handlerCnt_;
+    uint8_t addresses_[ALERT_MAX_ADDRESSES];
+    uint8_t addressCnt_;
+
+  public:
+    //! Constructor
+    LT_SMBusAlert(LT_SMBus *smbus,          //!< bus to run the ARA on.
+                  LT_AlertSource *source    //!< where the alert comes from, or NULL to only use service().
+                 );
+
+    //! Register a handler.
+    //! @return false if there is no room for it
+    bool addHandler(LT_AlertHandler handler,    //!< function to call.
+                    void *context               //!< passed to the handler.
+                   );
+
+    //! Wait for an alert and dispatch it.
+    //! @return number of alerting devices, 0 on timeout, < 0 on error
+    int wait(int timeoutMs      //!< time to wait, -1 for ever.
+            );
+
+    //! Run the ARA now and dispatch whatever answered.
+    //! @return number of alerting devices
+    uint8_t service();
+
+    //! Get the addresses found by the last service(), valid until the next one.
+    uint8_t *getAddresses()
+    {
+      return addresses_;
+    }
+
+    //! Get the number of addresses found by the last service().
+    uint8_t getAddressCount()
+    {
+      return addressCnt_;
+    }
+};
+
+#endif /* LT_SMBusAlert_H_ */
@@ -44,30 +44,90 @@ extern "C"
 #endif
 }
 #include <errno.h>
+#include <string.h>
+#include <pthread.h>
 #include "LT_Exception.h"
 #include "LT_SMBusBase.h"
 
-#define FOUND_SIZE 0xFF
+#define MAX_BUSES 8
 
-bool LT_SMBusBase::open_ = true;
-uint8_t LT_SMBusBase::found_address_[FOUND_SIZE + 1];
-int32_t LT_SMBusBase::file_;
+// One entry per open i2c device. Each bus has its own handle, so buses can
+// be driven from separate threads, one thread per bus.
+static struct
+{
+  char dev[64];
+  int32_t file;
+  uint8_t users;
+} buses_[MAX_BUSES];
+static pthread_mutex_t busesLock_ = PTHREAD_MUTEX_INITIALIZER;
 
-LT_SMBusBase::LT_SMBusBase()
+LT_SMBusBase::LT_SMBusBase():file_(-1)
 {
 }
 
-LT_SMBusBase::LT_SMBusBase(uint32_t speed){}
+LT_SMBusBase::LT_SMBusBase(uint32_t speed):file_(-1){}
 
 LT_SMBusBase::~LT_SMBusBase()
 {
-  if (LT_SMBusBase::open_)
+  //printf("Closing\n");
+  closeBus(file_);
+}
+
+int32_t LT_SMBusBase::openBus(const char *dev)
+{
+  int32_t file = -1;
+  int free = -1;
+  int i;
+
+  pthread_mutex_lock(&busesLock_);
+  for (i = 0; i < MAX_BUSES; i++)
+  {
+    if (buses_[i].users == 0)
+    {
+      if (free < 0)
+        free = i;
+    }
+    else if (strcmp(buses_[i].dev, dev) == 0)
+      break;
+  }
+
+  if (i < MAX_BUSES)
+  {
+    buses_[i].users++;
+    file = buses_[i].file;
+  }
+  else if (free >= 0 && (file = open(dev, O_RDWR)) >= 0)
   {
-    //printf("Closing\n");
-    close(LT_SMBusBase::file_);
-    LT_SMBusBase::open_ = false;
+    strncpy(buses_[free].dev, dev, sizeof(buses_[free].dev) - 1);
+    buses_[free].dev[sizeof(buses_[free].dev) - 1] = 0;
+    buses_[free].file = file;
+    buses_[free].users = 1;
+  }
+  pthread_mutex_unlock(&busesLock_);
+  return file;
+}
 
+void LT_SMBusBase::closeBus(int32_t file)
+{
+  if (file < 0)
+    return;
+
+  pthread_mutex_lock(&busesLock_);
+  for (int i = 0; i < MAX_BUSES; i++)
+  {
+    if (buses_[i].users > 0 && buses_[i].file == file)
+    {
+      if (--buses_[i].users == 0)
+        close(file);
+      break;
+    }
   }
+  pthread_mutex_unlock(&busesLock_);
+}
+
+long LT_SMBusBase::adapterKey()
+{
+  return file_ >= 0 ? (long) file_ : (long) this;
 }
 
 void LT_SMBusBase::clearBuffer()
@@ -76,12 +136,12 @@ void LT_SMBusBase::clearBuffer()
   // This is intended to clear any data left over from a problem.
   // The known case of extra data is after a NACK.
   // Note that Rasp Pi also has a clock stretch bug.
-  read(LT_SMBusBase::file_, &buf, 256);
+  read(file_, &buf, 256);
 }
 
 void LT_SMBusBase::setPec()
 {
-  if (ioctl(LT_SMBusBase::file_, (unsigned long int)I2C_PEC, pec ? 1 : 0) < 0)
+  if (ioctl(file_, (unsigned long int)I2C_PEC, pec ? 1 : 0) < 0)
   {
     throw LT_Exception("Fail to set PEC");
   }
@@ -91,11 +151,11 @@ int LT_SMBusBase::writeByte(uint8_t address, uint8_t command, uint8_t data)
 {
 #if ENABLE_I2C
   setPec();
-  if (ioctl(LT_SMBusBase::file_, (unsigned long int)I2C_SLAVE, address) < 0)
+  if (ioctl(file_, (unsigned long int)I2C_SLAVE, address) < 0)
     throw LT_Exception("Write Byte: fail address");
   //printf("writeByte at address 0x%02x with command 0x%02x and data 0x%02x\n", address, command, data);
 
-  if (i2c_smbus_write_byte_data(LT_SMBusBase::file_, command, data) == -1)
+  if (i2c_smbus_write_byte_data(file_, command, data) == -1)
   {
     throw LT_Exception("Write Byte: fail data");
   }
@@ -139,11 +199,11 @@ int LT_SMBusBase::readByte(uint8_t address, uint8_t command)
   __s32 result;
 
   setPec();  
-  if (ioctl(LT_SMBusBase::file_, (unsigned long int)I2C_SLAVE, address) < 0)
+  if (ioctl(file_, (unsigned long int)I2C_SLAVE, address) < 0)
     throw LT_Exception("Read Byte: fail address");
   //printf("readByte at address 0x%02x with command 0x%02x\n", address, command);
 
-  if ((result = i2c_smbus_read_byte_data(LT_SMBusBase::file_, command)) == -1)
+  if ((result = i2c_smbus_read_byte_data(file_, command)) == -1)
   {
     throw LT_Exception("Read Byte: fail data");
   }
@@ -160,11 +220,11 @@ int LT_SMBusBase::writeWord(uint8_t address, uint8_t command, uint16_t data)
 {
 #if ENABLE_I2C
   setPec();
-  if (ioctl(LT_SMBusBase::file_, (unsigned long int)I2C_SLAVE, address) < 0)
+  if (ioctl(file_, (unsigned long int)I2C_SLAVE, address) < 0)
     throw LT_Exception("Write Word: fail address");
   //printf("writeWord at address 0x%02x with command 0x%02x with data 0x%02x\n", address, command,data);
 
-  if (i2c_smbus_write_word_data(LT_SMBusBase::file_, command, data) == -1)
+  if (i2c_smbus_write_word_data(file_, command, data) == -1)
   {
     throw LT_Exception("Write Word: fail data");
   }
@@ -182,10 +242,10 @@ int LT_SMBusBase::readWord(uint8_t address, uint8_t command)
   __s32 result;
 
   setPec();
-  if (ioctl(LT_SMBusBase::file_, (unsigned long int)I2C_SLAVE, address) < 0)
+  if (ioctl(file_, (unsigned long int)I2C_SLAVE, address) < 0)
     throw LT_Exception("Read Word: fail address");
   //printf("readWord at address 0x%02x with command 0x%02x\n", address, command);
-  if((result = i2c_smbus_read_word_data(LT_SMBusBase::file_, command)) == -1)
+  if((result = i2c_smbus_read_word_data(file_, command)) == -1)
   {
     char msg[132];
     sprintf(msg, "Read Word: fail data with address 0x%02 command 0x%02x result %d", address, command, result);
@@ -205,12 +265,12 @@ int LT_SMBusBase::writeBlock(uint8_t address, uint8_t command,
 #if ENABLE_I2C
   unsigned long funcs;
   setPec();
-  ioctl(LT_SMBusBase::file_, I2C_FUNCS, &funcs);
+  ioctl(file_, I2C_FUNCS, &funcs);
   if (funcs & I2C_FUNC_SMBUS_READ_BLOCK_DATA)
   {
-    if (ioctl(LT_SMBusBase::file_, (unsigned long int)I2C_SLAVE, address) < 0)
+    if (ioctl(file_, (unsigned long int)I2C_SLAVE, address) < 0)
       throw LT_Exception("Write Block: fail address");
-    if (i2c_smbus_write_block_data(LT_SMBusBase::file_, address, command, block) == -1)
+    if (i2c_smbus_write_block_data(file_, address, command, block) == -1)
     {
       throw LT_Exception("Write Block: fail data");
     }
@@ -242,13 +302,13 @@ int LT_SMBusBase::readBlock(uint8_t address, uint8_t command,
   uint8_t count;
   unsigned long funcs;
   setPec();
-  ioctl(LT_SMBusBase::file_, I2C_FUNCS, &funcs);
+  ioctl(file_, I2C_FUNCS, &funcs);
   if (funcs & I2C_FUNC_SMBUS_READ_BLOCK_DATA)
   {
-    if (ioctl(LT_SMBusBase::file_, (unsigned long int)I2C_SLAVE, address) < 0)
+    if (ioctl(file_, (unsigned long int)I2C_SLAVE, address) < 0)
       throw LT_Exception("Read Block: fail address");
 
-    count = i2c_smbus_read_block_data(LT_SMBusBase::file_, command, block);
+    count = i2c_smbus_read_block_data(file_, command, block);
     if (count == -1)
     {
       throw LT_Exception("Read Block: fail data");
@@ -270,10 +330,10 @@ int LT_SMBusBase::sendByte(uint8_t address, uint8_t command)
 {
 #if ENABLE_I2C
   setPec();
-  if (ioctl(LT_SMBusBase::file_, (unsigned long int)I2C_SLAVE, address) < 0)
+  if (ioctl(file_, (unsigned long int)I2C_SLAVE, address) < 0)
     throw LT_Exception("Send Byte: fail address");
 
-  if (i2c_smbus_write_byte(LT_SMBusBase::file_, command) == -1)
+  if (i2c_smbus_write_byte(file_, command) == -1)
   {
     throw LT_Exception("Send Byte: fail data");
   }
@@ -324,12 +384,12 @@ int LT_SMBusBase::waitForAck(uint8_t address, uint8_t command)
 {
 #if ENABLE_I2C
   setPec();
-  if (ioctl(LT_SMBusBase::file_, (unsigned long int)I2C_SLAVE, address) < 0)
+  if (ioctl(file_, (unsigned long int)I2C_SLAVE, address) < 0)
     throw LT_Exception("waitForAck: fail address");
 
   while (1)
   {
-    if (i2c_smbus_read_byte_data(LT_SMBusBase::file_, command) >= 0)
+    if (i2c_smbus_read_byte_data(file_, command) >= 0)
       return 0;
   }
   throw LT_Exception("waitForAck: fail read");
@@ -359,9 +419,9 @@ uint8_t* LT_SMBusBase::probe(uint8_t command)
   {
     if (address == 0x0C)
       continue;
-    if (ioctl(LT_SMBusBase::file_, (unsigned long int)I2C_SLAVE, address) < 0)
+    if (ioctl(file_, (unsigned long int)I2C_SLAVE, address) < 0)
       throw LT_Exception("Probe: fail address");
-    result = i2c_smbus_read_byte_data(LT_SMBusBase::file_, command);
+    result = i2c_smbus_read_byte_data(file_, command);
     if (result >= 0) 
     {
       if (found < FOUND_SIZE)
@@ -402,13 +462,13 @@ uint8_t *LT_SMBusBase::probeUnique(uint8_t command)
 
     //printf("File %d Addr 0x%x\n", file_, address);./
 
-    result = ioctl(LT_SMBusBase::file_, (unsigned long int)I2C_SLAVE, address);
+    result = ioctl(file_, (unsigned long int)I2C_SLAVE, address);
     if (result == EBUSY)
       continue;
     else if (result < 0)
       throw LT_Exception("Probe Unique: fail address");
 
-    result = i2c_smbus_read_byte_data(LT_SMBusBase::file_, command);
+    result = i2c_smbus_read_byte_data(file_, command);
 
     //printf("probe data result %d\n", result);
     if (result >= 0)
@@ -31,13 +31,21 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <stdio.h>
 #include "LT_SMBus.h"
 
+#define FOUND_SIZE 0xFF
+
 class LT_SMBusBase : public LT_SMBus
 {
   protected:
-    static bool open_;          //!< Used to ensure initialisation of i2c once
-    static uint8_t found_address_[];
-    static int32_t file_;
+    int32_t file_;              //!< Handle of the i2c device, shared by all objects on the same device
+    uint8_t found_address_[FOUND_SIZE + 1];
     bool pec;
+
+    //! Open the i2c device once, so PEC and no PEC objects on the same device share a handle.
+    //! @return handle or < 0
+    static int32_t openBus(const char *dev);
+
+    //! Release a handle from openBus, closing it when the last user is gone.
+    static void closeBus(int32_t file);
     
     LT_SMBusBase();
     LT_SMBusBase(uint32_t speed);
@@ -55,6 +63,9 @@ class LT_SMBusBase : public LT_SMBus
     //! Get the speed of the bus.
     uint32_t getSpeed();
 
+    //! Objects on the same i2c device share the handle, so it is the key.
+    long adapterKey();
+
     //! SMBus write byte command
     //! @return error < 0
     int writeByte(uint8_t address,     //!< Slave address
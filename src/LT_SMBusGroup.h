@@ -126,6 +126,13 @@ class LT_SMBusGroup : public LT_SMBusBase
     LT_SMBusGroup(LT_SMBus *, uint32_t speed);
     virtual ~LT_SMBusGroup(){}
 
+    //! Identify the adapter of the executor, so groups and buses on one adapter share a key.
+    //! @return the adapterKey() of the executor.
+    long adapterKey()
+    {
+      return executor->adapterKey();
+    }
+
     //! SMBus write byte command
     //! @return error < 0
     int writeByte(uint8_t address,   //!< Slave address
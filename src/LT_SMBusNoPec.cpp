@@ -46,17 +46,12 @@ extern "C"
 LT_SMBusNoPec::LT_SMBusNoPec() : LT_SMBusBase()
 {
 #if ENABLE_I2C
-  if (!LT_SMBusBase::open_)
+  file_ = openBus("/dev/i2c-0");
+  if (file_ < 0)
   {
-    file_ = open("/dev/i2c-0", O_RDWR);
-    if (LT_SMBusBase::file_ < 0)
-      {
-        throw LT_Exception("Fail to open");
-      }
-    clearBuffer();
-    LT_SMBusBase::open_ = true;
-    //printf ("Open NoPec handle %d\n", file_);
+    throw LT_Exception("Fail to open");
   }
+  clearBuffer();
 #endif
   pec = false;
 }
@@ -64,41 +59,25 @@ LT_SMBusNoPec::LT_SMBusNoPec() : LT_SMBusBase()
 LT_SMBusNoPec::LT_SMBusNoPec(char *dev) : LT_SMBusBase()
 {
 #if ENABLE_I2C
-  //printf("file_ is %d\n", LT_SMBusBase::file_);
-
-  if (!LT_SMBusBase::open_)
-    {
-      LT_SMBusBase::file_ = open(dev, O_RDWR);
-
-      if (LT_SMBusBase::file_ < 0)
-        {
-          throw LT_Exception("Fail to open");
-        }
-      clearBuffer();
-
-      LT_SMBusBase::open_ = true;
-      //printf ("Open NoPec device %s handle %d\n", dev, file_);
-    }
+  file_ = openBus(dev);
+  if (file_ < 0)
+  {
+    throw LT_Exception("Fail to open");
+  }
+  clearBuffer();
 #endif
   pec = false;
 }
 
-LT_SMBusNoPec::LT_SMBusNoPec(uint32_t speed)
+LT_SMBusNoPec::LT_SMBusNoPec(uint32_t speed) : LT_SMBusBase(speed)
 {
 #if ENABLE_I2C
-  if (!LT_SMBusBase::open_)
-    {
-      LT_SMBusBase::file_ = open("/dev/i2c-0", O_RDWR);
-
-      if (LT_SMBusBase::file_ < 0)
-      {
-        throw LT_Exception("Fail to open");
-      }
-      clearBuffer();
-
-      LT_SMBusBase::open_ = true;
-      //printf ("Open NoPec handle %d\n", file_);
-    }
+  file_ = openBus("/dev/i2c-0");
+  if (file_ < 0)
+  {
+    throw LT_Exception("Fail to open");
+  }
+  clearBuffer();
 #endif
   pec = false;
 }
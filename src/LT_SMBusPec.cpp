@@ -47,18 +47,12 @@ extern "C"
 LT_SMBusPec::LT_SMBusPec() : LT_SMBusBase()
 {
 #if ENABLE_I2C
-  if (LT_SMBusBase::file_ <= 0)
+  file_ = openBus("/dev/i2c-0");
+  if (file_ < 0)
   {
-    file_ = open("/dev/i2c-0", O_RDWR);
-    if (LT_SMBusBase::file_ < 0)
-      {
-        throw LT_Exception("Fail to open PEC");
-      }
-      clearBuffer();
-
-      LT_SMBusBase::open_ = true;
-      //printf ("Open NoPec handle %d", LT_SMBusBase::file_);
+    throw LT_Exception("Fail to open PEC");
   }
+  clearBuffer();
 #endif
   pec = true;
 }
@@ -66,38 +60,25 @@ LT_SMBusPec::LT_SMBusPec() : LT_SMBusBase()
 LT_SMBusPec::LT_SMBusPec(char *dev) : LT_SMBusBase()
 {
 #if ENABLE_I2C
-  //printf("file_ is %d\n", LT_SMBusBase::file_);
-  if (LT_SMBusBase::file_ <= 0)
+  file_ = openBus(dev);
+  if (file_ < 0)
   {
-    LT_SMBusBase::file_ = open(dev, O_RDWR);
-    if (LT_SMBusBase::file_ < 0)
-    {
-        throw LT_Exception("Fail to open PEC");
-    }
-    clearBuffer();
-
-    LT_SMBusBase::open_ = true;
-    //printf ("Open NoPec device %s handle %d\n", dev, file_);
+    throw LT_Exception("Fail to open PEC");
   }
+  clearBuffer();
 #endif
   pec = true;
 }
 
-LT_SMBusPec::LT_SMBusPec(uint32_t speed)
+LT_SMBusPec::LT_SMBusPec(uint32_t speed) : LT_SMBusBase(speed)
 {
 #if ENABLE_I2C
-  if (LT_SMBusBase::file_ <= 0)
+  file_ = openBus("/dev/i2c-0");
+  if (file_ < 0)
   {
-    LT_SMBusBase::file_ = open("/dev/i2c-0", O_RDWR);
-    if (LT_SMBusBase::file_ < 0)
-    {
-        printf("Fail to open PEC\n");
-    }
-    clearBuffer();
-
-    LT_SMBusBase::open_ = true;
-    //printf ("Open NoPec handle %d\n", LT_SMBusBase::file_);
+    throw LT_Exception("Fail to open PEC");
   }
+  clearBuffer();
 #endif
   pec = true;
 }
@@ -0,0 +1,250 @@
+/*
+Copyright (c) 2020, Analog Devices Inc
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  * Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  * Neither the name of the Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived from this
+    software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "LT_StoreCoordinator.h"
+#include "LT_Exception.h"
+#include "LT_Clock.h"
+#include <stdio.h>
+#include <string.h>
+#ifdef DMALLOC
+#include <dmalloc.h>
+#else
+#include <stdlib.h>
+#endif
+
+LT_StoreCoordinator::LT_StoreCoordinator(LT_PMBus *pmbus, uint32_t windowMs)
+{
+  pmbus_ = pmbus;
+  windowMs_ = windowMs;
+  budget_ = 0;
+  periodSec_ = 3600;
+  memset(devices_, 0, sizeof(devices_));
+  pmbus_->setStoreCoordinator(this);
+}
+
+LT_StoreCoordinator::~LT_StoreCoordinator()
+{
+  // A store that was asked for is made, even over budget.
+  flush(true);
+  if (pmbus_->getStoreCoordinator() == this)
+    pmbus_->setStoreCoordinator(NULL);
+}
+
+void LT_StoreCoordinator::setWindow(uint32_t windowMs)
+{
+  windowMs_ = windowMs;
+}
+
+void LT_StoreCoordinator::setBudget(uint16_t commits, uint32_t periodSec)
+{
+  budget_ = commits;
+  periodSec_ = periodSec;
+}
+
+void LT_StoreCoordinator::markDirty(uint8_t address)
+{
+  Device *device = &devices_[address & 0x7F];
+
+  if (device->pending == 0)
+    device->dirtyUs = LT_Clock::nowUs();
+  else
+    device->coalesced++;
+  device->pending |= STORE_USER_PENDING;
+}
+
+void LT_StoreCoordinator::markFaultLogDirty(uint8_t address)
+{
+  Device *device = &devices_[address & 0x7F];
+
+  if (device->pending == 0)
+    device->dirtyUs = LT_Clock::nowUs();
+  else if (device->pending & STORE_FAULT_LOG_PENDING)
+    device->coalesced++;
+  device->pending |= STORE_FAULT_LOG_PENDING;
+}
+
+uint8_t LT_StoreCoordinator::isDirty(uint8_t address)
+{
+  return devices_[address & 0x7F].pending;
+}
+
+/*
+ * Decide if a device is committed now
+ *
+ * A new budget period starts when the old one has passed. A device over
+ * budget keeps its pending stores, and is counted as deferred once until
+ * they are committed.
+ */
+bool LT_StoreCoordinator::isDue(Device *device, uint64_t now, bool flush, bool force)
+{
+  if (device->pending == 0)
+    return false;
+  if (!flush && now - device->dirtyUs < (uint64_t) windowMs_ * 1000)
+    return false;
+
+  if (now - device->periodUs >= (uint64_t) periodSec_ * 1000000)
+  {
+    device->periodUs = now;
+    device->periodCommits = 0;
+  }
+  if (!force && budget_ != 0 && device->periodCommits >= budget_)
+  {
+    if (!device->held)
+      device->deferred++;
+    device->held = true;
+    return false;
+  }
+  return true;
+}
+
+/*
+ * Commit one kind of store on all due devices
+ *
+ * All commands are sent before any part is waited on, so the EEPROM writes
+ * overlap. A part still busy from a previous command NACKs; it is waited on
+ * before its command is sent.
+ *
+ * kind: STORE_USER_PENDING or STORE_FAULT_LOG_PENDING
+ * due: devices to commit, indexed by address
+ */
+uint16_t LT_StoreCoordinator::commit(uint8_t kind, bool *due)
+{
+  uint8_t command = kind == STORE_USER_PENDING ? STORE_USER_ALL : MFR_FAULT_LOG_STORE;
+  bool started[128];
+  uint16_t count = 0;
+  uint8_t address;
+
+  for (address = 0; address < 128; address++)
+  {
+    started[address] = false;
+    if (!due[address] || !(devices_[address].pending & kind))
+      continue;
+    try
+    {
+      pmbus_->waitForNotBusy(address);
+      pmbus_->smbus()->sendByte(address, command);
+      started[address] = true;
+    }
+    catch (LT_Exception &ex)
+    {
+      devices_[address].errors++;
+    }
+  }
+
+  for (address = 0; address < 128; address++)
+  {
+    if (!started[address])
+      continue;
+    Device *device = &devices_[address];
+    try
+    {
+      pmbus_->smbus()->waitForAck(address, 0x00);
+      pmbus_->waitForNotBusy(address);
+      device->pending &= ~kind;
+      device->held = false;
+      device->commits++;
+      device->periodCommits++;
+      count++;
+    }
+    catch (LT_Exception &ex)
+    {
+      device->errors++;
+    }
+  }
+  return count;
+}
+
+uint16_t LT_StoreCoordinator::commitDue(bool *due)
+{
+  uint16_t count;
+
+  // User settings first, a part cannot store its fault log while it stores them.
+  count = commit(STORE_USER_PENDING, due);
+  count += commit(STORE_FAULT_LOG_PENDING, due);
+  return count;
+}
+
+uint16_t LT_StoreCoordinator::service()
+{
+  bool due[128];
+  uint64_t now = LT_Clock::nowUs();
+
+  for (uint8_t address = 0; address < 128; address++)
+    due[address] = isDue(&devices_[address], now, false, false);
+  return commitDue(due);
+}
+
+uint16_t LT_StoreCoordinator::flush(bool force)
+{
+  bool due[128];
+  uint64_t now = LT_Clock::nowUs();
+
+  for (uint8_t address = 0; address < 128; address++)
+    due[address] = isDue(&devices_[address], now, true, force);
+  return commitDue(due);
+}
+
+uint16_t LT_StoreCoordinator::flush(uint8_t *addresses, uint8_t no_addresses, bool force)
+{
+  bool due[128];
+  uint64_t now = LT_Clock::nowUs();
+  uint8_t index;
+
+  memset(due, 0, sizeof(due));
+  for (index = 0; index < no_addresses; index++)
+    due[addresses[index] & 0x7F] = isDue(&devices_[addresses[index] & 0x7F], now, true, force);
+  return commitDue(due);
+}
+
+uint32_t LT_StoreCoordinator::getCommits(uint8_t address)
+{
+  return devices_[address & 0x7F].commits;
+}
+
+uint16_t LT_StoreCoordinator::getRemaining(uint8_t address)
+{
+  Device *device = &devices_[address & 0x7F];
+
+  if (budget_ == 0)
+    return 0xFFFF;
+  if (LT_Clock::nowUs() - device->periodUs >= (uint64_t) periodSec_ * 1000000)
+    return budget_;
+  return device->periodCommits >= budget_ ? 0 : budget_ - device->periodCommits;
+}
+
+void LT_StoreCoordinator::print()
+{
+  for (uint8_t address = 0; address < 128; address++)
+  {
+    Device *device = &devices_[address];
+    if (device->commits == 0 && device->pending == 0 && device->errors == 0)
+      continue;
+    printf("0x%02x: %u commits, %u coalesced, %u deferred, %u errors%s\n", address,
+           device->commits, device->coalesced, device->deferred, device->errors,
+           device->pending ? ", pending" : "");
+  }
+}
@@ -0,0 +1,130 @@
+/*
+Copyright (c) 2020, Analog Devices Inc
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  * Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  * Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  * Neither the name of the Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived from this
+    software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL ANALOG DEVICES, INC. BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LT_StoreCoordinator_H_
+#define LT_StoreCoordinator_H_
+
+#include <stdint.h>
+#include "LT_PMBus.h"
+
+#define STORE_USER_PENDING      0x01  //!< STORE_USER_ALL is pending.
+#define STORE_FAULT_LOG_PENDING 0x02  //!< MFR_FAULT_LOG_STORE is pending.
+
+//! Defers and coalesces EEPROM stores. Each store is a long EEPROM commit that wears
+//! the part, so storeToNvm, storeToNvmAll and storeFaultLog only mark the device dirty
+//! while a coordinator is attached to the LT_PMBus. Stores marked within the window of
+//! the first become one commit, and the commits of all due devices are started back to
+//! back so the parts write their EEPROM at the same time. Each device has a budget of
+//! commits per period; a device over budget stays dirty until the period ends.
+class LT_StoreCoordinator
+{
+  protected:
+    struct Device
+    {
+      public:
+        uint8_t pending;          //!< STORE_*_PENDING bits.
+        uint64_t dirtyUs;         //!< time of the first mark since the last commit.
+        uint64_t periodUs;        //!< start of the budget period.
+        uint16_t periodCommits;   //!< commits in the budget period.
+        uint32_t commits;         //!< commits since construction.
+        uint32_t coalesced;       //!< marks that did not cause a commit of their own.
+        uint32_t deferred;        //!< times a due commit was held back by the budget.
+        uint32_t errors;          //!< commits that failed.
+        bool held;                //!< the pending stores are held back by the budget.
+    };
+
+    LT_PMBus *pmbus_;
+    Device devices_[128];
+    uint32_t windowMs_;
+    uint16_t budget_;
+    uint32_t periodSec_;
+
+    bool isDue(Device *device, uint64_t now, bool flush, bool force);
+    uint16_t commit(uint8_t kind, bool *due);
+    uint16_t commitDue(bool *due);
+
+  public:
+    //! Constructor. Attaches itself to the LT_PMBus.
+    LT_StoreCoordinator(LT_PMBus *pmbus,      //!< bus of the devices.
+                        uint32_t windowMs     //!< time to collect stores before a commit.
+                       );
+    //! Commits all pending stores, ignoring the budget, and detaches itself from the LT_PMBus.
+    ~LT_StoreCoordinator();
+
+    //! Set the window stores are collected in before a commit.
+    void setWindow(uint32_t windowMs    //!< window in ms.
+                  );
+
+    //! Set the budget of commits per device.
+    void setBudget(uint16_t commits,    //!< commits allowed in a period, 0 for no limit.
+                   uint32_t periodSec   //!< length of the period in seconds.
+                  );
+
+    //! Mark the user settings of a device dirty.
+    void markDirty(uint8_t address      //!< Slave address
+                  );
+
+    //! Mark the fault log of a device dirty.
+    void markFaultLogDirty(uint8_t address      //!< Slave address
+                          );
+
+    //! Check if a device has a pending store.
+    //! @return STORE_*_PENDING bits.
+    uint8_t isDirty(uint8_t address      //!< Slave address
+                   );
+
+    //! Commit the stores whose window has passed and that are within budget.
+    //! Call regularly.
+    //! @return number of commits.
+    uint16_t service();
+
+    //! Commit all pending stores now.
+    //! @return number of commits.
+    uint16_t flush(bool force        //!< ignore the budget if true.
+                  );
+
+    //! Commit the pending stores of some devices now, for example before they restore from NVM.
+    //! @return number of commits.
+    uint16_t flush(uint8_t *addresses,    //!< Slave addresses
+                   uint8_t no_addresses,  //!< Number of slave addresses
+                   bool force             //!< ignore the budget if true.
+                  );
+
+    //! Get the number of commits of a device.
+    uint32_t getCommits(uint8_t address      //!< Slave address
+                       );
+
+    //! Get the number of commits left in the budget period of a device.
+    //! @return remaining commits, or 0xFFFF if there is no budget.
+    uint16_t getRemaining(uint8_t address      //!< Slave address
+                         );
+
+    //! Print the commits per device.
+    void print();
+};
+
+#endif /* LT_StoreCoordinator_H_ */
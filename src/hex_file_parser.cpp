@@ -68,6 +68,7 @@ THE SOFTWARE.
 */
 
 #include "hex_file_parser.h"
+#include "LT_IspArena.h"
 #include <stdio.h>
 #include <string.h>
     
@@ -101,85 +102,243 @@ uint8_t detect_colons(uint8_t (*get_data)(void))
   return c;
 }
 
+/*
+ * Nibble values of ASCII hex digits. Anything else has HEX_BAD set so a run
+ * of digits can be checked once by or-ing the nibbles together.
+ */
+#define HEX_BAD 0x100
+
+static struct HexNibbles
+{
+  uint16_t value[256];
+
+  HexNibbles()
+  {
+    int i;
+
+    for (i = 0; i < 256; i++)
+      value[i] = HEX_BAD;
+    for (i = 0; i < 10; i++)
+      value['0' + i] = i;
+    for (i = 0; i < 6; i++)
+    {
+      value['a' + i] = 10 + i;
+      value['A' + i] = 10 + i;
+    }
+  }
+} nibbles;
+
+/*
+ * Vector hex decoding
+ *
+ * Each character is turned into a nibble as a digit and as a letter, and
+ * whichever is in range is kept; a character that is neither marks the run
+ * bad. Pairs of nibbles are multiplied and added into bytes (maddubs), then
+ * packed. The byte sum for the record checksum comes from the same registers
+ * (sad). Only whole blocks are loaded, the tail is done with the table.
+ */
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define HEX_SIMD_X86 1
+
+__attribute__((target("avx2")))
+static bool decode_hex_avx2(const char *in_data, uint16_t blocks, uint8_t *out_data, uint32_t *sum)
+{
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i valid = _mm256_set1_epi8((char) 0xFF);
+  __m256i sums = zero;
+  uint16_t i;
+
+  for (i = 0; i < blocks; i++)
+  {
+    __m256i c = _mm256_loadu_si256((const __m256i *) (in_data + 32 * i));
+    __m256i digit = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+    __m256i letter = _mm256_sub_epi8(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+    __m256i isDigit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+    __m256i isLetter = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter);
+    __m256i nibble = _mm256_or_si256(_mm256_and_si256(digit, isDigit),
+                                     _mm256_and_si256(_mm256_add_epi8(letter, _mm256_set1_epi8(10)), isLetter));
+    __m256i bytes = _mm256_maddubs_epi16(nibble, _mm256_set1_epi16(0x0110));
+
+    valid = _mm256_and_si256(valid, _mm256_or_si256(isDigit, isLetter));
+    bytes = _mm256_permute4x64_epi64(_mm256_packus_epi16(bytes, zero), 0xD8);
+    sums = _mm256_add_epi64(sums, _mm256_sad_epu8(bytes, zero));
+    _mm_storeu_si128((__m128i *) (out_data + 16 * i), _mm256_castsi256_si128(bytes));
+  }
+  *sum += (uint32_t) (_mm256_extract_epi64(sums, 0) + _mm256_extract_epi64(sums, 1)
+                      + _mm256_extract_epi64(sums, 2) + _mm256_extract_epi64(sums, 3));
+  return _mm256_movemask_epi8(valid) == -1;
+}
+
+__attribute__((target("ssse3")))
+static bool decode_hex_ssse3(const char *in_data, uint16_t blocks, uint8_t *out_data, uint32_t *sum)
+{
+  const __m128i zero = _mm_setzero_si128();
+  __m128i valid = _mm_set1_epi8((char) 0xFF);
+  __m128i sums = zero;
+  uint16_t i;
+
+  for (i = 0; i < blocks; i++)
+  {
+    __m128i c = _mm_loadu_si128((const __m128i *) (in_data + 16 * i));
+    __m128i digit = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+    __m128i letter = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+    __m128i isLetter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+    __m128i nibble = _mm_or_si128(_mm_and_si128(digit, isDigit),
+                                  _mm_and_si128(_mm_add_epi8(letter, _mm_set1_epi8(10)), isLetter));
+    __m128i bytes = _mm_packus_epi16(_mm_maddubs_epi16(nibble, _mm_set1_epi16(0x0110)), zero);
+
+    valid = _mm_and_si128(valid, _mm_or_si128(isDigit, isLetter));
+    sums = _mm_add_epi64(sums, _mm_sad_epu8(bytes, zero));
+    _mm_storel_epi64((__m128i *) (out_data + 8 * i), bytes);
+  }
+  *sum += (uint32_t) _mm_cvtsi128_si32(sums);
+  return _mm_movemask_epi8(valid) == 0xFFFF;
+}
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define HEX_SIMD_NEON 1
+
+static bool decode_hex_neon(const char *in_data, uint16_t blocks, uint8_t *out_data, uint32_t *sum)
+{
+  uint8x16_t valid = vdupq_n_u8(0xFF);
+  uint16_t i;
+
+  for (i = 0; i < blocks; i++)
+  {
+    uint8x16_t c = vld1q_u8((const uint8_t *) (in_data + 16 * i));
+    uint8x16_t digit = vsubq_u8(c, vdupq_n_u8('0'));
+    uint8x16_t letter = vsubq_u8(vorrq_u8(c, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+    uint8x16_t isDigit = vcltq_u8(digit, vdupq_n_u8(10));
+    uint8x16_t isLetter = vcltq_u8(letter, vdupq_n_u8(6));
+    uint8x16_t nibble = vorrq_u8(vandq_u8(digit, isDigit),
+                                 vandq_u8(vaddq_u8(letter, vdupq_n_u8(10)), isLetter));
+    uint8x8_t bytes = vget_low_u8(vorrq_u8(vshlq_n_u8(vuzp1q_u8(nibble, nibble), 4),
+                                           vuzp2q_u8(nibble, nibble)));
+
+    valid = vandq_u8(valid, vorrq_u8(isDigit, isLetter));
+    *sum += vaddlv_u8(bytes);
+    vst1_u8(out_data + 8 * i, bytes);
+  }
+  return vminvq_u8(valid) == 0xFF;
+}
+#endif
+
+/*
+ * Decode ASCII hex into bytes
+ *
+ * in_data:    2 * out_length hex digits, either case
+ * out_length: bytes to decode
+ * out_data:   where the bytes go
+ * sum:        the bytes are added to it, for record checksums
+ * return:     false if a character is not a hex digit
+ */
+bool decode_hex(const char *in_data, uint16_t out_length, uint8_t *out_data, uint8_t *sum)
+{
+  uint32_t total = *sum;
+  uint16_t bad = 0;
+  uint16_t done = 0;
+  uint16_t hi, lo;
+
+#if HEX_SIMD_X86
+  static const int level = __builtin_cpu_supports("avx2") ? 2 : __builtin_cpu_supports("ssse3") ? 1 : 0;
+
+  if (level == 2 && out_length >= 16)
+  {
+    done = out_length & ~15;
+    if (!decode_hex_avx2(in_data, done / 16, out_data, &total))
+      return false;
+  }
+  else if (level == 1 && out_length >= 8)
+  {
+    done = out_length & ~7;
+    if (!decode_hex_ssse3(in_data, done / 8, out_data, &total))
+      return false;
+  }
+#elif HEX_SIMD_NEON
+  if (out_length >= 8)
+  {
+    done = out_length & ~7;
+    if (!decode_hex_neon(in_data, done / 8, out_data, &total))
+      return false;
+  }
+#endif
+  for (; done < out_length; done++)
+  {
+    hi = nibbles.value[(uint8_t) in_data[2 * done]];
+    lo = nibbles.value[(uint8_t) in_data[2 * done + 1]];
+    bad |= hi | lo;
+    out_data[done] = (uint8_t) ((hi << 4) | lo);
+    total += out_data[done];
+  }
+  *sum = (uint8_t) total;
+  return (bad & HEX_BAD) == 0;
+}
+
 /*
  * Parse a list of hex file bytes returning a list of ltc record bytes
  *
  * in_data:   buffer of hex data
  * in_length: length of the hex data
  * out_data:  preallocated buffer where the output data will be put
- * return:    actual size of the output data
+ * return:    actual size of the output data, 0 if a record is not hex or
+ *            its checksum is wrong
  *
- * Notes:     CRC is ignored. No error processing; original data must be correct.
- *        Copies char input data so that it can be const, and frees when done.
- *        It is best to use const input so that memory usage is only temporary.
+ * Notes:     in_data is not changed.
  */
 uint16_t parse_hex_block(char *in_data, uint16_t in_length, uint8_t *out_data)
 {
   uint16_t    in_position;
   uint16_t    out_position;
-  uint8_t     start_code;
-  uint16_t    byte_count;
-  uint16_t    record_type;
-  uint32_t    address;
-  uint16_t    crc;
-  uint8_t     save;
-  uint16_t    i;
+  uint8_t     header[4];
+  uint8_t     crc;
+  uint8_t     sum;
 
   in_position = 0;
   out_position = 0;
 
   while (1)
   {
-    // Get colon
-    start_code = in_data[in_position];
+    // Find the colon
+    while (in_position < in_length && in_data[in_position] != ':')
+      in_position += 1;
+    if (in_position + 11 > in_length)
+      break;
     in_position += 1;
 
-    save = in_data[in_position+2];
-    in_data[in_position+2] = '\0';
-    byte_count = httoi(&in_data[in_position]);
-    in_data[in_position+2] = save;
-    in_position += 2;
-
-    save = in_data[in_position+4];
-    in_data[in_position+4] = '\0';
-    address = httoi(&in_data[in_position]);
-    in_data[in_position+4] = save;
-    in_position += 4;
-
-    save = in_data[in_position+2];
-    in_data[in_position+2] = '\0';
-    record_type = httoi(&in_data[in_position]);
-    in_data[in_position+2] = save;
-    in_position += 2;
-
+    // Byte count, address and record type
+    sum = 0;
+    if (!decode_hex(&in_data[in_position], 4, header, &sum))
+      return 0;
+    in_position += 8;
+    if (in_position + header[0] * 2 + 2 > in_length)
+      return 0;
 
-    for (i = 0; i < byte_count; i++)
+    if (header[3] == 0)
     {
-      save = in_data[in_position+2];
-      in_data[in_position+2] = '\0';
-      out_data[out_position] = httoi(&in_data[in_position]);
-      in_data[in_position+2] = save;
-      in_position += 2;
-
-      out_position += 1;
+      if (!decode_hex(&in_data[in_position], header[0], &out_data[out_position], &sum))
+        return 0;
+      out_position += header[0];
     }
+    else
+    {
+      uint8_t skip[255];
+      if (!decode_hex(&in_data[in_position], header[0], skip, &sum))
+        return 0;
+    }
+    in_position += header[0] * 2;
 
-
-    save = in_data[in_position+2];
-    in_data[in_position+2] = '\0';
-    crc = httoi(&in_data[in_position]);
-    in_data[in_position+2] = save;
+    if (!decode_hex(&in_data[in_position], 1, &crc, &sum) || sum != 0)
+      return 0;
     in_position += 2;
-
-    if (in_position >= in_length)
-      break;
   }
   return out_position;
 }
 
-static uint8_t *parse_data = NULL;
-static uint16_t parse_data_length = 0;
-static uint16_t parse_data_position = 0;
+static thread_local uint8_t *parse_data = NULL;
+static thread_local uint16_t parse_data_length = 0;
+static thread_local uint16_t parse_data_position = 0;
 
 void reset_parse_hex()
 {
@@ -312,8 +471,8 @@ pRecordHeaderLengthAndType parse_record(uint8_t (*get_data)(void))
 
 //  printf("Rec A: %d, 0x%x\n", recordA.Length, recordA.RecordType);
 
-  // Allocate enough memory for the whole record
-  data = (uint8_t *)malloc(recordA.Length + sizeof(tRecordHeaderLengthAndType));
+  // Allocate enough memory for the whole record, from the session arena if there is one
+  data = (uint8_t *)ispAlloc(recordA.Length + sizeof(tRecordHeaderLengthAndType));
 
   // Copy the header portion of the data
   memcpy(data, &recordA, sizeof(tRecordHeaderLengthAndType));
@@ -82,6 +82,7 @@ THE SOFTWARE.
 extern uint8_t filter_terminations(uint8_t (*get_data)(void));
 extern uint8_t detect_colons(uint8_t (*get_data)(void));
 extern void reset_parse_hex(void);
+extern bool decode_hex(const char *in_data, uint16_t out_length, uint8_t *out_data, uint8_t *sum);
 extern uint16_t parse_hex_block(char *in_data, uint16_t in_length, uint8_t *out_data);
 extern uint8_t parse_hex(uint8_t (*get_data)(void));
 extern uint16_t parse_records(uint8_t *in_data, uint16_t in_length, tRecordHeaderLengthAndType **out_records);
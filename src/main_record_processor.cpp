@@ -64,8 +64,153 @@ uint8_t recordProcessor___0x21___modifyWordOptionalPEC(t_RECORD_PMBUS_MODIFY_WOR
 
 /** VARIABLES ******************************************************/
 
-static bool verification_in_progress = false;
-static bool ignore_records = false;
+
+/********************************************************************
+ * Function:        uint8_t processRecord(pRecordHeaderLengthAndType record_to_process);
+ *
+ * PreCondition:    None
+ * Input:           A record
+ * Output:          Returns SUCCESS (1) or FAILURE (0) depending on the status of parsing the record
+ * Overview:        Processes one record and frees it, except NVM data which is freed after verify
+ * Note:            Used by processRecordsOnDemand and by schedulers that pick the record order
+ *******************************************************************/
+uint8_t processRecord(pRecordHeaderLengthAndType record_to_process)
+{
+  uint16_t recordType_of_record_to_process = record_to_process->RecordType;
+  uint8_t successful_parse_of_record_type = SUCCESS;
+
+  if (nvmSkipRecord(record_to_process))
+  {
+    ispFree(record_to_process);
+    return SUCCESS;
+  }
+
+  switch (recordType_of_record_to_process)
+  {
+    case RECORD_TYPE_PMBUS_WRITE_BYTE: // 0x01
+      successful_parse_of_record_type = recordProcessor___0x01___processWriteByteOptionalPEC( (t_RECORD_PMBUS_WRITE_BYTE *) record_to_process);
+      break;
+    case RECORD_TYPE_PMBUS_WRITE_WORD: // 0x02
+      successful_parse_of_record_type = recordProcessor___0x02___processWriteWordOptionalPEC( (t_RECORD_PMBUS_WRITE_WORD *) record_to_process);
+      break;
+    case RECORD_TYPE_PMBUS_WRITE_BLOCK: // 0x03
+      successful_parse_of_record_type = FAILURE; // Unsupported Record Type
+      break;
+    case RECORD_TYPE_PMBUS_READ_BYTE_EXPECT: // 0x04
+      successful_parse_of_record_type = recordProcessor___0x04___processReadByteExpectOptionalPEC( (t_RECORD_PMBUS_READ_BYTE_EXPECT *) record_to_process);
+      break;
+    case RECORD_TYPE_PMBUS_READ_WORD_EXPECT: // 0x05
+      successful_parse_of_record_type = recordProcessor___0x05___processReadWordExpectOptionalPEC( (t_RECORD_PMBUS_READ_WORD_EXPECT *) record_to_process);
+      break;
+    case RECORD_TYPE_PMBUS_READ_BLOCK_EXPECT: // 0x06
+      successful_parse_of_record_type = FAILURE; // Unsupported Record Type
+      break;
+    case RECORD_TYPE_DEVICE_ADDRESS: // 0x07 -- OBSOLETED
+      successful_parse_of_record_type = SUCCESS; // Do nothing for this record type, but do not fail
+      break;
+    case RECORD_TYPE_PACKING_CODE: // 0x08 -- OBSOLETED
+      successful_parse_of_record_type = SUCCESS; // Do nothing for this record type, but do not fail
+      break;
+    case RECORD_TYPE_NVM_DATA: // 0x09 -- FUNCTIONALITY CHANGED 25/01/2011
+      successful_parse_of_record_type = recordProcessor___0x09___bufferNVMData( (t_RECORD_NVM_DATA *) record_to_process);
+      break;
+    case RECORD_TYPE_PMBUS_READ_BYTE_LOOP_MASK: // 0x0A
+      successful_parse_of_record_type = recordProcessor___0x0A___processReadByteLoopMaskOptionalPEC( (t_RECORD_PMBUS_READ_BYTE_LOOP_MASK *) record_to_process);
+      break;
+    case RECORD_TYPE_PMBUS_READ_WORD_LOOP_MASK: //0x0B
+      successful_parse_of_record_type = recordProcessor___0x0B___processReadWordLoopMaskOptionalPEC( (t_RECORD_PMBUS_READ_WORD_LOOP_MASK *) record_to_process);
+      break;
+    case RECORD_TYPE_PMBUS_POLL_UNTIL_ACK_NOPEC: // 0x0C
+      successful_parse_of_record_type = recordProcessor___0x0C___processPollReadByteUntilAckNoPEC( (t_RECORD_PMBUS_POLL_READ_BYTE_UNTIL_ACK *) record_to_process);
+      break;
+    case RECORD_TYPE_DELAY_MS: // 0x0D
+      successful_parse_of_record_type = recordProcessor___0x0D___processDelayMs( (t_RECORD_DELAY_MS *) record_to_process);
+      break;
+    case RECORD_TYPE_PMBUS_SEND_BYTE: //0x0E
+      successful_parse_of_record_type = recordProcessor___0x0E___processSendByteOptionalPEC( (t_RECORD_PMBUS_SEND_BYTE *) record_to_process);
+      break;
+    case RECORD_TYPE_PMBUS_WRITE_BYTE_NOPEC: // 0x0F
+      successful_parse_of_record_type = recordProcessor___0x0F___processWriteByteNoPEC( (t_RECORD_PMBUS_WRITE_BYTE_NOPEC *) record_to_process);
+      break;
+    case RECORD_TYPE_PMBUS_WRITE_WORD_NOPEC: // 0x10
+      successful_parse_of_record_type = recordProcessor___0x10___processWriteWordNoPEC( (t_RECORD_PMBUS_WRITE_WORD_NOPEC *) record_to_process);
+      break;
+    case RECORD_TYPE_PMBUS_WRITE_BLOCK_NOPEC: // 0x11
+      successful_parse_of_record_type = FAILURE; // Unsupported Record Type
+      break;
+    case RECORD_TYPE_PMBUS_READ_BYTE_EXPECT_NOPEC: // 0x12
+      successful_parse_of_record_type = recordProcessor___0x12___processReadByteExpectNoPEC( (t_RECORD_PMBUS_READ_BYTE_EXPECT_NOPEC *) record_to_process);
+      break;
+    case RECORD_TYPE_PMBUS_READ_WORD_EXPECT_NOPEC: // 0x13
+      successful_parse_of_record_type = recordProcessor___0x13___processReadWordExpectNoPEC( (t_RECORD_PMBUS_READ_WORD_EXPECT_NOPEC *) record_to_process);
+      break;
+    case RECORD_TYPE_PMBUS_READ_BLOCK_EXPECT_NOPEC: // 0x14
+      successful_parse_of_record_type = FAILURE; // Unsupported Record Type
+      break;
+    case RECORD_TYPE_PMBUS_READ_BYTE_LOOP_MASK_NOPEC: // 0x15
+      successful_parse_of_record_type = recordProcessor___0x15___processReadByteLoopMaskNoPEC( (t_RECORD_PMBUS_READ_BYTE_LOOP_MASK_NOPEC *) record_to_process);
+      break;
+    case RECORD_TYPE_PMBUS_READ_WORD_LOOP_MASK_NOPEC: // 0x16
+      successful_parse_of_record_type = recordProcessor___0x16___processReadWordLoopMaskNoPEC( (t_RECORD_PMBUS_READ_WORD_LOOP_MASK_NOPEC *) record_to_process);
+      break;
+    case RECORD_TYPE_PMBUS_SEND_BYTE_NOPEC: // 0x17
+      successful_parse_of_record_type = recordProcessor___0x17___processSendByteNoPEC( (t_RECORD_PMBUS_SEND_BYTE_NOPEC *) record_to_process);
+      break;
+    case RECORD_TYPE_EVENT: // 0x18
+      successful_parse_of_record_type = recordProcessor___0x18___processEvent( (t_RECORD_EVENT *) record_to_process);
+      break;
+    case RECORD_TYPE_PMBUS_READ_BYTE_EXPECT_MASK_NOPEC: // 0x19
+      successful_parse_of_record_type = recordProcessor___0x19___processReadByteExpectMaskNoPEC( (t_RECORD_PMBUS_READ_BYTE_EXPECT_MASK_NOPEC *) record_to_process);
+      break;
+    case RECORD_TYPE_PMBUS_READ_WORD_EXPECT_MASK_NOPEC: //0x1A
+      successful_parse_of_record_type = recordProcessor___0x1A___processReadWordExpectMaskNoPEC( (t_RECORD_PMBUS_READ_WORD_EXPECT_MASK_NOPEC *) record_to_process);
+      break;
+    case RECORD_TYPE_VARIABLE_META_DATA: // 0x1B
+      successful_parse_of_record_type = recordProcessor___0x1B___processVariableMetaData( (t_RECORD_VARIABLE_META_DATA *) record_to_process);
+      break;
+    case RECORD_TYPE_MODIFY_WORD_NOPEC: // 0x1C
+      successful_parse_of_record_type = recordProcessor___0x1C___modifyWordNoPEC( (t_RECORD_PMBUS_MODIFY_WORD_NO_PEC *) record_to_process);
+      break;
+    case RECORD_TYPE_MODIFY_BYTE_NOPEC: // 0x1D
+      successful_parse_of_record_type = recordProcessor___0x1D___modifyByteNoPEC( (t_RECORD_PMBUS_MODIFY_BYTE_NO_PEC *) record_to_process);
+      break;
+    case RECORD_TYPE_PMBUS_WRITE_EE_DATA: // 0x1E
+      successful_parse_of_record_type = recordProcessor___0x1E___writeNvmData( (t_RECORD_NVM_DATA *) record_to_process);
+      break;
+    case RECORD_TYPE_PMBUS_READ_AND_VERIFY_EE_DATA: // 0x1F
+      successful_parse_of_record_type = recordProcessor___0x1F___read_then_verifyNvmData( (t_RECORD_NVM_DATA *) record_to_process);
+      break;
+    case RECORD_TYPE_PMBUS_MODIFY_BYTE: // 0x20
+      successful_parse_of_record_type = recordProcessor___0x20___modifyByteOptionalPEC( (t_RECORD_PMBUS_MODIFY_BYTE *) record_to_process);
+      break;
+    case RECORD_TYPE_PMBUS_MODIFY_WORD: // 0x21
+      successful_parse_of_record_type = recordProcessor___0x21___modifyWordOptionalPEC( (t_RECORD_PMBUS_MODIFY_WORD *) record_to_process);
+      break;
+    case RECORD_TYPE_END_OF_RECORDS: // 0x22
+      successful_parse_of_record_type = SUCCESS;
+      break;
+    default:
+      successful_parse_of_record_type = FAILURE; // Unknown Instruction, report a failure
+      break;
+  }
+
+  if (recordType_of_record_to_process == RECORD_TYPE_NVM_DATA)
+  {
+    // The record is freed after verify. Follow the calls down recordProcessor___0x1F___read_then_verifyNvmData.
+  }
+  else if (successful_parse_of_record_type == 0)
+  {
+//      printf("Free Rec: %d, 0x%x\n", record_to_process->Length, record_to_process->RecordType);
+    ispFree(record_to_process);
+  }
+  else
+  {
+//      printf("Free Rec: %d, 0x%x\n", record_to_process->Length, record_to_process->RecordType);
+    ispFree(record_to_process);
+  }
+
+  return successful_parse_of_record_type;
+}
 
 /********************************************************************
  * Function:        uint8_t processRecordsOnDemand(_InCircuitProgrammingRecordTypeListItem_p node, uint16_t length);
@@ -74,145 +219,22 @@ static bool ignore_records = false;
  * Input:           Function to get records one by one
  * Output:          Returns SUCCESS (0) or FAILURE (0) depending on the status of parsing ALL the record types
  * Overview:        Processes all the records until the function to get records returns null
- *          Records are freed as processed.
+ *          Records are freed as processed, or with the session arena.
  * Note:            None
  *******************************************************************/
 uint8_t processRecordsOnDemand(pRecordHeaderLengthAndType (*getRecord)(void))
 {
   pRecordHeaderLengthAndType record_to_process;
-  uint16_t recordType_of_record_to_process;
   uint8_t successful_parse_of_record_type = SUCCESS;
 
   while ((record_to_process = getRecord()) != NULL && successful_parse_of_record_type == SUCCESS)
   {
-    recordType_of_record_to_process = record_to_process->RecordType;
-
-    switch (recordType_of_record_to_process)
-    {
-      case RECORD_TYPE_PMBUS_WRITE_BYTE: // 0x01
-        successful_parse_of_record_type = recordProcessor___0x01___processWriteByteOptionalPEC( (t_RECORD_PMBUS_WRITE_BYTE *) record_to_process);
-        break;
-      case RECORD_TYPE_PMBUS_WRITE_WORD: // 0x02
-        successful_parse_of_record_type = recordProcessor___0x02___processWriteWordOptionalPEC( (t_RECORD_PMBUS_WRITE_WORD *) record_to_process);
-        break;
-      case RECORD_TYPE_PMBUS_WRITE_BLOCK: // 0x03
-        successful_parse_of_record_type = FAILURE; // Unsupported Record Type
-        break;
-      case RECORD_TYPE_PMBUS_READ_BYTE_EXPECT: // 0x04
-        successful_parse_of_record_type = recordProcessor___0x04___processReadByteExpectOptionalPEC( (t_RECORD_PMBUS_READ_BYTE_EXPECT *) record_to_process);
-        break;
-      case RECORD_TYPE_PMBUS_READ_WORD_EXPECT: // 0x05
-        successful_parse_of_record_type = recordProcessor___0x05___processReadWordExpectOptionalPEC( (t_RECORD_PMBUS_READ_WORD_EXPECT *) record_to_process);
-        break;
-      case RECORD_TYPE_PMBUS_READ_BLOCK_EXPECT: // 0x06
-        successful_parse_of_record_type = FAILURE; // Unsupported Record Type
-        break;
-      case RECORD_TYPE_DEVICE_ADDRESS: // 0x07 -- OBSOLETED
-        successful_parse_of_record_type = SUCCESS; // Do nothing for this record type, but do not fail
-        break;
-      case RECORD_TYPE_PACKING_CODE: // 0x08 -- OBSOLETED
-        successful_parse_of_record_type = SUCCESS; // Do nothing for this record type, but do not fail
-        break;
-      case RECORD_TYPE_NVM_DATA: // 0x09 -- FUNCTIONALITY CHANGED 25/01/2011
-        successful_parse_of_record_type = recordProcessor___0x09___bufferNVMData( (t_RECORD_NVM_DATA *) record_to_process);
-        break;
-      case RECORD_TYPE_PMBUS_READ_BYTE_LOOP_MASK: // 0x0A
-        successful_parse_of_record_type = recordProcessor___0x0A___processReadByteLoopMaskOptionalPEC( (t_RECORD_PMBUS_READ_BYTE_LOOP_MASK *) record_to_process);
-        break;
-      case RECORD_TYPE_PMBUS_READ_WORD_LOOP_MASK: //0x0B
-        successful_parse_of_record_type = recordProcessor___0x0B___processReadWordLoopMaskOptionalPEC( (t_RECORD_PMBUS_READ_WORD_LOOP_MASK *) record_to_process);
-        break;
-      case RECORD_TYPE_PMBUS_POLL_UNTIL_ACK_NOPEC: // 0x0C
-        successful_parse_of_record_type = recordProcessor___0x0C___processPollReadByteUntilAckNoPEC( (t_RECORD_PMBUS_POLL_READ_BYTE_UNTIL_ACK *) record_to_process);
-        break;
-      case RECORD_TYPE_DELAY_MS: // 0x0D
-        successful_parse_of_record_type = recordProcessor___0x0D___processDelayMs( (t_RECORD_DELAY_MS *) record_to_process);
-        break;
-      case RECORD_TYPE_PMBUS_SEND_BYTE: //0x0E
-        successful_parse_of_record_type = recordProcessor___0x0E___processSendByteOptionalPEC( (t_RECORD_PMBUS_SEND_BYTE *) record_to_process);
-        break;
-      case RECORD_TYPE_PMBUS_WRITE_BYTE_NOPEC: // 0x0F
-        successful_parse_of_record_type = recordProcessor___0x0F___processWriteByteNoPEC( (t_RECORD_PMBUS_WRITE_BYTE_NOPEC *) record_to_process);
-        break;
-      case RECORD_TYPE_PMBUS_WRITE_WORD_NOPEC: // 0x10
-        successful_parse_of_record_type = recordProcessor___0x10___processWriteWordNoPEC( (t_RECORD_PMBUS_WRITE_WORD_NOPEC *) record_to_process);
-        break;
-      case RECORD_TYPE_PMBUS_WRITE_BLOCK_NOPEC: // 0x11
-        successful_parse_of_record_type = FAILURE; // Unsupported Record Type
-        break;
-      case RECORD_TYPE_PMBUS_READ_BYTE_EXPECT_NOPEC: // 0x12
-        successful_parse_of_record_type = recordProcessor___0x12___processReadByteExpectNoPEC( (t_RECORD_PMBUS_READ_BYTE_EXPECT_NOPEC *) record_to_process);
-        break;
-      case RECORD_TYPE_PMBUS_READ_WORD_EXPECT_NOPEC: // 0x13
-        successful_parse_of_record_type = recordProcessor___0x13___processReadWordExpectNoPEC( (t_RECORD_PMBUS_READ_WORD_EXPECT_NOPEC *) record_to_process);
-        break;
-      case RECORD_TYPE_PMBUS_READ_BLOCK_EXPECT_NOPEC: // 0x14
-        successful_parse_of_record_type = FAILURE; // Unsupported Record Type
-        break;
-      case RECORD_TYPE_PMBUS_READ_BYTE_LOOP_MASK_NOPEC: // 0x15
-        successful_parse_of_record_type = recordProcessor___0x15___processReadByteLoopMaskNoPEC( (t_RECORD_PMBUS_READ_BYTE_LOOP_MASK_NOPEC *) record_to_process);
-        break;
-      case RECORD_TYPE_PMBUS_READ_WORD_LOOP_MASK_NOPEC: // 0x16
-        successful_parse_of_record_type = recordProcessor___0x16___processReadWordLoopMaskNoPEC( (t_RECORD_PMBUS_READ_WORD_LOOP_MASK_NOPEC *) record_to_process);
-        break;
-      case RECORD_TYPE_PMBUS_SEND_BYTE_NOPEC: // 0x17
-        successful_parse_of_record_type = recordProcessor___0x17___processSendByteNoPEC( (t_RECORD_PMBUS_SEND_BYTE_NOPEC *) record_to_process);
-        break;
-      case RECORD_TYPE_EVENT: // 0x18
-        successful_parse_of_record_type = recordProcessor___0x18___processEvent( (t_RECORD_EVENT *) record_to_process);
-        break;
-      case RECORD_TYPE_PMBUS_READ_BYTE_EXPECT_MASK_NOPEC: // 0x19
-        successful_parse_of_record_type = recordProcessor___0x19___processReadByteExpectMaskNoPEC( (t_RECORD_PMBUS_READ_BYTE_EXPECT_MASK_NOPEC *) record_to_process);
-        break;
-      case RECORD_TYPE_PMBUS_READ_WORD_EXPECT_MASK_NOPEC: //0x1A
-        successful_parse_of_record_type = recordProcessor___0x1A___processReadWordExpectMaskNoPEC( (t_RECORD_PMBUS_READ_WORD_EXPECT_MASK_NOPEC *) record_to_process);
-        break;
-      case RECORD_TYPE_VARIABLE_META_DATA: // 0x1B
-        successful_parse_of_record_type = recordProcessor___0x1B___processVariableMetaData( (t_RECORD_VARIABLE_META_DATA *) record_to_process);
-        break;
-      case RECORD_TYPE_MODIFY_WORD_NOPEC: // 0x1C
-        successful_parse_of_record_type = recordProcessor___0x1C___modifyWordNoPEC( (t_RECORD_PMBUS_MODIFY_WORD_NO_PEC *) record_to_process);
-        break;
-      case RECORD_TYPE_MODIFY_BYTE_NOPEC: // 0x1D
-        successful_parse_of_record_type = recordProcessor___0x1D___modifyByteNoPEC( (t_RECORD_PMBUS_MODIFY_BYTE_NO_PEC *) record_to_process);
-        break;
-      case RECORD_TYPE_PMBUS_WRITE_EE_DATA: // 0x1E
-        successful_parse_of_record_type = recordProcessor___0x1E___writeNvmData( (t_RECORD_NVM_DATA *) record_to_process);
-        break;
-      case RECORD_TYPE_PMBUS_READ_AND_VERIFY_EE_DATA: // 0x1F
-        successful_parse_of_record_type = recordProcessor___0x1F___read_then_verifyNvmData( (t_RECORD_NVM_DATA *) record_to_process);
-        break;
-      case RECORD_TYPE_PMBUS_MODIFY_BYTE: // 0x20
-        successful_parse_of_record_type = recordProcessor___0x20___modifyByteOptionalPEC( (t_RECORD_PMBUS_MODIFY_BYTE *) record_to_process);
-        break;
-      case RECORD_TYPE_PMBUS_MODIFY_WORD: // 0x21
-        successful_parse_of_record_type = recordProcessor___0x21___modifyWordOptionalPEC( (t_RECORD_PMBUS_MODIFY_WORD *) record_to_process);
-        break;
-      case RECORD_TYPE_END_OF_RECORDS: // 0x22
-//        printf("Free Rec: %d, 0x%x\n", record_to_process->Length, record_to_process->RecordType);
-
-        free(record_to_process);
-        return SUCCESS;
-        break;
-      default:
-        successful_parse_of_record_type = FAILURE; // Unknown Instruction, report a failure
-        break;
-    }
-
-    if (recordType_of_record_to_process == RECORD_TYPE_NVM_DATA)
-    {
-      // The record is freed after verify. Follow the calls down recordProcessor___0x1F___read_then_verifyNvmData.
-    }
-    else if (successful_parse_of_record_type == 0)
+    if (record_to_process->RecordType == RECORD_TYPE_END_OF_RECORDS)
     {
-//      printf("Free Rec: %d, 0x%x\n", record_to_process->Length, record_to_process->RecordType);
-      free(record_to_process);
-    }
-    else
-    {
-//      printf("Free Rec: %d, 0x%x\n", record_to_process->Length, record_to_process->RecordType);
-      free(record_to_process);
+      ispFree(record_to_process);
+      return SUCCESS;
     }
+    successful_parse_of_record_type = processRecord(record_to_process);
   }
 
   return successful_parse_of_record_type;
@@ -225,7 +247,7 @@ uint8_t processRecordsOnDemand(pRecordHeaderLengthAndType (*getRecord)(void))
  * Input:           Function to get records one by one, skips writes
  * Output:          Returns SUCCESS (1) or FAILURE (0) depending on the status of parsing ALL the record types
  * Overview:        Processes all the records until the function to get records returns null
- *          Records are freed as processed.
+ *          Records are freed as processed, or with the session arena.
  * Note:            None
  *******************************************************************/
 uint8_t verifyRecordsOnDemand(pRecordHeaderLengthAndType (*getRecord)(void))
@@ -233,20 +255,20 @@ uint8_t verifyRecordsOnDemand(pRecordHeaderLengthAndType (*getRecord)(void))
   pRecordHeaderLengthAndType record_to_process;
   uint16_t recordType_of_record_to_process;
   uint8_t successful_parse_of_record_type = SUCCESS;
-  verification_in_progress = true;
+  nvmSession->verification_in_progress = true;
 
   while ((record_to_process = getRecord()) != NULL && successful_parse_of_record_type == SUCCESS)
   {
     recordType_of_record_to_process = record_to_process->RecordType;
 
-    if (!ignore_records)
+    if (!nvmSession->ignore_records)
       switch (recordType_of_record_to_process)
       {
         case RECORD_TYPE_PMBUS_WRITE_BYTE: // 0x01
           if (((t_RECORD_PMBUS_WRITE_BYTE *) record_to_process)->detailedRecordHeader.CommandCode != 0xBE)
             successful_parse_of_record_type = recordProcessor___0x01___processWriteByteOptionalPEC( (t_RECORD_PMBUS_WRITE_BYTE *) record_to_process);
           else
-            smbusPec__->writeByte((uint8_t) ((t_RECORD_PMBUS_WRITE_BYTE *)record_to_process)->detailedRecordHeader.DeviceAddress, 0xBD, 0);
+            nvmSession->smbusPec->writeByte((uint8_t) ((t_RECORD_PMBUS_WRITE_BYTE *)record_to_process)->detailedRecordHeader.DeviceAddress, 0xBD, 0);
           break;
         case RECORD_TYPE_PMBUS_WRITE_WORD: // 0x02
           successful_parse_of_record_type = recordProcessor___0x02___processWriteWordOptionalPEC( (t_RECORD_PMBUS_WRITE_WORD *) record_to_process);
@@ -328,7 +350,7 @@ uint8_t verifyRecordsOnDemand(pRecordHeaderLengthAndType (*getRecord)(void))
           break;
         case RECORD_TYPE_PMBUS_WRITE_EE_DATA: // 0x1E
           //successful_parse_of_record_type = recordProcessor___0x1E___writeNvmData( (t_RECORD_NVM_DATA *) record_to_process);
-          smbusPec__->writeByte((uint8_t) ((t_RECORD_NVM_DATA *)record_to_process)->detailedRecordHeader.DeviceAddress, 0xBD, 0);
+          nvmSession->smbusPec->writeByte((uint8_t) ((t_RECORD_NVM_DATA *)record_to_process)->detailedRecordHeader.DeviceAddress, 0xBD, 0);
           break;
         case RECORD_TYPE_PMBUS_READ_AND_VERIFY_EE_DATA: // 0x1F
           successful_parse_of_record_type = recordProcessor___0x1F___read_then_verifyNvmData( (t_RECORD_NVM_DATA *) record_to_process);
@@ -351,8 +373,8 @@ uint8_t verifyRecordsOnDemand(pRecordHeaderLengthAndType (*getRecord)(void))
     else if (recordType_of_record_to_process == RECORD_TYPE_END_OF_RECORDS) // 0x22
     {
 //      printf("Free Rec: %d, 0x%x\n", record_to_process->Length, record_to_process->RecordType);
-      free(record_to_process);
-      verification_in_progress = false;
+      ispFree(record_to_process);
+      nvmSession->verification_in_progress = false;
       return SUCCESS;
     }
 
@@ -362,12 +384,12 @@ uint8_t verifyRecordsOnDemand(pRecordHeaderLengthAndType (*getRecord)(void))
     else if (successful_parse_of_record_type == 0)
     {
 //      printf("Free Rec: %d, 0x%x\n", record_to_process->Length, record_to_process->RecordType);
-      free(record_to_process);
+      ispFree(record_to_process);
     }
     else
     {
 //      printf("Free Rec: %d, 0x%x\n", record_to_process->Length, record_to_process->RecordType);
-      free(record_to_process);
+      ispFree(record_to_process);
     }
   }
   return successful_parse_of_record_type;
@@ -403,11 +425,11 @@ uint8_t recordProcessor___0x01___processWriteByteOptionalPEC(t_RECORD_PMBUS_WRIT
 
 
   if (pRecord->detailedRecordHeader.UsePec)
-    smbusPec__->writeByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+    nvmSession->smbusPec->writeByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                           pRecord->detailedRecordHeader.CommandCode,
                           pRecord->dataByte);
   else
-    smbusNoPec__->writeByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+    nvmSession->smbusNoPec->writeByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                             pRecord->detailedRecordHeader.CommandCode,
                             pRecord->dataByte);
 #endif
@@ -442,11 +464,11 @@ uint8_t recordProcessor___0x02___processWriteWordOptionalPEC(t_RECORD_PMBUS_WRIT
   printf("Word %x\n", pRecord->dataWord);
 #endif
   if (pRecord->detailedRecordHeader.UsePec)
-    smbusPec__->writeWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+    nvmSession->smbusPec->writeWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                           pRecord->detailedRecordHeader.CommandCode,
                           pRecord->dataWord);
   else
-    smbusNoPec__->writeWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+    nvmSession->smbusNoPec->writeWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                             pRecord->detailedRecordHeader.CommandCode,
                             pRecord->dataWord);
 #endif
@@ -476,10 +498,10 @@ uint8_t recordProcessor___0x04___processReadByteExpectOptionalPEC(t_RECORD_PMBUS
 #else
   uint8_t actualByteValue;
   if (pRecord->detailedRecordHeader.UsePec)
-    actualByteValue = smbusPec__->readByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+    actualByteValue = nvmSession->smbusPec->readByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                                            pRecord->detailedRecordHeader.CommandCode);
   else
-    actualByteValue = smbusNoPec__->readByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+    actualByteValue = nvmSession->smbusNoPec->readByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                       pRecord->detailedRecordHeader.CommandCode);
 
 #if DEBUG_PRINT
@@ -517,10 +539,10 @@ uint8_t recordProcessor___0x05___processReadWordExpectOptionalPEC(t_RECORD_PMBUS
 #else
   uint16_t actualWordValue;
   if (pRecord->detailedRecordHeader.UsePec)
-    actualWordValue = smbusPec__->readWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+    actualWordValue = nvmSession->smbusPec->readWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                                            pRecord->detailedRecordHeader.CommandCode);
   else
-    actualWordValue = smbusNoPec__->readWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+    actualWordValue = nvmSession->smbusNoPec->readWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                       pRecord->detailedRecordHeader.CommandCode);
 
 #if DEBUG_PRINT
@@ -596,10 +618,10 @@ uint8_t recordProcessor___0x0A___processReadByteLoopMaskOptionalPEC(t_RECORD_PMB
   do
   {
     if (pRecord->detailedRecordHeader.UsePec)
-      actualByteValue = smbusPec__->readByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+      actualByteValue = nvmSession->smbusPec->readByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                                              pRecord->detailedRecordHeader.CommandCode);
     else
-      actualByteValue = smbusNoPec__->readByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+      actualByteValue = nvmSession->smbusNoPec->readByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                         pRecord->detailedRecordHeader.CommandCode);
 
     actualByteValueWithMask = (actualByteValue & pRecord->byteMask);
@@ -649,10 +671,10 @@ uint8_t recordProcessor___0x0B___processReadWordLoopMaskOptionalPEC(t_RECORD_PMB
   do
   {
     if (pRecord->detailedRecordHeader.UsePec)
-      actualWordValue = smbusPec__->readWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+      actualWordValue = nvmSession->smbusPec->readWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                                              pRecord->detailedRecordHeader.CommandCode);
     else
-      actualWordValue = smbusNoPec__->readWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+      actualWordValue = nvmSession->smbusNoPec->readWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                         pRecord->detailedRecordHeader.CommandCode);
 
     actualWordValueWithMask = (actualWordValue & pRecord->wordMask);
@@ -697,7 +719,7 @@ uint8_t recordProcessor___0x0C___processPollReadByteUntilAckNoPEC(t_RECORD_PMBUS
   printf("Adr %x ", pRecord->detailedRecordHeader.DeviceAddress);
   printf("Code %x\n", pRecord->detailedRecordHeader.CommandCode);
 #endif
-  return smbusNoPec__->waitForAck((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+  return nvmSession->smbusNoPec->waitForAck((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                                   pRecord->detailedRecordHeader.CommandCode) == 0 ? 1 : 0;
 #endif
 #endif
@@ -775,10 +797,10 @@ uint8_t recordProcessor___0x0E___processSendByteOptionalPEC(t_RECORD_PMBUS_SEND_
   printf("Code %x\n", pRecord->detailedRecordHeader.CommandCode);
 #endif
   if (pRecord->detailedRecordHeader.UsePec)
-    smbusPec__->sendByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+    nvmSession->smbusPec->sendByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                          pRecord->detailedRecordHeader.CommandCode);
   else
-    smbusNoPec__->sendByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+    nvmSession->smbusNoPec->sendByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                            pRecord->detailedRecordHeader.CommandCode);
 #endif
 #endif
@@ -811,7 +833,7 @@ uint8_t recordProcessor___0x0F___processWriteByteNoPEC(t_RECORD_PMBUS_WRITE_BYTE
   printf("Code %x ", pRecord->detailedRecordHeader.CommandCode);
   printf("E%x\n", pRecord->dataByte);
 #endif
-  smbusNoPec__->writeByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+  nvmSession->smbusNoPec->writeByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                           pRecord->detailedRecordHeader.CommandCode,
                           pRecord->dataByte);
 #endif
@@ -845,7 +867,7 @@ uint8_t recordProcessor___0x10___processWriteWordNoPEC(t_RECORD_PMBUS_WRITE_WORD
   printf("Code %x ", pRecord->detailedRecordHeader.CommandCode);
   printf("Word %x\n", pRecord->dataWord);
 #endif
-  smbusNoPec__->writeWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+  nvmSession->smbusNoPec->writeWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                           pRecord->detailedRecordHeader.CommandCode,
                           pRecord->dataWord);
 #endif
@@ -874,7 +896,7 @@ uint8_t recordProcessor___0x12___processReadByteExpectNoPEC(t_RECORD_PMBUS_READ_
   return SUCCESS;
 #else
   uint8_t actualByteValue;
-  actualByteValue = smbusNoPec__->readByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+  actualByteValue = nvmSession->smbusNoPec->readByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                     pRecord->detailedRecordHeader.CommandCode);
 #if DEBUG_PRINT
   printf(F("ReadByteExpectNoPEC "));
@@ -909,7 +931,7 @@ uint8_t recordProcessor___0x13___processReadWordExpectNoPEC(t_RECORD_PMBUS_READ_
   return SUCCESS;
 #else
   uint16_t actualWordValue;
-  actualWordValue = smbusNoPec__->readWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+  actualWordValue = nvmSession->smbusNoPec->readWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                     pRecord->detailedRecordHeader.CommandCode);
 
 #if DEBUG_PRINT
@@ -950,7 +972,7 @@ uint8_t recordProcessor___0x15___processReadByteLoopMaskNoPEC(t_RECORD_PMBUS_REA
   uint8_t success = FAILURE;
   do
   {
-    actualByteValue = smbusNoPec__->readByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+    actualByteValue = nvmSession->smbusNoPec->readByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                       pRecord->detailedRecordHeader.CommandCode);
 
     actualByteValueWithMask = (actualByteValue & pRecord->byteMask);
@@ -997,7 +1019,7 @@ uint8_t recordProcessor___0x16___processReadWordLoopMaskNoPEC(t_RECORD_PMBUS_REA
   uint8_t success = FAILURE;
   do
   {
-    actualWordValue = smbusNoPec__->readWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+    actualWordValue = nvmSession->smbusNoPec->readWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                       pRecord->detailedRecordHeader.CommandCode);
 
 
@@ -1043,7 +1065,7 @@ uint8_t recordProcessor___0x17___processSendByteNoPEC(t_RECORD_PMBUS_SEND_BYTE_N
   printf("Adr %x ", pRecord->detailedRecordHeader.DeviceAddress);
   printf("Code %x\n", pRecord->detailedRecordHeader.CommandCode);
 #endif
-  smbusNoPec__->sendByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+  nvmSession->smbusNoPec->sendByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                          pRecord->detailedRecordHeader.CommandCode);
 #endif
 #endif
@@ -1064,8 +1086,8 @@ uint8_t recordProcessor___0x18___processEvent(t_RECORD_EVENT *pRecord)
   switch (pRecord->eventId)
   {
     case BEFORE_BEGIN:
-      if (verification_in_progress)
-        ignore_records = true;
+      if (nvmSession->verification_in_progress)
+        nvmSession->ignore_records = true;
       // This event is fired before any commands are issued to program the NVM
       // Potentially do something in your system that needs doing before anything has started
       // Turn on power to the DUT? Confirm user wants to program? Release Write Protect pins?
@@ -1074,15 +1096,15 @@ uint8_t recordProcessor___0x18___processEvent(t_RECORD_EVENT *pRecord)
 #endif
       return SUCCESS;
     case BEFORE_INSYSTEM_PROGRAMMING_BEGIN :
-      if (verification_in_progress)
-        ignore_records = true;
+      if (nvmSession->verification_in_progress)
+        nvmSession->ignore_records = true;
 #if (DEBUG_PRINT || DEBUG_PROCESSING)
       printf(F("META DATA EVENT: The system is about to begin in system programming\n"));
 #endif
       return SUCCESS;
     case SYSTEM_BEFORE_PROGRAM:
-      if (verification_in_progress)
-        ignore_records = true;
+      if (nvmSession->verification_in_progress)
+        nvmSession->ignore_records = true;
       // This event is fired before any commands are issued to program the NVM
       // Potentially do something in your system that needs doing before any programming has started
       // Confirm user wants to program?
@@ -1091,22 +1113,26 @@ uint8_t recordProcessor___0x18___processEvent(t_RECORD_EVENT *pRecord)
 #endif
       return SUCCESS;
     case INSYSTEM_CHIP_BEFORE_PROGRAM :
-      if (verification_in_progress)
-        ignore_records = true;
+      nvmSession->nvmInChip = true;
+      nvmSession->nvmSkippingChip = false;
+      if (nvmSession->verification_in_progress)
+        nvmSession->ignore_records = true;
 #if (DEBUG_PRINT || DEBUG_PROCESSING)
       printf(F("META DATA EVENT: The system is about to begin programming a chip\n"));
 #endif
       return SUCCESS;
     case INSYSTEM_CHIP_AFTER_PROGRAM :
-      if (verification_in_progress)
-        ignore_records = true;
+      nvmSession->nvmInChip = false;
+      nvmSession->nvmSkippingChip = false;
+      if (nvmSession->verification_in_progress)
+        nvmSession->ignore_records = true;
 #if (DEBUG_PRINT || DEBUG_PROCESSING)
       printf(F("META DATA EVENT: The system has finished programming a chip\n"));
 #endif
       return SUCCESS;
     case SYSTEM_BEFORE_VERIFY:
-      if (verification_in_progress)
-        ignore_records = true;
+      if (nvmSession->verification_in_progress)
+        nvmSession->ignore_records = true;
       // This event is fired after programming the system before any commands are issued to verify the NVM
       // Potentially do something in your system that needs doing before any programming has started
       // Tell the user the chip was programmed without error and now it needs verification?
@@ -1115,22 +1141,26 @@ uint8_t recordProcessor___0x18___processEvent(t_RECORD_EVENT *pRecord)
 #endif
       return SUCCESS;
     case INSYSTEM_CHIP_BEFORE_VERIFY :
-      if (verification_in_progress)
-        ignore_records = false;
+      nvmSession->nvmInChip = true;
+      nvmSession->nvmSkippingChip = false;
+      if (nvmSession->verification_in_progress)
+        nvmSession->ignore_records = false;
 #if (DEBUG_PRINT || DEBUG_PROCESSING)
       printf(F("META DATA EVENT: The system is about to verify a chip\n"));
 #endif
       return SUCCESS;
     case INSYSTEM_CHIP_AFTER_VERIFY:
-      if (verification_in_progress)
-        ignore_records = true;
+      nvmSession->nvmInChip = false;
+      nvmSession->nvmSkippingChip = false;
+      if (nvmSession->verification_in_progress)
+        nvmSession->ignore_records = true;
 #if (DEBUG_PRINT || DEBUG_PROCESSING)
       printf(F("META DATA EVENT: The system has finished verifying a chip\n"));
 #endif
       return SUCCESS;
     case SYSTEM_AFTER_VERIFY:
-      if (verification_in_progress)
-        ignore_records = true;
+      if (nvmSession->verification_in_progress)
+        nvmSession->ignore_records = true;
 #if (DEBUG_PRINT || DEBUG_PROCESSING)
       printf(F("META DATA EVENT: The system has finished verification\n"));
 #endif
@@ -1176,7 +1206,7 @@ uint8_t recordProcessor___0x19___processReadByteExpectMaskNoPEC(t_RECORD_PMBUS_R
   uint8_t actualByteValue;
   uint8_t actualByteValueWithMask;
   uint8_t expectedByteValueWithMask;
-  actualByteValue = smbusNoPec__->readByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+  actualByteValue = nvmSession->smbusNoPec->readByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                     pRecord->detailedRecordHeader.CommandCode);
   actualByteValueWithMask = (actualByteValue & pRecord->byteMask);
   expectedByteValueWithMask = (pRecord->expectedDataByte & pRecord->byteMask);
@@ -1217,7 +1247,7 @@ uint8_t recordProcessor___0x1A___processReadWordExpectMaskNoPEC(t_RECORD_PMBUS_R
   uint16_t actualWordValue;
   uint16_t actualWordValueWithMask;
   uint16_t expectedWordValueWithMask;
-  actualWordValue = smbusNoPec__->readWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+  actualWordValue = nvmSession->smbusNoPec->readWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                     pRecord->detailedRecordHeader.CommandCode);
 
   actualWordValueWithMask = (actualWordValue & pRecord->wordMask);
@@ -1267,16 +1297,16 @@ uint8_t recordProcessor___0x1B___processVariableMetaData(t_RECORD_VARIABLE_META_
       //printf("Setting the Global Base Address\n");
 
       // Ensure that the device is responding
-      smbusNoPec__->waitForAck(0x5B, 0x00);
+      nvmSession->smbusNoPec->waitForAck(0x5B, 0x00);
 
       // Un Write-Protect the device
       // This is a shorthand way of writing 0x00 [Write Protect Disabled] to register 0x10 [PMBus WRITE_PROTECT command register] of the device at address 0x5B with a PEC byte of 0xC0
       // This will work even if the device at 0x5B has PEC_REQUIRED enabled
-      smbusNoPec__->writeWord(0x5B, 0x10, 0xC000);
+      nvmSession->smbusNoPec->writeWord(0x5B, 0x10, 0xC000);
 
       // Write MFR_I2C_BASE_ADDRESS with supplied 16-bit word new global base address
       newGlobalBaseAddress = ((t_RECORD_META_SET_GLOBAL_BASE_ADDRESS *)pRecord)->globalBaseAddressInWordFormat;
-      smbusNoPec__->writeWord(0x5B, 0xE6, newGlobalBaseAddress);
+      nvmSession->smbusNoPec->writeWord(0x5B, 0xE6, newGlobalBaseAddress);
       //printf("Base set\n");
       return SUCCESS;
 
@@ -1349,11 +1379,11 @@ uint8_t recordProcessor___0x1C___modifyWordNoPEC(t_RECORD_PMBUS_MODIFY_WORD_NO_P
   printf("Code %x " , pRecord->detailedRecordHeader.CommandCode);
   printf("E %x\n", pRecord->desiredDataWord);
 #endif
-  actualWordValue = smbusNoPec__->readWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+  actualWordValue = nvmSession->smbusNoPec->readWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                     pRecord->detailedRecordHeader.CommandCode);
 
   modifiedWordValue = (actualWordValue & (~pRecord->wordMask));
-  smbusNoPec__->writeWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+  nvmSession->smbusNoPec->writeWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                           pRecord->detailedRecordHeader.CommandCode,
                           modifiedWordValue | (pRecord->desiredDataWord & pRecord->wordMask));
 #endif
@@ -1389,11 +1419,11 @@ uint8_t recordProcessor___0x1D___modifyByteNoPEC(t_RECORD_PMBUS_MODIFY_BYTE_NO_P
   printf("Code %x ", pRecord->detailedRecordHeader.CommandCode);
   printf("E %x\n", pRecord->desiredDataByte);
 #endif
-  actualByteValue = smbusNoPec__->readByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+  actualByteValue = nvmSession->smbusNoPec->readByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                     pRecord->detailedRecordHeader.CommandCode);
 
   modifiedByteValue = (actualByteValue & (~pRecord->byteMask));
-  smbusNoPec__->writeByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+  nvmSession->smbusNoPec->writeByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                           pRecord->detailedRecordHeader.CommandCode,
                           modifiedByteValue | (pRecord->desiredDataByte & pRecord->byteMask));
 #endif
@@ -1483,19 +1513,19 @@ uint8_t recordProcessor___0x20___modifyByteOptionalPEC(t_RECORD_PMBUS_MODIFY_BYT
   printf("E %x\n", pRecord->desiredDataByte);
 #endif
   if (pRecord->detailedRecordHeader.UsePec)
-    actualByteValue = smbusPec__->readByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+    actualByteValue = nvmSession->smbusPec->readByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                                            pRecord->detailedRecordHeader.CommandCode);
   else
-    actualByteValue = smbusNoPec__->readByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+    actualByteValue = nvmSession->smbusNoPec->readByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                       pRecord->detailedRecordHeader.CommandCode);
 
   modifiedByteValue = (actualByteValue & (~pRecord->byteMask));
   if (pRecord->detailedRecordHeader.UsePec)
-    smbusPec__->writeByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+    nvmSession->smbusPec->writeByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                           pRecord->detailedRecordHeader.CommandCode,
                           modifiedByteValue | (pRecord->desiredDataByte & pRecord->byteMask));
   else
-    smbusNoPec__->writeByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+    nvmSession->smbusNoPec->writeByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                             pRecord->detailedRecordHeader.CommandCode,
                             modifiedByteValue | (pRecord->desiredDataByte & modifiedByteValue));
 #endif
@@ -1532,19 +1562,19 @@ uint8_t recordProcessor___0x21___modifyWordOptionalPEC(t_RECORD_PMBUS_MODIFY_WOR
   printf("E %x\n", pRecord->desiredDataWord);
 #endif
   if (pRecord->detailedRecordHeader.UsePec)
-    actualWordValue = smbusPec__->readWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+    actualWordValue = nvmSession->smbusPec->readWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                                            pRecord->detailedRecordHeader.CommandCode);
   else
-    actualWordValue = smbusNoPec__->readWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+    actualWordValue = nvmSession->smbusNoPec->readWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                       pRecord->detailedRecordHeader.CommandCode);
 
   modifiedWordValue = (actualWordValue & (~pRecord->wordMask));
   if (pRecord->detailedRecordHeader.UsePec)
-    smbusPec__->writeWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+    nvmSession->smbusPec->writeWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                           pRecord->detailedRecordHeader.CommandCode,
                           modifiedWordValue | (pRecord->desiredDataWord & pRecord->wordMask));
   else
-    smbusNoPec__->writeWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+    nvmSession->smbusNoPec->writeWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
                             pRecord->detailedRecordHeader.CommandCode,
                             modifiedWordValue | (pRecord->desiredDataWord & pRecord->wordMask));
 #endif
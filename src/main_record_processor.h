@@ -39,9 +39,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "record_type_definitions.h"                  /* Record Type Definitions */
 #include "nvm_data_helpers.h"
 
-extern LT_SMBusNoPec *smbusNoPec__;
-extern LT_SMBusPec *smbusPec__;
-
+extern uint8_t processRecord(pRecordHeaderLengthAndType record_to_process);
 extern uint8_t processRecordsOnDemand(pRecordHeaderLengthAndType (*getRecord)(void));
 extern uint8_t verifyRecordsOnDemand(pRecordHeaderLengthAndType (*getRecord)(void));
 
@@ -26,116 +26,389 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "nvm_data_helpers.h"
+#include "LT_Exception.h"
+#include "LT_Clock.h"
+#include <string.h>
+#include <stdio.h>
+#include <unistd.h>
     
 //#define MACHINE_PTR uint32_t
 #define MACHINE_PTR uint64_t
 
 /********************************************************************
- * Function:        nvramNode_p nvramListNew(uint16_t dataIn, uint8_t pecIn, uint8_t addIn, uint8_t cmdIn);
+ * Function:        void nvramListInit(nvramList_t *nvramList);
  *
  * PreCondition:    None
- * Input:           uint16_t dataIn   = WORD of data from NVM block
- *          uint8_t pecIn   = Optionally use PEC or not, same as from t_RECORD_NVM_DATA->detailedRecordHeader->UsePec;
- *          uint8_t addIn   = Address of device this block belongs to, same as from t_RECORD_NVM_DATA->detailedRecordHeader->DeviceAddress
- *          uint8_t cmdIn   = Command for NVM block store of device, same as from t_RECORD_NVM_DATA->detailedRecordHeader->CommandCode
- * Output:          Returns a pointer to the newly created node on the stack/heap (depending on malloc implementation)
- * Overview:        Makes a new node for the Linked List
- * Note:            Note that depending on your implementation, you will need to closely
- *          monitor your stack or heap to ensure you have sufficient space to
- *          store all NVRAM data in this dynamically allocated linked list
- *          Use of malloc is required so that the node is not destroyed when the function returns
+ * Input:           nvramList_t* nvramList  = List to initialize
+ * Output:          None
+ * Overview:        Makes an empty list
+ * Note:            None
  *******************************************************************/
-nvramNode_p nvramListNew(uint16_t dataIn, uint8_t pecIn, uint8_t addIn, uint8_t cmdIn)
+void nvramListInit(nvramList_t *nvramList)
 {
-  nvramNode_p newNode = (nvramNode_p)malloc(sizeof(nvramNode_t));
-  newNode->data_store = dataIn;
-  newNode->nvram_usePEC = pecIn;
-  newNode->nvram_pmbusAddress = addIn;
-  newNode->nvram_pmbusCommand = cmdIn;
-  newNode->next = NULL;
-  return newNode;
+  nvramList->nodes = NULL;
+  nvramList->count = 0;
+  nvramList->capacity = 0;
 }
 
 /********************************************************************
- * Function:        void nvramListAdd(uint16_t dataIn, uint8_t pecIn, uint8_t addIn, uint8_t cmdIn, nvramNode_t* nvramList);
+ * Function:        uint8_t nvramListAdd(uint16_t dataIn, uint8_t pecIn, uint8_t addIn, uint8_t cmdIn, nvramList_t* nvramList);
  *
- * PreCondition:    Must have a typeof(nvramNode_t) list available to add to and store NVM data contents into
+ * PreCondition:    Must have a nvramList_t initialized with nvramListInit to add to and store NVM data contents into
  * Input:           uint16_t dataIn       = WORD of data from NVM block
  *          uint8_t pecIn       = Optionally use PEC or not, same as from t_RECORD_NVM_DATA->detailedRecordHeader->UsePec;
  *          uint8_t addIn       = Address of device this block belongs to, same as from t_RECORD_NVM_DATA->detailedRecordHeader->DeviceAddress
  *          uint8_t cmdIn       = Command for NVM block store of device, same as from t_RECORD_NVM_DATA->detailedRecordHeader->CommandCode
- *          nvramNode_t* nvramList  = Base address for the linked list to store to (Making this a parameter allows for multiple NVM lists in the future)
+ *          nvramList_t* nvramList  = List to store to (Making this a parameter allows for multiple NVM lists in the future)
+ * Output:          Returns 1 on success and 0 if out of memory
+ * Overview:        Appends a new data point to the end of the list
+ * Note:            The storage doubles when full, so appending is amortized O(1)
+ *******************************************************************/
+uint8_t nvramListAdd(uint16_t dataIn, uint8_t pecIn, uint8_t addIn, uint8_t cmdIn, nvramList_t *nvramList)
+{
+  nvramNode_p node;
+
+  if (nvramList->count == nvramList->capacity)
+  {
+    uint32_t capacity = nvramList->capacity ? nvramList->capacity * 2 : 64;
+    nvramNode_p nodes = (nvramNode_p) ispAlloc(capacity * sizeof(nvramNode_t));
+
+    if (nodes == NULL)
+      return 0;
+    if (nvramList->count > 0)
+      memcpy(nodes, nvramList->nodes, nvramList->count * sizeof(nvramNode_t));
+    ispFree(nvramList->nodes);
+    nvramList->nodes = nodes;
+    nvramList->capacity = capacity;
+  }
+
+  node = &nvramList->nodes[nvramList->count++];
+  node->data_store = dataIn;
+  node->nvram_usePEC = pecIn;
+  node->nvram_pmbusAddress = addIn;
+  node->nvram_pmbusCommand = cmdIn;
+  return 1;
+}
+
+/********************************************************************
+ * Function:        void nvramListFree(nvramList_t *nvramList);
+ *
+ * PreCondition:    None
+ * Input:           nvramList_t* nvramList  = List to free
  * Output:          None
- * Overview:        Adds a new data point to the master NVRAM buffer list
- * Note:            First it navigates to the end node of the linked list, then creates a new node, and links it
- *          Note that to save processing power, you could save the last linked list address and reference that directly instead of finding it dynamically each time
+ * Overview:        Frees the storage of the list and empties it
+ * Note:            Inside an ISP session the storage is released with the arena
  *******************************************************************/
-void nvramListAdd(uint16_t dataIn, uint8_t pecIn, uint8_t addIn, uint8_t cmdIn, nvramNode_t *nvramList)
+void nvramListFree(nvramList_t *nvramList)
 {
-  nvramNode_p newNode;
-  nvramNode_p node = nvramList;
+  ispFree(nvramList->nodes);
+  nvramListInit(nvramList);
+}
+
+thread_local tNvmSession *nvmSession = NULL;
 
-  while (node->next != NULL)
+/********************************************************************
+ * Function:        void nvmSessionInit(tNvmSession *session, LT_PMBus *pmbus, LT_SMBusNoPec *smbusNoPec, LT_SMBusPec *smbusPec);
+ *
+ * PreCondition:    None
+ * Input:           The session and the transports it uses
+ * Output:          None
+ * Overview:        Makes a session with nothing buffered
+ * Note:            Bind the session with nvmSession before processing records
+ *******************************************************************/
+void nvmSessionInit(tNvmSession *session, LT_PMBus *pmbus, LT_SMBusNoPec *smbusNoPec, LT_SMBusPec *smbusPec)
+{
+  session->pmbus = pmbus;
+  session->smbusNoPec = smbusNoPec;
+  session->smbusPec = smbusPec;
+  session->nvmScan = false;
+  session->nvmDifferential = false;
+  memset(session->nvmSeen, 0, sizeof(session->nvmSeen));
+  memset(session->nvmDirty, 0, sizeof(session->nvmDirty));
+  session->nvmMismatches = NULL;
+  session->nvmMismatchCapacity = 0;
+  nvmSessionReset(session);
+}
+
+/********************************************************************
+ * Function:        void nvmSessionFree(tNvmSession *session);
+ *
+ * PreCondition:    Session made with nvmSessionInit
+ * Input:           The session
+ * Output:          None
+ * Overview:        Frees what the session allocated
+ * Note:            The transports belong to the caller
+ *******************************************************************/
+void nvmSessionFree(tNvmSession *session)
+{
+  free(session->nvmMismatches);
+  session->nvmMismatches = NULL;
+  session->nvmMismatchCount = 0;
+  session->nvmMismatchCapacity = 0;
+}
+
+/********************************************************************
+ * Function:        uint8_t nvmMismatchAdd(tNvmSession *session, tNvmMismatch *mismatch);
+ *
+ * PreCondition:    Session made with nvmSessionInit
+ * Input:           The session and the block that did not verify
+ * Output:          Returns 1 if the block was added
+ * Overview:        Adds a block to the mismatch map of the session
+ * Note:            The map doubles as it fills
+ *******************************************************************/
+uint8_t nvmMismatchAdd(tNvmSession *session, tNvmMismatch *mismatch)
+{
+  tNvmMismatch *mismatches;
+  uint32_t capacity;
+
+  if (session->nvmMismatchCount == session->nvmMismatchCapacity)
   {
-    node = node->next;
+    capacity = session->nvmMismatchCapacity ? session->nvmMismatchCapacity * 2 : 16;
+    if ((mismatches = (tNvmMismatch *) realloc(session->nvmMismatches, capacity * sizeof(tNvmMismatch))) == NULL)
+      return 0;
+    session->nvmMismatches = mismatches;
+    session->nvmMismatchCapacity = capacity;
   }
+  session->nvmMismatches[session->nvmMismatchCount++] = *mismatch;
+  return 1;
+}
 
-  newNode = nvramListNew(dataIn, pecIn, addIn, cmdIn);
-  node->next = newNode;
+/********************************************************************
+ * Function:        void nvmSessionPrintMismatches(tNvmSession *session);
+ *
+ * PreCondition:    None
+ * Input:           The session
+ * Output:          None
+ * Overview:        Prints every block that did not verify
+ * Note:            None
+ *******************************************************************/
+void nvmSessionPrintMismatches(tNvmSession *session)
+{
+  tNvmMismatch *mismatch;
+  uint32_t i;
+
+  for (i = 0; i < session->nvmMismatchCount; i++)
+  {
+    mismatch = &session->nvmMismatches[i];
+    if (mismatch->kind == NVM_MISMATCH_CRC)
+      printf("NVM 0x%02x words %u-%u fail CRC\n", mismatch->address,
+             mismatch->firstWord, mismatch->firstWord + mismatch->nWords - 1);
+    else
+      printf("NVM 0x%02x words %u-%u differ in %u words\n", mismatch->address,
+             mismatch->firstWord, mismatch->firstWord + mismatch->nWords - 1, mismatch->differentWords);
+  }
+}
+
+/********************************************************************
+ * Function:        void nvmSessionReset(tNvmSession *session);
+ *
+ * PreCondition:    Session made with nvmSessionInit
+ * Input:           The session
+ * Output:          None
+ * Overview:        Forgets the state of the last run and its statistics
+ * Note:            Keeps the transports and the devices found by a scan
+ *******************************************************************/
+void nvmSessionReset(tNvmSession *session)
+{
+  session->image = NULL;
+  session->imageRecord = 0;
+  session->words = NULL;
+  session->nWords = 0;
+  session->record_pointer = NULL;
+  session->nvram_empty = 0;
+  session->nvram_somethingToVerify = 0;
+  session->verification_in_progress = false;
+  session->ignore_records = false;
+  session->nvmInChip = false;
+  session->nvmSkippingChip = false;
+  session->nvmMismatchCount = 0;
+  session->nvmCommitUs = 0;
+  session->nvmReadUs = 0;
+  session->nvmWordsWritten = 0;
+  session->nvmWordsRead = 0;
+  session->nvmBusyPolls = 0;
+  session->nvmWriteTimeUs = 0;
+  session->nvmReadTimeUs = 0;
+}
+
+/********************************************************************
+ * Function:        int16_t nvmRecordAddress(pRecordHeaderLengthAndType record);
+ *
+ * PreCondition:    None
+ * Input:           A record
+ * Output:          The 7 bit device address of the record, or -1 if it has none
+ * Overview:        Finds the device a record is sent to
+ * Note:            None
+ *******************************************************************/
+int16_t nvmRecordAddress(pRecordHeaderLengthAndType record)
+{
+  switch (record->RecordType)
+  {
+    case RECORD_TYPE_DEVICE_ADDRESS:
+    case RECORD_TYPE_PACKING_CODE:
+    case RECORD_TYPE_DELAY_MS:
+    case RECORD_TYPE_EVENT:
+    case RECORD_TYPE_VARIABLE_META_DATA:
+    case RECORD_TYPE_END_OF_RECORDS:
+      return -1;
+  }
+  return ((t_RECORD_PMBUS_SEND_BYTE *) record)->detailedRecordHeader.DeviceAddress & 0x7F;
 }
 
-static uint8_t nvram_empty = 0; // Simple flag to make sure you are not writing something you have not buffered
-static uint8_t nvram_somethingToVerify = 0; // Simple flag to make sure you are not verifying something you have not buffered or written
+/********************************************************************
+ * Function:        uint8_t nvmSkipRecord(pRecordHeaderLengthAndType record);
+ *
+ * PreCondition:    A scan has filled nvmSeen and nvmDirty
+ * Input:           The next record to process
+ * Output:          Returns 1 if the record can be skipped
+ * Overview:        In differential programming, skips the chip sections of devices whose NVM already matches the image
+ * Note:            Records without an address, like delays, follow the last addressed record of the section
+ *******************************************************************/
+uint8_t nvmSkipRecord(pRecordHeaderLengthAndType record)
+{
+  int16_t address;
+
+  if (!nvmSession->nvmDifferential || !nvmSession->nvmInChip)
+    return 0;
+
+  if (record->RecordType == RECORD_TYPE_DELAY_MS)
+    return nvmSession->nvmSkippingChip;
+  if ((address = nvmRecordAddress(record)) < 0)
+    return 0;
 
-static uint16_t *words;
-static uint16_t nWords;
-static t_RECORD_NVM_DATA *record_pointer;
-static uint8_t busy;
+  nvmSession->nvmSkippingChip = (nvmSession->nvmSeen[address >> 3] & (1 << (address & 7)))
+                                && !(nvmSession->nvmDirty[address >> 3] & (1 << (address & 7)));
+  return nvmSession->nvmSkippingChip;
+}
+
+/********************************************************************
+ * Function:        void nvmSessionPrintThroughput(tNvmSession *session);
+ *
+ * PreCondition:    None
+ * Input:           The session
+ * Output:          None
+ * Overview:        Prints the NVM words per second written and read, and the busy polls per word
+ * Note:            None
+ *******************************************************************/
+void nvmSessionPrintThroughput(tNvmSession *session)
+{
+  uint32_t words = session->nvmWordsWritten + session->nvmWordsRead;
+
+  if (session->nvmWordsWritten > 0 && session->nvmWriteTimeUs > 0)
+    printf("NVM write %u words, %.0f words/s, commit %uus\n", session->nvmWordsWritten,
+           session->nvmWordsWritten * 1e6 / session->nvmWriteTimeUs, session->nvmCommitUs);
+  if (session->nvmWordsRead > 0 && session->nvmReadTimeUs > 0)
+    printf("NVM read %u words, %.0f words/s\n", session->nvmWordsRead,
+           session->nvmWordsRead * 1e6 / session->nvmReadTimeUs);
+  if (words > 0)
+    printf("NVM busy polls %.2f per word\n", (float) session->nvmBusyPolls / words);
+}
+
+static uint8_t nvmBusy(t_RECORD_NVM_DATA *pRecord)
+{
+  uint8_t common;
+
+  nvmSession->nvmBusyPolls++;
+  if (pRecord->detailedRecordHeader.UsePec)
+    common = nvmSession->smbusPec->readByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress, 0xef);
+  else
+    common = nvmSession->smbusNoPec->readByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress, 0xef);
+
+  return (common & 0x40) == 0;
+}
 
-// This function replaced the older one above. It reads through the whole linked list
-// and writes the nodes word by word. It also sets the 'nvramListTopVerify' pointer to
-// the root node of the linked list it just wrote. This allows the verify function
-// to know what to verify.
+/********************************************************************
+ * Function:        uint8_t nvmReady(t_RECORD_NVM_DATA *pRecord);
+ *
+ * PreCondition:    None
+ * Input:           A record addressed to the part
+ * Output:          Returns 1 if the part is ready for the next NVM access
+ * Overview:        Polls the busy bit of the part once
+ * Note:            None
+ *******************************************************************/
+uint8_t nvmReady(t_RECORD_NVM_DATA *pRecord)
+{
+  return nvmBusy(pRecord) ? 0 : 1;
+}
+
+/********************************************************************
+ * Function:        void nvmLearnReady(uint32_t *expectedUs, uint64_t elapsedUs, bool first);
+ *
+ * PreCondition:    None
+ * Input:           The expected time, the time the part took, and if the first poll found it ready
+ * Output:          None
+ * Overview:        The expected time shrinks while the first poll finds the part ready, and follows the measured time when not
+ * Note:            None
+ *******************************************************************/
+void nvmLearnReady(uint32_t *expectedUs, uint64_t elapsedUs, bool first)
+{
+  if (first)
+    *expectedUs -= *expectedUs / 8;
+  else
+    *expectedUs = (*expectedUs + (uint32_t) elapsedUs) / 2;
+}
+
+/*
+ * Wait until the part is ready for the next NVM access. The first poll is
+ * made only after the expected time since the last access, so a part that
+ * keeps up costs one poll per word.
+ */
+static void nvmWaitReady(t_RECORD_NVM_DATA *pRecord, uint64_t start, uint32_t *expectedUs)
+{
+  uint64_t elapsed = LT_Clock::nowUs() - start;
+  bool first = true;
+
+  if (elapsed < *expectedUs)
+    usleep(*expectedUs - elapsed);
+
+  while (nvmBusy(pRecord))
+    first = false;
+
+  nvmLearnReady(expectedUs, LT_Clock::nowUs() - start, first);
+}
+
+/********************************************************************
+ * Function:        void writeNvmWord(t_RECORD_NVM_DATA *pRecord, uint16_t i);
+ *
+ * PreCondition:    NVM data buffered with bufferNvmData
+ * Input:           The write record and the index of the buffered word
+ * Output:          None
+ * Overview:        Writes one buffered NVM word without waiting for the part
+ * Note:            None
+ *******************************************************************/
+void writeNvmWord(t_RECORD_NVM_DATA *pRecord, uint16_t i)
+{
+  if (pRecord->detailedRecordHeader.UsePec)
+    nvmSession->smbusPec->writeWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+                          pRecord->detailedRecordHeader.CommandCode,
+                          nvmSession->words[i]);
+  else
+    nvmSession->smbusNoPec->writeWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
+                            pRecord->detailedRecordHeader.CommandCode,
+                            nvmSession->words[i]);
+  nvmSession->nvmWordsWritten++;
+}
+
+// Writes the buffered NVM words. MFR_EE_DATA takes one word per transaction,
+// so words cannot be batched; instead busy is only polled after the learned
+// commit time of the part, and the write rate is kept in the session.
 uint8_t writeNvmData(t_RECORD_NVM_DATA *pRecord)
 {
-  //nvramNode_p node = nvramListTop;
   uint8_t allGood = 1;
-  nvram_empty = 0;
+  uint64_t blockStart;
+  uint64_t start;
+  nvmSession->nvram_empty = 0;
 
-  //nvramListTopVerify = nvramListTop;
-  nvram_somethingToVerify = 1;
+  nvmSession->nvram_somethingToVerify = 1;
 
-  //while (node->next != NULL)
-  for (uint16_t i = 0; i < nWords; i++)
+  blockStart = LT_Clock::nowUs();
+  for (uint16_t i = 0; i < nvmSession->nWords; i++)
   {
-    //node = node->next;
-
-    if (allGood)
-    {
-      if (pRecord->detailedRecordHeader.UsePec)
-        smbusPec__->writeWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
-                              pRecord->detailedRecordHeader.CommandCode,
-                              words[i]);
-      else
-        smbusNoPec__->writeWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress,
-                                pRecord->detailedRecordHeader.CommandCode,
-                                words[i]);
-    }
-
-    if (allGood)
-    {
-      do
-      {
-        if (pRecord->detailedRecordHeader.UsePec)
-          busy = smbusPec__->readByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress, 0xef);
-        else
-          busy = smbusNoPec__->readByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress, 0xef);
-
-        busy = (busy & 0x40)==0;
-      }
-      while (busy);
-    }
+    start = LT_Clock::nowUs();
+    writeNvmWord(pRecord, i);
+    nvmWaitReady(pRecord, start, &nvmSession->nvmCommitUs);
   }
+  nvmSession->nvmWriteTimeUs += LT_Clock::nowUs() - blockStart;
 
   return allGood ? 1 : 0;
 }
@@ -144,82 +417,181 @@ uint8_t writeNvmData(t_RECORD_NVM_DATA *pRecord)
 // into a linked list to be used later.
 uint8_t bufferNvmData(t_RECORD_NVM_DATA *pRecord)
 {
-  nvram_somethingToVerify = 1;
+  nvmSession->nvram_somethingToVerify = 1;
 
   uint16_t i;
 //  printf("Save Rec Ptr\n");
-  record_pointer = pRecord;
-  nWords = (uint16_t)(pRecord->baseRecordHeader.Length-8)/2;
-  words = (uint16_t *) ((MACHINE_PTR)pRecord+8); // Change (UINT32) to the size of an address on the target machine.
+  nvmSession->record_pointer = pRecord;
+  nvmSession->nWords = (uint16_t)(pRecord->baseRecordHeader.Length-8)/2;
+  nvmSession->words = (uint16_t *) ((MACHINE_PTR)pRecord+8); // Change (UINT32) to the size of an address on the target machine.
 
   return 1;
 }
 
-uint8_t allGood = 1;
-uint16_t actual_value;
-uint16_t expected_value;
 
 // Used to release the record when only printing so that memory checkers don't see leaks.
 void releaseRecord()
 {
 //  printf("Free Rec Ptr\n");
-  free(record_pointer);
+  ispFree(nvmSession->record_pointer);
 }
 
-// This function reads the NVRAM back from the device and compares it against
-// what was buffered. If any word does not match, it returns a fail flag.
-uint8_t readThenVerifyNvmData(t_RECORD_NVM_DATA *pRecord)
+static uint16_t nvmReadWord(t_RECORD_NVM_DATA *pRecord)
+{
+  nvmSession->nvmWordsRead++;
+  if (pRecord->detailedRecordHeader.UsePec)
+    return nvmSession->smbusPec->readWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress, pRecord->detailedRecordHeader.CommandCode);
+  else
+    return nvmSession->smbusNoPec->readWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress, pRecord->detailedRecordHeader.CommandCode);
+}
+
+/*
+ * Read the next word of the EEPROM stream. Words are read back to back at
+ * the learned read time without polling. A part that could not keep up
+ * refuses the read, so it is polled until ready and the read is made again.
+ */
+static uint16_t nvmStreamWord(t_RECORD_NVM_DATA *pRecord, uint64_t *start)
 {
+  uint64_t elapsed = LT_Clock::nowUs() - *start;
+  uint16_t value;
 
-  if (nvram_somethingToVerify == 0)
+  if (elapsed < nvmSession->nvmReadUs)
+    usleep(nvmSession->nvmReadUs - elapsed);
+  try
   {
-    printf("Nothing to verify\n");
-    return 1;
+    value = nvmReadWord(pRecord);
   }
+  catch (LT_Exception &ex)
+  {
+    nvmWaitReady(pRecord, *start, &nvmSession->nvmReadUs);
+    value = nvmReadWord(pRecord);
+  }
+  *start = LT_Clock::nowUs();
+  return value;
+}
 
-  nvram_somethingToVerify = 0;
-
-  allGood = 0;
+/*
+ * Read one block of the EEPROM. Busy is polled at the start of every block.
+ * With polled set, busy is also polled before every word, which is how the
+ * read time is learned.
+ */
+static void nvmReadBlock(t_RECORD_NVM_DATA *pRecord, uint16_t *actual, uint16_t nWords, bool polled, uint64_t *start)
+{
+  uint16_t i;
 
-  for (uint16_t i = 0; i < nWords; i++)
+  nvmWaitReady(pRecord, *start, &nvmSession->nvmReadUs);
+  *start = LT_Clock::nowUs();
+  for (i = 0; i < nWords; i++)
   {
-    expected_value = words[i];
-    actual_value = 0;
-
-    do
+    if (polled)
     {
-      if (pRecord->detailedRecordHeader.UsePec)
-        busy = smbusPec__->readByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress, 0xef);
-      else
-        busy = smbusNoPec__->readByte((uint8_t) pRecord->detailedRecordHeader.DeviceAddress, 0xef);
+      if (i > 0)
+        nvmWaitReady(pRecord, *start, &nvmSession->nvmReadUs);
+      actual[i] = nvmReadWord(pRecord);
+      *start = LT_Clock::nowUs();
+    }
+    else
+      actual[i] = nvmStreamWord(pRecord, start);
+  }
+}
+
+/*
+ * Compare a block read back with the buffered words. A full block is checked
+ * with checkCRC first: a bad CRC on a block written with a good one is
+ * garbled whatever the words say. Otherwise the words are compared. Returns
+ * 1 and fills in the mismatch when the block differs.
+ */
+static uint8_t nvmCompareBlock(t_RECORD_NVM_DATA *pRecord, uint16_t firstWord, uint16_t *actual, uint16_t nWords, tNvmMismatch *mismatch)
+{
+  uint16_t *expected = nvmSession->words + firstWord;
+  uint8_t actualBytes[2 * NVM_BLOCK_WORDS];
+  uint8_t expectedBytes[2 * NVM_BLOCK_WORDS];
+  uint16_t i;
 
-      busy = (busy & 0x40)==0;
+  mismatch->address = pRecord->detailedRecordHeader.DeviceAddress & 0x7F;
+  mismatch->firstWord = firstWord;
+  mismatch->nWords = nWords;
+  mismatch->differentWords = 0;
+  mismatch->kind = 0;
+
+  if (nWords == NVM_BLOCK_WORDS)
+  {
+    for (i = 0; i < nWords; i++)
+    {
+      actualBytes[2 * i] = actual[i] & 0xFF;
+      actualBytes[2 * i + 1] = actual[i] >> 8;
+      expectedBytes[2 * i] = expected[i] & 0xFF;
+      expectedBytes[2 * i + 1] = expected[i] >> 8;
     }
-    while (busy);
+    if (!nvmSession->smbusNoPec->checkCRC(expectedBytes) && nvmSession->smbusNoPec->checkCRC(actualBytes))
+      mismatch->kind = NVM_MISMATCH_CRC;
+  }
 
-    if (pRecord->detailedRecordHeader.UsePec)
-      actual_value = smbusPec__->readWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress, pRecord->detailedRecordHeader.CommandCode);
-    else
-      actual_value = smbusNoPec__->readWord((uint8_t) pRecord->detailedRecordHeader.DeviceAddress, pRecord->detailedRecordHeader.CommandCode);
+  for (i = 0; i < nWords; i++)
+    if (actual[i] != expected[i])
+      mismatch->differentWords++;
+  if (mismatch->kind == 0 && mismatch->differentWords > 0)
+    mismatch->kind = NVM_MISMATCH_DATA;
 
-    if (actual_value != expected_value)
+  return mismatch->kind != 0;
+}
+
+// This function reads the NVRAM back from the device a block at a time and
+// compares it against what was buffered. Every block is read, so the session
+// gets a map of all blocks that differ. The first block is read with a busy
+// poll per word to learn the read time, the rest are streamed at that time.
+// MFR_EE_DATA is a stream that cannot be rewound, so a block that differs is
+// recorded as read. The blocks after it are read with a poll per word, so a
+// stream that ran ahead of the part does not spoil the rest of the map. If
+// any block differs, it returns a fail flag.
+uint8_t readThenVerifyNvmData(t_RECORD_NVM_DATA *pRecord)
+{
+  uint16_t actual[NVM_BLOCK_WORDS];
+  tNvmMismatch mismatch;
+  uint8_t allGood;
+  uint64_t blockStart;
+  uint64_t start;
+  uint16_t first;
+  uint16_t n;
+  bool polled;
+
+  if (nvmSession->nvram_somethingToVerify == 0)
+  {
+    printf("Nothing to verify\n");
+    return 1;
+  }
+
+  nvmSession->nvram_somethingToVerify = 0;
+
+  allGood = 0;
+
+  blockStart = LT_Clock::nowUs();
+  start = blockStart;
+  polled = false;
+  for (first = 0; first < nvmSession->nWords; first += n)
+  {
+    n = nvmSession->nWords - first < NVM_BLOCK_WORDS ? nvmSession->nWords - first : NVM_BLOCK_WORDS;
+    nvmReadBlock(pRecord, actual, n, first == 0 || polled, &start);
+    if (nvmCompareBlock(pRecord, first, actual, n, &mismatch))
     {
-      /*
-            Serial.print(F("Failed verify: Address "));
-            Serial.print(pRecord->detailedRecordHeader.DeviceAddress, HEX);
-            Serial.print(" Index ");
-            Serial.print(i);
-            Serial.print(F(" Expected "));
-            Serial.print(expected_value, HEX);
-            Serial.print(F(" Actual "));
-            Serial.println(actual_value, HEX);
-      */
+      nvmMismatchAdd(nvmSession, &mismatch);
       allGood = 1;
-      break;
+      polled = true;
     }
   }
+  nvmSession->nvmReadTimeUs += LT_Clock::nowUs() - blockStart;
+
+  if (nvmSession->nvmScan)
+  {
+    // Note the device and carry on, so one scan covers every device.
+    uint8_t address = pRecord->detailedRecordHeader.DeviceAddress & 0x7F;
+    nvmSession->nvmSeen[address >> 3] |= 1 << (address & 7);
+    if (allGood)
+      nvmSession->nvmDirty[address >> 3] |= 1 << (address & 7);
+    allGood = 0;
+  }
 //  printf("Free Rec Ptr\n");
-  free(record_pointer);
+  ispFree(nvmSession->record_pointer);
 
   return allGood;
 }
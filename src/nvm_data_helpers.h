@@ -38,14 +38,88 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "LT_SMBusNoPec.h"
 #include "LT_SMBusPec.h"
 #include "record_type_definitions.h"    /* Record Type Definitions */
+#include "LT_IspArena.h"
 
 
-extern LT_SMBusNoPec *smbusNoPec__;
-extern LT_SMBusPec *smbusPec__;
+class LT_HexImage;
 
-extern nvramNode_p nvramListNew(uint16_t dataIn, uint8_t pecIn, uint8_t addIn, uint8_t cmdIn);
-extern void nvramListAdd(uint16_t dataIn, uint8_t pecIn, uint8_t addIn, uint8_t cmdIn, nvramNode_t *nvramList);
+/********************************************************************
+ * Struct:          tNvmMismatch
+ *
+ * Overview:        A block of NVM that did not verify
+ * Note:            Blocks are 16 words, 31 bytes and a CRC, counted from
+ *          the first word of the NVM data record.
+ *******************************************************************/
+#define NVM_BLOCK_WORDS 16
+#define NVM_MISMATCH_DATA 1           // The block reads back with a good CRC but other data
+#define NVM_MISMATCH_CRC 2            // The block reads back with a bad CRC
+typedef struct
+{
+  uint8_t address;
+  uint8_t kind;
+  uint16_t firstWord;
+  uint16_t nWords;
+  uint16_t differentWords;
+} tNvmMismatch;
+
+/********************************************************************
+ * Struct:          tNvmSession
+ *
+ * Overview:        All the state of one NVM programming or verify session
+ * Note:            The record processors work on the session bound to the
+ *          calling thread with nvmSession, so sessions on different threads
+ *          and buses do not share anything.
+ *******************************************************************/
+typedef struct
+{
+  LT_PMBus *pmbus;
+  LT_SMBusNoPec *smbusNoPec;
+  LT_SMBusPec *smbusPec;
+  LT_HexImage *image;                 // Image the records come from
+  uint32_t imageRecord;               // Next record of the image
+  uint16_t *words;                    // NVM words of the buffered NVM record
+  uint16_t nWords;
+  t_RECORD_NVM_DATA *record_pointer;  // Buffered NVM record
+  uint8_t nvram_empty;                // Simple flag to make sure you are not writing something you have not buffered
+  uint8_t nvram_somethingToVerify;    // Simple flag to make sure you are not verifying something you have not buffered or written
+  bool verification_in_progress;
+  bool ignore_records;
+  uint32_t nvmCommitUs;               // Learned time for the part to commit one NVM word
+  uint32_t nvmReadUs;                 // Learned time for the part to be ready for the next NVM read
+  uint32_t nvmWordsWritten;
+  uint32_t nvmWordsRead;
+  uint32_t nvmBusyPolls;
+  uint64_t nvmWriteTimeUs;
+  uint64_t nvmReadTimeUs;
+  bool nvmScan;                       // Record NVM mismatches per device instead of failing
+  bool nvmDifferential;               // Skip chip sections of devices whose NVM already matches
+  bool nvmInChip;                     // Between the before and after events of a chip
+  bool nvmSkippingChip;               // The current chip section is being skipped
+  uint8_t nvmSeen[16];                // Devices with NVM data in the image, by 7 bit address
+  uint8_t nvmDirty[16];               // Devices whose NVM does not match the image
+  tNvmMismatch *nvmMismatches;        // Blocks that did not verify since the last reset
+  uint32_t nvmMismatchCount;
+  uint32_t nvmMismatchCapacity;
+} tNvmSession;
+
+extern thread_local tNvmSession *nvmSession;
+
+extern void nvmSessionInit(tNvmSession *session, LT_PMBus *pmbus, LT_SMBusNoPec *smbusNoPec, LT_SMBusPec *smbusPec);
+extern void nvmSessionPrintThroughput(tNvmSession *session);
+extern void nvmSessionReset(tNvmSession *session);
+extern void nvmSessionFree(tNvmSession *session);
+extern uint8_t nvmMismatchAdd(tNvmSession *session, tNvmMismatch *mismatch);
+extern void nvmSessionPrintMismatches(tNvmSession *session);
+extern int16_t nvmRecordAddress(pRecordHeaderLengthAndType record);
+extern uint8_t nvmSkipRecord(pRecordHeaderLengthAndType record);
+
+extern void nvramListInit(nvramList_t *nvramList);
+extern uint8_t nvramListAdd(uint16_t dataIn, uint8_t pecIn, uint8_t addIn, uint8_t cmdIn, nvramList_t *nvramList);
+extern void nvramListFree(nvramList_t *nvramList);
 extern uint8_t writeNvmData(t_RECORD_NVM_DATA *pRecord);
+extern void writeNvmWord(t_RECORD_NVM_DATA *pRecord, uint16_t i);
+extern uint8_t nvmReady(t_RECORD_NVM_DATA *pRecord);
+extern void nvmLearnReady(uint32_t *expectedUs, uint64_t elapsedUs, bool first);
 extern uint8_t bufferNvmData(t_RECORD_NVM_DATA *pRecord);
 extern void releaseRecord();
 extern uint8_t readThenVerifyNvmData(t_RECORD_NVM_DATA *pRecord);
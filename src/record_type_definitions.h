@@ -227,8 +227,8 @@ typedef struct
 /********************************************************************
  * Struct:          _NVRAM_ListItem, nvramNode_t, *nvramNode_p
  *
- * Overview:        A struct used to build a linked list that contains NVM data
- * Note:            The actual contents of the NVM write from a RECORD_TYPE_NVM_DATA are stored in a linked list built using this struct
+ * Overview:        A struct for one word of NVM data
+ * Note:            The actual contents of the NVM write from a RECORD_TYPE_NVM_DATA are stored in a contiguous nvramList_t of this struct
  *******************************************************************/
 typedef struct _NVRAM_ListItem
 {
@@ -236,9 +236,21 @@ typedef struct _NVRAM_ListItem
   uint8_t  nvram_usePEC;
   uint8_t  nvram_pmbusAddress;
   uint8_t  nvram_pmbusCommand;
-  struct _NVRAM_ListItem *next;
 } nvramNode_t, *nvramNode_p;
 
+/********************************************************************
+ * Struct:          nvramList_t
+ *
+ * Overview:        A growable vector of nvramNode_t
+ * Note:            Appending is amortized O(1). Storage comes from the ISP session arena when there is one.
+ *******************************************************************/
+typedef struct
+{
+  nvramNode_t *nodes;
+  uint32_t count;
+  uint32_t capacity;
+} nvramList_t;
+
 
 
 